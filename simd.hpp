@@ -5,3 +5,20 @@
 #pragma once
 
 #include "simd_vector.hpp"
+#include "simd_codec.hpp"
+#include "simd_complex.hpp"
+#include "simd_filter.hpp"
+#include "simd_fixed.hpp"
+#include "simd_geometry.hpp"
+#include "simd_hash.hpp"
+#include "simd_histogram.hpp"
+#include "simd_mapped.hpp"
+#include "simd_matrix.hpp"
+#include "simd_pipeline.hpp"
+#include "simd_polynomial.hpp"
+#include "simd_random.hpp"
+#include "simd_search.hpp"
+#include "simd_soa.hpp"
+#include "simd_sparse.hpp"
+#include "simd_sort.hpp"
+#include "simd_storage.hpp"
@@ -0,0 +1,550 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Byte stream codecs: hex and base64 encoding and decoding, and UTF-8 validation. The register kernels classify and
+ *  translate 16 bytes per 128bit lane with pshufb lookups on the high and low nibbles, and are written once for
+ *  __m128i (SSE4.1) and __m256i (AVX2). Whatever is left after the last whole register, and builds without SSE4.1,
+ *  go through the scalar code, which accepts and produces exactly the same bytes.
+ *
+ *  Base64 is the RFC 4648 alphabet with '=' padding and no line breaks. The decoders return the number of bytes
+ *  written, or decode_error when the input is malformed, in which case the output is unspecified.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    constexpr std::size_t decode_error = static_cast<std::size_t>(-1);
+
+    constexpr std::size_t base64_encoded_size(std::size_t const n) { return ((n + 2) / 3) * 4; }
+
+    // the most bytes n characters can decode to, padding makes the result up to two smaller
+    constexpr std::size_t base64_decoded_size(std::size_t const n) { return (n / 4) * 3; }
+
+    constexpr char hex_digits[2][17] = {"0123456789abcdef", "0123456789ABCDEF"};
+    constexpr char base64_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // the value of each character, 0xFF for those outside the alphabet
+    constexpr std::array<std::uint8_t, 256> base64_values = [] {
+        std::array<std::uint8_t, 256> t{};
+        t.fill(0xFF);
+        for (std::uint8_t i = 0; i < 64; ++i) {
+            t[static_cast<std::uint8_t>(base64_digits[i])] = i;
+        }
+        return t;
+    }();
+
+//-----------------------------------------------------------------------------
+//  register helpers
+//-----------------------------------------------------------------------------
+#if defined(__AVX2__) || defined(__SSE4_1__)
+    template<typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V high_nibbles(V const a) { return _mm_and_si128(_mm_srli_epi16(a, 4), _mm_set1_epi8(0x0F)); } // SSE2
+
+    template<typename V>
+    V low_nibbles(V const a) { return bitwise_and<V>(a, set<std::uint8_t, V>(0x0F)); }
+
+    // a0 b0 a1 b1 ... across two registers, in memory order
+    inline std::array<__m128i, 2> interleave_bytes(__m128i const a, __m128i const b)
+    {
+        return {_mm_unpacklo_epi8(a, b), _mm_unpackhi_epi8(a, b)}; // SSE2
+    }
+
+    // the 16bit lanes of a then b, saturated to bytes, in memory order
+    inline __m128i pack_words(__m128i const a, __m128i const b) { return _mm_packus_epi16(a, b); } // SSE2
+
+    // a[2i] b[2i] + a[2i + 1] b[2i + 1] on bytes to 16 bits, a unsigned and b signed, then on 16 bits to 32
+    inline __m128i madd_bytes(__m128i const a, __m128i const b) { return _mm_maddubs_epi16(a, b); } // SSSE3
+    inline __m128i madd_words(__m128i const a, __m128i const b) { return _mm_madd_epi16(a, b); } // SSE2
+
+    inline __m128i mulhi_words(__m128i const a, __m128i const b) { return _mm_mulhi_epu16(a, b); } // SSE2
+    inline __m128i mullo_words(__m128i const a, __m128i const b) { return _mm_mullo_epi16(a, b); } // SSE2
+
+    // 12 input bytes per 128bit lane for base64 encoding, 16 bytes must be readable
+    template<typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V load_triplets(std::uint8_t const* p) { return load<V>(p); }
+
+    // moves the 12 bytes in each lane together at the start of the register
+    inline __m128i compact_lanes(__m128i const a) { return a; }
+
+#ifdef __AVX2__
+    template<typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V high_nibbles(V const a) { return _mm256_and_si256(_mm256_srli_epi16(a, 4), _mm256_set1_epi8(0x0F)); } // AVX2
+
+    // unpack works within 128bit lanes, so the halves are put back in order
+    inline std::array<__m256i, 2> interleave_bytes(__m256i const a, __m256i const b)
+    {
+        __m256i const lo = _mm256_unpacklo_epi8(a, b); // AVX2
+        __m256i const hi = _mm256_unpackhi_epi8(a, b); // AVX2
+        return {_mm256_permute2x128_si256(lo, hi, 0x20), _mm256_permute2x128_si256(lo, hi, 0x31)}; // AVX2
+    }
+
+    inline __m256i pack_words(__m256i const a, __m256i const b) { return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8); } // AVX2
+
+    inline __m256i madd_bytes(__m256i const a, __m256i const b) { return _mm256_maddubs_epi16(a, b); } // AVX2
+    inline __m256i madd_words(__m256i const a, __m256i const b) { return _mm256_madd_epi16(a, b); } // AVX2
+
+    inline __m256i mulhi_words(__m256i const a, __m256i const b) { return _mm256_mulhi_epu16(a, b); } // AVX2
+    inline __m256i mullo_words(__m256i const a, __m256i const b) { return _mm256_mullo_epi16(a, b); } // AVX2
+
+    // 28 bytes must be readable
+    template<typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V load_triplets(std::uint8_t const* p)
+    {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((__m128i const*)p)), _mm_loadu_si128((__m128i const*)(p + 12)), 1); // AVX2
+    }
+
+    inline __m256i compact_lanes(__m256i const a) { return _mm256_permutevar8x32_epi32(a, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)); } // AVX2
+
+    using codec_register = __m256i;
+#else
+    using codec_register = __m128i;
+#endif // __AVX2__
+#endif // __AVX2__ || __SSE4_1__
+
+//-----------------------------------------------------------------------------
+//  hex
+//-----------------------------------------------------------------------------
+#if defined(__AVX2__) || defined(__SSE4_1__)
+    // one register of bytes to two registers of digits
+    template<typename V>
+    void hex_encode_register(std::uint8_t const* in, std::uint8_t* out, V const digits)
+    {
+        V const v = load<V>(in);
+        auto const chars = interleave_bytes(shuffle_bytes<V>(digits, high_nibbles<V>(v)), shuffle_bytes<V>(digits, low_nibbles<V>(v)));
+        store<V>(out, chars[0]);
+        store<V>(out + sizeof(V), chars[1]);
+    }
+
+    // the value of each digit, and all ones in valid for the bytes that are digits of either case
+    template<typename V>
+    V hex_values(V const c, V& valid)
+    {
+        V const digit = sub<std::uint8_t, V>(c, set<std::uint8_t, V>('0'));
+        V const letter = sub<std::uint8_t, V>(bitwise_or<V>(c, set<std::uint8_t, V>(0x20)), set<std::uint8_t, V>('a'));
+        V const is_digit = cmpeq<std::uint8_t, V>(min<std::uint8_t, V>(digit, set<std::uint8_t, V>(9)), digit);
+        V const is_letter = cmpeq<std::uint8_t, V>(min<std::uint8_t, V>(letter, set<std::uint8_t, V>(5)), letter);
+        valid = bitwise_and<V>(valid, bitwise_or<V>(is_digit, is_letter));
+        return bitwise_or<V>(bitwise_and<V>(is_digit, digit), bitwise_and<V>(is_letter, add<std::uint8_t, V>(letter, set<std::uint8_t, V>(10))));
+    }
+
+    // two registers of digits to one register of bytes, high nibble first
+    template<typename V>
+    void hex_decode_register(std::uint8_t const* in, std::uint8_t* out, V& valid)
+    {
+        V const weights = set<std::uint16_t, V>(0x0110);
+        V const a = madd_bytes(hex_values<V>(load<V>(in), valid), weights);
+        V const b = madd_bytes(hex_values<V>(load<V>(in + sizeof(V)), valid), weights);
+        store<V>(out, pack_words(a, b));
+    }
+#endif // __AVX2__ || __SSE4_1__
+
+    constexpr std::uint8_t hex_value(std::uint8_t const c)
+    {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        std::uint8_t const l = c | 0x20;
+        return (l >= 'a' && l <= 'f') ? (l - 'a') + 10 : 0xFF;
+    }
+
+    // two digits per byte, high nibble first, returns 2n
+    inline std::size_t hex_encode(std::uint8_t const* in, std::size_t const n, std::uint8_t* out, bool const upper = false)
+    {
+        std::size_t i = 0;
+    #if defined(__AVX2__) || defined(__SSE4_1__)
+        using V = codec_register;
+        V const digits = broadcast_lane<V>(_mm_loadu_si128((__m128i const*)hex_digits[upper]));
+        for (; i + sizeof(V) <= n; i += sizeof(V)) {
+            hex_encode_register<V>(in + i, out + (i * 2), digits);
+        }
+    #endif // __AVX2__ || __SSE4_1__
+        for (; i < n; ++i) {
+            out[i * 2] = hex_digits[upper][in[i] >> 4];
+            out[(i * 2) + 1] = hex_digits[upper][in[i] & 0x0F];
+        }
+        return n * 2;
+    }
+
+    // either case is accepted, returns n / 2, or decode_error for an odd length or a character that is not a digit
+    inline std::size_t hex_decode(std::uint8_t const* in, std::size_t const n, std::uint8_t* out)
+    {
+        if (n % 2 != 0) {
+            return decode_error;
+        }
+        std::size_t i = 0;
+    #if defined(__AVX2__) || defined(__SSE4_1__)
+        using V = codec_register;
+        V valid = set<std::uint8_t, V>(0xFF);
+        for (; i + (sizeof(V) * 2) <= n; i += sizeof(V) * 2) {
+            hex_decode_register<V>(in + i, out + (i / 2), valid);
+        }
+        if (movemask(valid) != (0xFFFFFFFFu >> (32 - sizeof(V)))) {
+            return decode_error;
+        }
+    #endif // __AVX2__ || __SSE4_1__
+        for (; i < n; i += 2) {
+            std::uint8_t const hi = hex_value(in[i]);
+            std::uint8_t const lo = hex_value(in[i + 1]);
+            if ((hi | lo) == 0xFF) {
+                return decode_error;
+            }
+            out[i / 2] = static_cast<std::uint8_t>((hi << 4) | lo);
+        }
+        return n / 2;
+    }
+
+//-----------------------------------------------------------------------------
+//  base64
+//-----------------------------------------------------------------------------
+#if defined(__AVX2__) || defined(__SSE4_1__)
+    // 12 bytes per lane to 16 characters, see Muła and Lemire, "Faster Base64 Encoding and Decoding using AVX2
+    // Instructions"
+    template<typename V>
+    void base64_encode_register(std::uint8_t const* in, std::uint8_t* out)
+    {
+        // each 32bit lane gets bytes b1 b0 b2 b1 of a triplet, so every 6 bit index is a shift within a 16bit lane
+        V const v = shuffle_bytes<V>(load_triplets<V>(in), broadcast_lane<V>(_mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10)));
+        V const ac = mulhi_words(bitwise_and<V>(v, set<std::uint32_t, V>(0x0FC0FC00)), set<std::uint32_t, V>(0x04000040));
+        V const bd = mullo_words(bitwise_and<V>(v, set<std::uint32_t, V>(0x003F03F0)), set<std::uint32_t, V>(0x01000010));
+        V const idx = bitwise_or<V>(ac, bd);
+
+        // the offset from index to character is one of five, picked by the range the index falls in
+        V const offsets = broadcast_lane<V>(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0));
+        V range = sub_saturate<std::uint8_t, V>(idx, set<std::uint8_t, V>(51));
+        range = bitwise_or<V>(range, bitwise_and<V>(cmpgt<std::int8_t, V>(set<std::int8_t, V>(26), idx), set<std::uint8_t, V>(13)));
+        store<V>(out, add<std::uint8_t, V>(shuffle_bytes<V>(offsets, range), idx));
+    }
+
+    // 16 characters per lane to 12 bytes at the start of the register. Characters outside the alphabet, including
+    // '=', set bits in error
+    template<typename V>
+    V base64_decode_register(V const c, V& error)
+    {
+        // a bit per class of high nibble, and per low nibble the classes it is not valid in
+        V const lut_lo = broadcast_lane<V>(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A));
+        V const lut_hi = broadcast_lane<V>(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+        V const lut_roll = broadcast_lane<V>(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+
+        V const hi = high_nibbles<V>(c);
+        error = bitwise_or<V>(error, bitwise_and<V>(shuffle_bytes<V>(lut_lo, low_nibbles<V>(c)), shuffle_bytes<V>(lut_hi, hi)));
+
+        // the values by adding an offset picked by the high nibble, '/' shares its nibble with '+' so moves down one
+        V const slash = cmpeq<std::uint8_t, V>(c, set<std::uint8_t, V>('/'));
+        V const values = add<std::uint8_t, V>(c, shuffle_bytes<V>(lut_roll, add<std::uint8_t, V>(slash, hi)));
+
+        // 6 bit values merged to 12 bits then 24, and the three bytes of each 32bit lane reversed to memory order
+        V const merged = madd_words(madd_bytes(values, set<std::uint32_t, V>(0x01400140)), set<std::uint32_t, V>(0x00011000));
+        V const bytes = shuffle_bytes<V>(merged, broadcast_lane<V>(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+        return compact_lanes(bytes);
+    }
+#endif // __AVX2__ || __SSE4_1__
+
+    // returns base64_encoded_size(n)
+    inline std::size_t base64_encode(std::uint8_t const* in, std::size_t const n, std::uint8_t* out)
+    {
+        std::size_t i = 0;
+        std::size_t o = 0;
+    #if defined(__AVX2__) || defined(__SSE4_1__)
+        // a register reads 4 bytes past the 12 it uses in its last lane
+        using V = codec_register;
+        constexpr std::size_t step = (sizeof(V) / 4) * 3;
+        for (; i + step + 4 <= n; i += step, o += sizeof(V)) {
+            base64_encode_register<V>(in + i, out + o);
+        }
+    #endif // __AVX2__ || __SSE4_1__
+        for (; i + 3 <= n; i += 3, o += 4) {
+            std::uint32_t const t = (std::uint32_t(in[i]) << 16) | (std::uint32_t(in[i + 1]) << 8) | in[i + 2];
+            out[o] = base64_digits[t >> 18];
+            out[o + 1] = base64_digits[(t >> 12) & 0x3F];
+            out[o + 2] = base64_digits[(t >> 6) & 0x3F];
+            out[o + 3] = base64_digits[t & 0x3F];
+        }
+        if (i < n) {
+            std::uint32_t const t = (std::uint32_t(in[i]) << 16) | (i + 1 < n ? std::uint32_t(in[i + 1]) << 8 : 0);
+            out[o] = base64_digits[t >> 18];
+            out[o + 1] = base64_digits[(t >> 12) & 0x3F];
+            out[o + 2] = i + 1 < n ? base64_digits[(t >> 6) & 0x3F] : '=';
+            out[o + 3] = '=';
+            o += 4;
+        }
+        return o;
+    }
+
+    // the length must be a multiple of 4 with at most two '=' at the end. out needs base64_decoded_size(n) bytes
+    inline std::size_t base64_decode(std::uint8_t const* in, std::size_t const n, std::uint8_t* out)
+    {
+        if (n % 4 != 0) {
+            return decode_error;
+        }
+        std::size_t i = 0;
+        std::size_t o = 0;
+    #if defined(__AVX2__) || defined(__SSE4_1__)
+        // a whole register of characters is always left for the scalar loop, it holds any padding and its output
+        // is room for the unused bytes each register stores
+        using V = codec_register;
+        V error = set<std::uint8_t, V>(0);
+        for (; i + (sizeof(V) * 2) <= n; i += sizeof(V), o += (sizeof(V) / 4) * 3) {
+            store<V>(out + o, base64_decode_register<V>(load<V>(in + i), error));
+        }
+        if (movemask(cmpeq<std::uint8_t, V>(error, set<std::uint8_t, V>(0))) != (0xFFFFFFFFu >> (32 - sizeof(V)))) {
+            return decode_error;
+        }
+    #endif // __AVX2__ || __SSE4_1__
+        std::size_t const pad = n == 0 ? 0 : (in[n - 1] == '=') + (in[n - 2] == '=');
+        for (; i < n; i += 4) {
+            std::array<std::uint8_t, 4> v;
+            for (std::size_t k = 0; k < 4; ++k) {
+                v[k] = base64_values[in[i + k]];
+            }
+            std::uint32_t const t = (std::uint32_t(v[0]) << 18) | (std::uint32_t(v[1]) << 12) | (std::uint32_t(v[2] & 0x3F) << 6) | (v[3] & 0x3F);
+            if (i + 4 == n && pad != 0) {
+                // one '=' must be the last character, "xx=y" is not padding
+                if ((v[0] | v[1]) == 0xFF || (pad == 1 && v[2] == 0xFF)) {
+                    return decode_error;
+                }
+                out[o++] = static_cast<std::uint8_t>(t >> 16);
+                if (pad == 1) {
+                    out[o++] = static_cast<std::uint8_t>(t >> 8);
+                }
+                break;
+            }
+            if ((v[0] | v[1] | v[2] | v[3]) == 0xFF) {
+                return decode_error;
+            }
+            out[o] = static_cast<std::uint8_t>(t >> 16);
+            out[o + 1] = static_cast<std::uint8_t>(t >> 8);
+            out[o + 2] = static_cast<std::uint8_t>(t);
+            o += 3;
+        }
+        return o;
+    }
+
+//-----------------------------------------------------------------------------
+//  utf8 validation
+//-----------------------------------------------------------------------------
+    // the scalar check, one code point at a time
+    inline bool utf8_validate_scalar(std::uint8_t const* p, std::size_t const n)
+    {
+        constexpr std::array<std::uint32_t, 5> smallest = {0, 0, 0x80, 0x800, 0x10000};
+        for (std::size_t i = 0; i < n;) {
+            std::uint8_t const c = p[i];
+            if (c < 0x80) {
+                ++i;
+                continue;
+            }
+            std::size_t const len = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 0;
+            if (len == 0 || i + len > n) {
+                return false;
+            }
+            std::uint32_t cp = c & (0x7F >> len);
+            for (std::size_t k = 1; k < len; ++k) {
+                if ((p[i + k] & 0xC0) != 0x80) {
+                    return false;
+                }
+                cp = (cp << 6) | (p[i + k] & 0x3F);
+            }
+            if (cp < smallest[len] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                return false;
+            }
+            i += len;
+        }
+        return true;
+    }
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+    // Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte". Every error shows up in a pair of
+    // bytes, so three lookups on the nibbles of each byte and the byte before it give a bit per kind of error. Only
+    // a missing third or fourth byte needs the bytes two and three back, and is checked with a saturating subtract
+    template<typename V>
+    struct utf8_checker {
+        V prev = set<std::uint8_t, V>(0);
+        V error = set<std::uint8_t, V>(0);
+        V incomplete = set<std::uint8_t, V>(0);
+
+        static constexpr std::uint8_t too_short = 1 << 0;
+        static constexpr std::uint8_t too_long = 1 << 1;
+        static constexpr std::uint8_t overlong_3 = 1 << 2;
+        static constexpr std::uint8_t too_large = 1 << 3;
+        static constexpr std::uint8_t surrogate = 1 << 4;
+        static constexpr std::uint8_t overlong_2 = 1 << 5;
+        static constexpr std::uint8_t too_large_1000 = 1 << 6;
+        static constexpr std::uint8_t overlong_4 = 1 << 6;
+        static constexpr std::uint8_t two_conts = 1 << 7;
+        static constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+        // indexed by the high nibble of the first byte of the pair, its low nibble, and the high nibble of the second
+        alignas(16) static constexpr std::array<std::uint8_t, 16> byte_1_high_table = {
+            too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+            two_conts, two_conts, two_conts, two_conts,
+            too_short | overlong_2, too_short, too_short | overlong_3 | surrogate, too_short | too_large | too_large_1000 | overlong_4};
+        alignas(16) static constexpr std::array<std::uint8_t, 16> byte_1_low_table = {
+            carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+            carry | too_large, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000, carry | too_large | too_large_1000 | surrogate, carry | too_large | too_large_1000, carry | too_large | too_large_1000};
+        alignas(16) static constexpr std::array<std::uint8_t, 16> byte_2_high_table = {
+            too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_short, too_short, too_short, too_short};
+
+        static V table(std::array<std::uint8_t, 16> const& t) { return broadcast_lane<V>(_mm_load_si128((__m128i const*)t.data())); } // SSE2
+
+        void check(V const input)
+        {
+            // ascii only has to close a sequence left open by the register before
+            if (movemask(input) == 0) {
+                error = bitwise_or<V>(error, incomplete);
+                incomplete = set<std::uint8_t, V>(0);
+                prev = input;
+                return;
+            }
+
+            V const prev1 = shift_in<1, V>(prev, input);
+            V const byte_1_high = shuffle_bytes<V>(table(byte_1_high_table), high_nibbles<V>(prev1));
+            V const byte_1_low = shuffle_bytes<V>(table(byte_1_low_table), low_nibbles<V>(prev1));
+            V const byte_2_high = shuffle_bytes<V>(table(byte_2_high_table), high_nibbles<V>(input));
+            V const special = bitwise_and<V>(bitwise_and<V>(byte_1_high, byte_1_low), byte_2_high);
+
+            // a continuation two or three after a lead byte of 111_____ or 1111____ is expected, and the lookups
+            // flagged it as two_conts
+            V const third = sub_saturate<std::uint8_t, V>(shift_in<2, V>(prev, input), set<std::uint8_t, V>(0xE0 - 0x80));
+            V const fourth = sub_saturate<std::uint8_t, V>(shift_in<3, V>(prev, input), set<std::uint8_t, V>(0xF0 - 0x80));
+            V const must_23 = bitwise_and<V>(bitwise_or<V>(third, fourth), set<std::uint8_t, V>(0x80));
+            error = bitwise_or<V>(error, bitwise_xor<V>(must_23, special));
+
+            // a lead byte in the last three bytes that needs more than are left
+            alignas(32) static constexpr std::array<std::uint8_t, 32> last = {
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+            incomplete = sub_saturate<std::uint8_t, V>(input, load<V>(&last[32 - sizeof(V)]));
+            prev = input;
+        }
+
+        bool valid() const
+        {
+            return movemask(cmpeq<std::uint8_t, V>(bitwise_or<V>(error, incomplete), set<std::uint8_t, V>(0))) == (0xFFFFFFFFu >> (32 - sizeof(V)));
+        }
+    };
+#endif // __AVX2__ || __SSE4_1__
+
+    // true when the bytes are well formed UTF-8: no overlong forms, surrogates, code points past U+10FFFF or
+    // truncated sequences
+    inline bool utf8_validate(std::uint8_t const* p, std::size_t const n)
+    {
+    #if defined(__AVX2__) || defined(__SSE4_1__)
+        using V = codec_register;
+        utf8_checker<V> checker;
+        std::size_t i = 0;
+        for (; i + sizeof(V) <= n; i += sizeof(V)) {
+            checker.check(load<V>(p + i));
+        }
+        // the tail padded with ascii zeros, which also closes the last register
+        alignas(32) std::array<std::uint8_t, sizeof(V)> tail{};
+        if (i < n) {
+            std::memcpy(tail.data(), p + i, n - i);
+        }
+        checker.check(load<V>(tail.data()));
+        return checker.valid();
+    #else
+        return utf8_validate_scalar(p, n);
+    #endif // __AVX2__ || __SSE4_1__
+    }
+
+//-----------------------------------------------------------------------------
+//  spans and vectors
+//-----------------------------------------------------------------------------
+    inline std::size_t hex_encode(std::span<std::uint8_t const> const in, std::span<std::uint8_t> const out, bool const upper = false)
+    {
+        return hex_encode(in.data(), in.size(), out.data(), upper);
+    }
+
+    inline std::size_t hex_decode(std::span<std::uint8_t const> const in, std::span<std::uint8_t> const out)
+    {
+        return hex_decode(in.data(), in.size(), out.data());
+    }
+
+    inline std::size_t hex_decode(std::string_view const in, std::span<std::uint8_t> const out)
+    {
+        return hex_decode(reinterpret_cast<std::uint8_t const*>(in.data()), in.size(), out.data());
+    }
+
+    inline std::size_t base64_encode(std::span<std::uint8_t const> const in, std::span<std::uint8_t> const out)
+    {
+        return base64_encode(in.data(), in.size(), out.data());
+    }
+
+    inline std::size_t base64_decode(std::span<std::uint8_t const> const in, std::span<std::uint8_t> const out)
+    {
+        return base64_decode(in.data(), in.size(), out.data());
+    }
+
+    inline std::size_t base64_decode(std::string_view const in, std::span<std::uint8_t> const out)
+    {
+        return base64_decode(reinterpret_cast<std::uint8_t const*>(in.data()), in.size(), out.data());
+    }
+
+    inline bool utf8_validate(std::span<std::uint8_t const> const in)
+    {
+        return utf8_validate(in.data(), in.size());
+    }
+
+    inline bool utf8_validate(std::string_view const in)
+    {
+        return utf8_validate(reinterpret_cast<std::uint8_t const*>(in.data()), in.size());
+    }
+
+    template<std::size_t N, typename Cont>
+    vector<std::uint8_t, N * 2> hex_encode(vector<std::uint8_t, N, Cont> const& v, bool const upper = false)
+    {
+        vector<std::uint8_t, N * 2> result;
+        hex_encode(&v[0], N, &result[0], upper);
+        return result;
+    }
+
+    template<std::size_t N, typename Cont>
+    requires (N % 2 == 0)
+    bool hex_decode(vector<std::uint8_t, N, Cont> const& v, vector<std::uint8_t, N / 2>& out)
+    {
+        return hex_decode(&v[0], N, &out[0]) != decode_error;
+    }
+
+    template<std::size_t N, typename Cont>
+    vector<std::uint8_t, base64_encoded_size(N)> base64_encode(vector<std::uint8_t, N, Cont> const& v)
+    {
+        vector<std::uint8_t, base64_encoded_size(N)> result;
+        base64_encode(&v[0], N, &result[0]);
+        return result;
+    }
+
+    template<std::size_t N, typename Cont, std::size_t M, typename ContOut>
+    requires (M >= base64_decoded_size(N))
+    std::size_t base64_decode(vector<std::uint8_t, N, Cont> const& v, vector<std::uint8_t, M, ContOut>& out)
+    {
+        return base64_decode(&v[0], N, &out[0]);
+    }
+
+    template<std::size_t N, typename Cont>
+    bool utf8_validate(vector<std::uint8_t, N, Cont> const& v)
+    {
+        return utf8_validate(&v[0], N);
+    }
+}
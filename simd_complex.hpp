@@ -0,0 +1,425 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Complex float/double vectors. The interleaved layout stores std::complex<T> so it can be handed to and from code
+ *  expecting complex arrays, and multiplies with duplicated real/imaginary parts and fmaddsub. The split layout keeps
+ *  the real and imaginary parts in separate simd::vectors, so every op works on whole registers of one part.
+ */
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_loop.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+//-----------------------------------------------------------------------------
+//  interleaved complex instructions
+//-----------------------------------------------------------------------------
+    // [re0 im0 re1 im1 ..] * [re0 im0 re1 im1 ..]: a * b.re -/+ swap(a) * b.im in the even/odd lanes
+    template<typename V>
+    requires (std::is_same_v<V, __m128>)
+    V complex_mul(V const a, V const b) {
+        __m128 const br = _mm_moveldup_ps(b);                                   // SSE3
+        __m128 const bi = _mm_movehdup_ps(b);                                   // SSE3
+        __m128 const as = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));        // SSE
+    #ifdef __FMA__
+        return _mm_fmaddsub_ps(a, br, _mm_mul_ps(as, bi));                      // FMA
+    #else
+        return _mm_addsub_ps(_mm_mul_ps(a, br), _mm_mul_ps(as, bi));            // SSE3
+    #endif // __FMA__
+    }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V complex_mul(V const a, V const b) {
+        __m128d const br = _mm_movedup_pd(b);                                   // SSE3
+        __m128d const bi = _mm_unpackhi_pd(b, b);                               // SSE2
+        __m128d const as = _mm_shuffle_pd(a, a, 1);                             // SSE2
+    #ifdef __FMA__
+        return _mm_fmaddsub_pd(a, br, _mm_mul_pd(as, bi));                      // FMA
+    #else
+        return _mm_addsub_pd(_mm_mul_pd(a, br), _mm_mul_pd(as, bi));            // SSE3
+    #endif // __FMA__
+    }
+
+#ifdef __AVX__
+    template<typename V>
+    requires (std::is_same_v<V, __m256>)
+    V complex_mul(V const a, V const b) {
+        __m256 const br = _mm256_moveldup_ps(b);                                // AVX
+        __m256 const bi = _mm256_movehdup_ps(b);                                // AVX
+        __m256 const as = _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));        // AVX
+    #ifdef __FMA__
+        return _mm256_fmaddsub_ps(a, br, _mm256_mul_ps(as, bi));                // FMA
+    #else
+        return _mm256_addsub_ps(_mm256_mul_ps(a, br), _mm256_mul_ps(as, bi));   // AVX
+    #endif // __FMA__
+    }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V complex_mul(V const a, V const b) {
+        __m256d const br = _mm256_movedup_pd(b);                                // AVX
+        __m256d const bi = _mm256_permute_pd(b, 0xF);                           // AVX
+        __m256d const as = _mm256_permute_pd(a, 0x5);                           // AVX
+    #ifdef __FMA__
+        return _mm256_fmaddsub_pd(a, br, _mm256_mul_pd(as, bi));                // FMA
+    #else
+        return _mm256_addsub_pd(_mm256_mul_pd(a, br), _mm256_mul_pd(as, bi));   // AVX
+    #endif // __FMA__
+    }
+#endif // __AVX__
+
+    // flips the sign of the imaginary lanes
+    template<typename V>
+    requires (std::is_same_v<V, __m128>)
+    V complex_conj(V const a) { return _mm_xor_ps(a, _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)); }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V complex_conj(V const a) { return _mm_xor_pd(a, _mm_setr_pd(0.0, -0.0)); }
+
+#ifdef __AVX__
+    template<typename V>
+    requires (std::is_same_v<V, __m256>)
+    V complex_conj(V const a) { return _mm256_xor_ps(a, _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f)); }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V complex_conj(V const a) { return _mm256_xor_pd(a, _mm256_setr_pd(0.0, -0.0, 0.0, -0.0)); }
+#endif // __AVX__
+
+    // re^2 + im^2 of the complex values in a then b, the horizontal add leaves them in order within each 128bit lane
+    template<typename V>
+    requires (std::is_same_v<V, __m128>)
+    V complex_norm(V const a, V const b) { return _mm_hadd_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)); } // SSE3
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V complex_norm(V const a, V const b) { return _mm_hadd_pd(_mm_mul_pd(a, a), _mm_mul_pd(b, b)); } // SSE3
+
+#ifdef __AVX2__
+    template<typename V>
+    requires (std::is_same_v<V, __m256>)
+    V complex_norm(V const a, V const b) {
+        __m256 const n = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));                                           // AVX
+        return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(n), _MM_SHUFFLE(3, 1, 2, 0)));                        // AVX2
+    }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V complex_norm(V const a, V const b) {
+        return _mm256_permute4x64_pd(_mm256_hadd_pd(_mm256_mul_pd(a, a), _mm256_mul_pd(b, b)), _MM_SHUFFLE(3, 1, 2, 0)); // AVX2
+    }
+#endif // __AVX2__
+
+//-----------------------------------------------------------------------------
+//  complex vector
+//-----------------------------------------------------------------------------
+    enum class complex_layout { interleaved, split };
+
+    template <typename T, std::size_t N, complex_layout Layout = complex_layout::interleaved>
+    requires (std::is_floating_point_v<T>)
+    class complex_vector;
+
+    // std::complex<T> elements, initialised with an extra pair of braces: {{ {1, 2}, {3, 4} }}
+    template <typename T, std::size_t N>
+    class complex_vector<T, N, complex_layout::interleaved> {
+    public:
+        alignas(64) std::complex<T> data[N ? N : 1];
+
+        using vreg = native_register<T>;
+
+        // complex values per register
+        static constexpr std::size_t VC = sizeof(vreg) / sizeof(T) / 2;
+
+        std::complex<T>& operator[](std::size_t index) { return data[index]; }
+        std::complex<T> const& operator[](std::size_t index) const { return data[index]; }
+
+        // std::complex<T> is laid out as T[2], so the values can be loaded as a flat array of 2N parts
+        T* parts() { return reinterpret_cast<T*>(data); }
+        T const* parts() const { return reinterpret_cast<T const*>(data); }
+
+        complex_vector operator+(complex_vector const& other) const
+        {
+            complex_vector result;
+            std::size_t i = 0;
+            policy_loop<T, vreg>(i, N * 2, parts(), other.parts(), result.parts(), [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+            for (; i < N * 2; i++) {
+                result.parts()[i] = parts()[i] + other.parts()[i];
+            }
+            return result;
+        }
+
+        complex_vector operator-(complex_vector const& other) const
+        {
+            complex_vector result;
+            std::size_t i = 0;
+            policy_loop<T, vreg>(i, N * 2, parts(), other.parts(), result.parts(), [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+            for (; i < N * 2; i++) {
+                result.parts()[i] = parts()[i] - other.parts()[i];
+            }
+            return result;
+        }
+
+        complex_vector operator*(complex_vector const& other) const
+        {
+            complex_vector result;
+            std::size_t i = 0;
+            policy_loop<T, vreg>(i, N * 2, parts(), other.parts(), result.parts(), [](vreg a, vreg b){ return complex_mul(a, b); });
+            for (i /= 2; i < N; i++) {
+                result.data[i] = mul_scalar(data[i], other.data[i]);
+            }
+            return result;
+        }
+
+        complex_vector operator*(std::complex<T> const& s) const
+        {
+            complex_vector result;
+            std::size_t i = 0;
+            scalar_loop(i, s, parts(), result.parts());
+            for (i /= 2; i < N; i++) {
+                result.data[i] = mul_scalar(data[i], s);
+            }
+            return result;
+        }
+
+        friend complex_vector operator*(std::complex<T> const& s, complex_vector const& other) { return other * s; }
+
+        // the same formula and rounding as the registers, std::complex's multiply also handles infinities and NaNs.
+        // fmaddsub fuses a * b.re with the product of the swapped lanes as addend
+        static std::complex<T> mul_scalar(std::complex<T> const a, std::complex<T> const b)
+        {
+        #ifdef __FMA__
+            return {std::fma(a.real(), b.real(), -(a.imag() * b.imag())), std::fma(a.imag(), b.real(), a.real() * b.imag())};
+        #else
+            return {(a.real() * b.real()) - (a.imag() * b.imag()), (a.imag() * b.real()) + (a.real() * b.imag())};
+        #endif // __FMA__
+        }
+
+    private:
+        // broadcast the scalar as a re/im pair to every complex lane
+        static void scalar_loop(std::size_t& i, std::complex<T> const& s, T const* b, T* c)
+        {
+            alignas(64) T pairs[sizeof(vreg) / sizeof(T)];
+            for (std::size_t l = 0; l < VC; ++l) {
+                pairs[l * 2] = s.real();
+                pairs[(l * 2) + 1] = s.imag();
+            }
+            vreg const vs = load<vreg>(pairs);
+            unrolled_loop_scalar<T, vreg, loop_policy<vreg>::unroll>(i, N * 2, vs, b, c, 0, [](vreg a, vreg b){ return complex_mul(a, b); });
+        }
+    };
+
+    // separate real and imaginary vectors, initialised as {{re0, re1, ..}, {im0, im1, ..}}
+    template <typename T, std::size_t N>
+    class complex_vector<T, N, complex_layout::split> {
+    public:
+        vector<T, N> re;
+        vector<T, N> im;
+
+        using vreg = typename vector<T, N>::vreg;
+
+        std::complex<T> operator[](std::size_t index) const { return {re[index], im[index]}; }
+
+        complex_vector operator+(complex_vector const& other) const { return {re + other.re, im + other.im}; }
+        complex_vector operator-(complex_vector const& other) const { return {re - other.re, im - other.im}; }
+
+        complex_vector operator*(complex_vector const& other) const
+        {
+            constexpr std::size_t VN = sizeof(vreg) / sizeof(T);
+            complex_vector result;
+            std::size_t i = 0;
+
+            for (; i + VN <= N; i += VN) {
+                vreg const ar = load<vreg>(&re[i]);
+                vreg const ai = load<vreg>(&im[i]);
+                vreg const br = load<vreg>(&other.re[i]);
+                vreg const bi = load<vreg>(&other.im[i]);
+                store<vreg>(&result.re[i], sub<T, vreg>(mul<T, vreg>(ar, br), mul<T, vreg>(ai, bi)));
+                store<vreg>(&result.im[i], add<T, vreg>(mul<T, vreg>(ar, bi), mul<T, vreg>(ai, br)));
+            }
+            for (; i < N; i++) {
+                result.re[i] = (re[i] * other.re[i]) - (im[i] * other.im[i]);
+                result.im[i] = (re[i] * other.im[i]) + (im[i] * other.re[i]);
+            }
+            return result;
+        }
+
+        complex_vector operator*(std::complex<T> const& s) const
+        {
+            return {(re * s.real()) - (im * s.imag()), (re * s.imag()) + (im * s.real())};
+        }
+
+        friend complex_vector operator*(std::complex<T> const& s, complex_vector const& other) { return other * s; }
+    };
+
+//-----------------------------------------------------------------------------
+//  conj / norm
+//-----------------------------------------------------------------------------
+    template <typename T, std::size_t N>
+    complex_vector<T, N> conj(complex_vector<T, N> const& v)
+    {
+        using V = typename complex_vector<T, N>::vreg;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        complex_vector<T, N> result;
+        std::size_t i = 0;
+
+        for (; i + VN <= N * 2; i += VN) {
+            store<V>(&result.parts()[i], complex_conj(load<V>(&v.parts()[i])));
+        }
+        for (i /= 2; i < N; i++) {
+            result[i] = std::conj(v[i]);
+        }
+        return result;
+    }
+
+    // multiplying by -1 rather than subtracting from 0 keeps conj(x + 0i) = x - 0i as std::conj does
+    template <typename T, std::size_t N>
+    complex_vector<T, N, complex_layout::split> conj(complex_vector<T, N, complex_layout::split> const& v)
+    {
+        return {v.re, v.im * T(-1)};
+    }
+
+    // squared magnitude re^2 + im^2, as std::norm
+    template <typename T, std::size_t N>
+    vector<T, N> norm(complex_vector<T, N> const& v)
+    {
+        using V = typename complex_vector<T, N>::vreg;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        vector<T, N> result;
+        std::size_t i = 0;
+
+        // two registers of interleaved values give one register of norms
+        for (; i + VN <= N; i += VN) {
+            store<V>(&result[i], complex_norm(load<V>(&v.parts()[i * 2]), load<V>(&v.parts()[(i * 2) + VN])));
+        }
+        for (; i < N; i++) {
+            result[i] = (v[i].real() * v[i].real()) + (v[i].imag() * v[i].imag());
+        }
+        return result;
+    }
+
+    template <typename T, std::size_t N>
+    vector<T, N> norm(complex_vector<T, N, complex_layout::split> const& v)
+    {
+        return (v.re * v.re) + (v.im * v.im);
+    }
+
+//-----------------------------------------------------------------------------
+//  dot / vdot
+//-----------------------------------------------------------------------------
+    // sum of a[i] * b[i], conjugating a first when Conj is set
+    template <bool Conj, typename T, std::size_t N>
+    std::complex<T> complex_dot(complex_vector<T, N> const& a, complex_vector<T, N> const& b)
+    {
+        using V = typename complex_vector<T, N>::vreg;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        auto conj_if = [](V const x) { if constexpr (Conj) { return complex_conj(x); } else { return x; } };
+        V acc1 = set<T, V>(T(0));
+        V acc2 = acc1;
+        std::size_t i = 0;
+
+        for (; i + (VN * 2) <= N * 2; i += (VN * 2)) {
+            acc1 = add<T, V>(acc1, complex_mul(conj_if(load<V>(&a.parts()[i])), load<V>(&b.parts()[i])));
+            acc2 = add<T, V>(acc2, complex_mul(conj_if(load<V>(&a.parts()[i + VN])), load<V>(&b.parts()[i + VN])));
+        }
+
+        alignas(64) T lanes[VN];
+        store<V>(lanes, add<T, V>(acc1, acc2));
+        std::complex<T> result = 0;
+        for (std::size_t l = 0; l < VN; l += 2) {
+            result += std::complex<T>(lanes[l], lanes[l + 1]);
+        }
+        for (i /= 2; i < N; i++) {
+            result += complex_vector<T, N>::mul_scalar(Conj ? std::conj(a[i]) : a[i], b[i]);
+        }
+        return result;
+    }
+
+    template <bool Conj, typename T, std::size_t N>
+    std::complex<T> complex_dot(complex_vector<T, N, complex_layout::split> const& a, complex_vector<T, N, complex_layout::split> const& b)
+    {
+        using V = typename vector<T, N>::vreg;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        V acc_re = set<T, V>(T(0));
+        V acc_im = acc_re;
+        std::size_t i = 0;
+
+        for (; i + VN <= N; i += VN) {
+            V const ar = load<V>(&a.re[i]);
+            V const ai = load<V>(&a.im[i]);
+            V const br = load<V>(&b.re[i]);
+            V const bi = load<V>(&b.im[i]);
+            if constexpr (Conj) {
+                acc_re = add<T, V>(acc_re, add<T, V>(mul<T, V>(ar, br), mul<T, V>(ai, bi)));
+                acc_im = add<T, V>(acc_im, sub<T, V>(mul<T, V>(ar, bi), mul<T, V>(ai, br)));
+            }
+            else {
+                acc_re = add<T, V>(acc_re, sub<T, V>(mul<T, V>(ar, br), mul<T, V>(ai, bi)));
+                acc_im = add<T, V>(acc_im, add<T, V>(mul<T, V>(ar, bi), mul<T, V>(ai, br)));
+            }
+        }
+
+        alignas(64) T lanes_re[VN];
+        alignas(64) T lanes_im[VN];
+        store<V>(lanes_re, acc_re);
+        store<V>(lanes_im, acc_im);
+        T re = 0;
+        T im = 0;
+        for (std::size_t l = 0; l < VN; ++l) {
+            re += lanes_re[l];
+            im += lanes_im[l];
+        }
+        for (; i < N; i++) {
+            T const ai = Conj ? -a.im[i] : a.im[i];
+            re += (a.re[i] * b.re[i]) - (ai * b.im[i]);
+            im += (a.re[i] * b.im[i]) + (ai * b.re[i]);
+        }
+        return {re, im};
+    }
+
+    // sum of a[i] * b[i]
+    template <typename T, std::size_t N, complex_layout Layout>
+    std::complex<T> dot(complex_vector<T, N, Layout> const& a, complex_vector<T, N, Layout> const& b)
+    {
+        return complex_dot<false>(a, b);
+    }
+
+    // sum of conj(a[i]) * b[i]
+    template <typename T, std::size_t N, complex_layout Layout>
+    std::complex<T> vdot(complex_vector<T, N, Layout> const& a, complex_vector<T, N, Layout> const& b)
+    {
+        return complex_dot<true>(a, b);
+    }
+
+//-----------------------------------------------------------------------------
+//  layout conversion
+//-----------------------------------------------------------------------------
+    template <typename T, std::size_t N>
+    complex_vector<T, N, complex_layout::split> split(complex_vector<T, N> const& v)
+    {
+        complex_vector<T, N, complex_layout::split> result;
+        for (std::size_t i = 0; i < N; i++) {
+            result.re[i] = v[i].real();
+            result.im[i] = v[i].imag();
+        }
+        return result;
+    }
+
+    template <typename T, std::size_t N>
+    complex_vector<T, N> interleave(complex_vector<T, N, complex_layout::split> const& v)
+    {
+        complex_vector<T, N> result;
+        for (std::size_t i = 0; i < N; i++) {
+            result[i] = {v.re[i], v.im[i]};
+        }
+        return result;
+    }
+}
@@ -0,0 +1,168 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  FIR filters and 1D convolution with the tap count fixed at compile time, so the loop over taps is fully unrolled
+ *  and each output register is one chain of multiply-adds. Float and double use fmadd. int16 taps are Q15 and use
+ *  _mm256_madd_epi16 on pairs of taps into 32bit sums, which are rounded, shifted back by 15 and saturated. Taps whose
+ *  absolute values add up to 65536 (a gain of 2.0) or more could overflow those sums and are filtered with 64bit sums.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    template<typename T>
+    concept fir_element = std::is_floating_point_v<T> || std::is_same_v<T, std::int16_t>;
+
+//-----------------------------------------------------------------------------
+//  kernels
+//-----------------------------------------------------------------------------
+    // out[i] = sum taps[k] * in[i - k] for i < n, in[-(K - 1)] up to in[-1] are the samples before the block
+    template<typename T, std::size_t K>
+    requires (fir_element<T> && K > 0)
+    void fir_block(std::array<T, K> const& taps, T const* in, T* out, std::size_t const n)
+    {
+        std::size_t i = 0;
+
+        if constexpr (std::is_floating_point_v<T>) {
+            using V = native_register<T>;
+            constexpr std::size_t VN = sizeof(V) / sizeof(T);
+
+            // two output registers per iteration keep two independent fmadd chains in flight
+            for (; i + (VN * 2) <= n; i += (VN * 2)) {
+                V acc1 = set<T, V>(T(0));
+                V acc2 = acc1;
+                [&]<std::size_t... k>(std::index_sequence<k...>) {
+                    ((acc1 = fmadd<T, V>(set<T, V>(taps[k]), load<V>(in + i - k), acc1),
+                      acc2 = fmadd<T, V>(set<T, V>(taps[k]), load<V>(in + i + VN - k), acc2)), ...);
+                }(std::make_index_sequence<K>{});
+                store<V>(&out[i], acc1);
+                store<V>(&out[i + VN], acc2);
+            }
+            for (; i + VN <= n; i += VN) {
+                V acc = set<T, V>(T(0));
+                [&]<std::size_t... k>(std::index_sequence<k...>) {
+                    ((acc = fmadd<T, V>(set<T, V>(taps[k]), load<V>(in + i - k), acc)), ...);
+                }(std::make_index_sequence<K>{});
+                store<V>(&out[i], acc);
+            }
+            for (; i < n; i++) {
+                T acc = T(0);
+                for (std::size_t k = 0; k < K; ++k) {
+                    acc += taps[k] * *(in + i - k);
+                }
+                out[i] = acc;
+            }
+        }
+        else {
+    #ifdef __AVX2__
+            // the 32bit sums are exact while sum |taps| * 32768 fits, i.e. sum |taps| < 65536 or an L1 gain below 2.0
+            // in Q15. A filter with more gain would wrap them, so all its outputs take the 64bit loop below
+            std::int64_t gain = 0;
+            for (std::size_t k = 0; k < K; ++k) {
+                gain += taps[k] < 0 ? -std::int64_t(taps[k]) : std::int64_t(taps[k]);
+            }
+            std::size_t const vector_n = gain < 65536 ? n : 0;
+
+            // 16 outputs per iteration. Interleaving in[i - k + j] with in[i - k - 1 + j] lines each sample up with the
+            // tap pair (taps[k], taps[k + 1]), an odd last tap is paired with 0. The low and high unpacks hold outputs
+            // 0-3, 8-11 and 4-7, 12-15, which packs_epi32 puts back in order per 128bit lane
+            for (; i + 16 <= vector_n; i += 16) {
+                __m256i lo = _mm256_setzero_si256();
+                __m256i hi = _mm256_setzero_si256();
+                [&]<std::size_t... p>(std::index_sequence<p...>) {
+                    ([&] {
+                        constexpr std::size_t k = p * 2;
+                        std::int16_t const next = (k + 1) < K ? taps[(k + 1) % K] : std::int16_t(0);
+                        __m256i const w = _mm256_set1_epi32(static_cast<std::uint16_t>(taps[k]) | (static_cast<std::uint32_t>(static_cast<std::uint16_t>(next)) << 16));
+                        __m256i const x0 = _mm256_loadu_si256((__m256i_u*)(in + i - k));
+                        __m256i const x1 = (k + 1) < K ? _mm256_loadu_si256((__m256i_u*)(in + i - k - 1)) : x0;
+                        lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x0, x1), w)); // AVX2
+                        hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x0, x1), w)); // AVX2
+                    }(), ...);
+                }(std::make_index_sequence<(K + 1) / 2>{});
+                __m256i const half = _mm256_set1_epi32(1 << 14);
+                lo = _mm256_srai_epi32(_mm256_add_epi32(lo, half), 15);
+                hi = _mm256_srai_epi32(_mm256_add_epi32(hi, half), 15);
+                _mm256_storeu_si256((__m256i_u*)&out[i], _mm256_packs_epi32(lo, hi)); // AVX2
+            }
+    #endif // __AVX2__
+            // K products of at most 2^30 cannot overflow 64 bits
+            for (; i < n; i++) {
+                std::int64_t acc = 0;
+                for (std::size_t k = 0; k < K; ++k) {
+                    acc += std::int64_t(taps[k]) * *(in + i - k);
+                }
+                acc = (acc + (1 << 14)) >> 15;
+                out[i] = static_cast<std::int16_t>(std::clamp<std::int64_t>(acc, std::numeric_limits<std::int16_t>::min(), std::numeric_limits<std::int16_t>::max()));
+            }
+        }
+    }
+
+    // full convolution, every output that overlaps the signal by at least one tap
+    template<typename T, std::size_t N, typename Cont, std::size_t K>
+    requires (fir_element<T> && K > 0)
+    vector<T, N + K - 1> convolve(vector<T, N, Cont> const& signal, std::array<T, K> const& taps)
+    {
+        vector<T, N + (2 * (K - 1))> padded = {};
+        std::copy_n(&signal[0], N, &padded[K - 1]);
+
+        vector<T, N + K - 1> result;
+        fir_block(taps, &padded[K - 1], &result[0], N + K - 1);
+        return result;
+    }
+
+//-----------------------------------------------------------------------------
+//  streaming filter
+//-----------------------------------------------------------------------------
+    // keeps the last K - 1 input samples, so a stream cut into blocks of any size filters as if it was one array
+    template<typename T, std::size_t K>
+    requires (fir_element<T> && K > 0)
+    class fir {
+    public:
+        explicit fir(std::array<T, K> const& taps) : taps(taps), history{} {}
+
+        // out may not be in
+        void process(T const* in, T* out, std::size_t const n)
+        {
+            // the first K - 1 outputs reach back into the previous block, the rest read the block directly
+            std::size_t const head = std::min(n, K - 1);
+            std::array<T, 2 * (K - 1)> joined;
+            std::copy_n(history.data(), K - 1, joined.data());
+            std::copy_n(in, head, joined.data() + (K - 1));
+
+            fir_block(taps, joined.data() + (K - 1), out, head);
+            if (n > head) {
+                fir_block(taps, in + head, out + head, n - head);
+                std::copy_n(in + n - (K - 1), K - 1, history.data());
+            }
+            else {
+                std::copy_n(joined.data() + n, K - 1, history.data());
+            }
+        }
+
+        template<std::size_t N, typename Cont>
+        vector<T, N> process(vector<T, N, Cont> const& in)
+        {
+            vector<T, N> result;
+            process(&in[0], &result[0], N);
+            return result;
+        }
+
+        void reset() { history = {}; }
+
+    private:
+        std::array<T, K> taps;
+        std::array<T, K - 1> history;
+    };
+}
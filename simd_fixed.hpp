@@ -0,0 +1,163 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Q15 and Q31 fixed point element types. A fixed<int16_t, 15> holds x * 2^15 in an int16_t, so it covers [-1, 1).
+ *  Addition and subtraction saturate, multiplication rounds to nearest and saturates, and conversion from float rounds
+ *  to nearest even and saturates. The scalar operators here are what the register operations compute lane by lane,
+ *  so a simd::vector of fixed gives the same bits whichever path an element takes. to_float and to_fixed convert
+ *  whole arrays and vectors to and from float.
+ */
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    template<typename I, int F>
+    requires (std::is_same_v<I, std::int16_t> || std::is_same_v<I, std::int32_t>) && (F == (sizeof(I) * 8) - 1)
+    struct fixed {
+        using rep = I;
+        static constexpr int fraction_bits = F;
+
+        I raw;
+
+        constexpr fixed() = default;
+
+        // round to nearest even after scaling, out of range and NaN saturate like the register conversion
+        constexpr explicit fixed(float const x) : raw(from_scaled(x * scale)) {}
+
+        static constexpr fixed from_raw(I const r) {
+            fixed result;
+            result.raw = r;
+            return result;
+        }
+
+        static constexpr fixed max() { return from_raw(std::numeric_limits<I>::max()); }
+        static constexpr fixed min() { return from_raw(std::numeric_limits<I>::min()); }
+
+        constexpr explicit operator float() const { return static_cast<float>(raw) * (1.0f / scale); }
+
+        friend constexpr fixed operator+(fixed const a, fixed const b) { return from_raw(saturate(wide(a.raw) + b.raw)); }
+        friend constexpr fixed operator-(fixed const a, fixed const b) { return from_raw(saturate(wide(a.raw) - b.raw)); }
+
+        // (a b + 2^(F - 1)) >> F, as pmulhrsw computes it. Only min() * min() is out of range
+        friend constexpr fixed operator*(fixed const a, fixed const b) {
+            return from_raw(saturate(((wide(a.raw) * b.raw) + (wide(1) << (F - 1))) >> F));
+        }
+
+        constexpr fixed operator-() const { return from_raw(saturate(-wide(raw))); }
+
+        constexpr fixed& operator+=(fixed const b) { return *this = *this + b; }
+        constexpr fixed& operator-=(fixed const b) { return *this = *this - b; }
+        constexpr fixed& operator*=(fixed const b) { return *this = *this * b; }
+
+        friend constexpr bool operator==(fixed const a, fixed const b) = default;
+        friend constexpr auto operator<=>(fixed const a, fixed const b) = default;
+
+    private:
+        using wide = std::conditional_t<sizeof(I) == 2, std::int32_t, std::int64_t>;
+
+        static constexpr float scale = static_cast<float>(wide(1) << F);
+
+        static constexpr I saturate(wide const x) {
+            return static_cast<I>(x > std::numeric_limits<I>::max() ? std::numeric_limits<I>::max()
+                                : x < std::numeric_limits<I>::min() ? std::numeric_limits<I>::min() : x);
+        }
+
+        // the largest float below 2^F is the top of the range, the same clamp as minps/maxps so NaN goes to it
+        static constexpr I from_scaled(float s) {
+            constexpr float hi = sizeof(I) == 2 ? 32767.0f : 2147483520.0f;
+            constexpr float lo = -scale;
+            s = s < hi ? s : hi;
+            s = s > lo ? s : lo;
+            // s is exact in double and within range of the integer, so the fraction is exact too
+            double const d = s;
+            std::int64_t t = static_cast<std::int64_t>(d);
+            double const frac = d - static_cast<double>(t);
+            if (frac > 0.5 || (frac == 0.5 && (t & 1) != 0)) {
+                ++t;
+            }
+            else if (frac < -0.5 || (frac == -0.5 && (t & 1) != 0)) {
+                --t;
+            }
+            return static_cast<I>(t);
+        }
+    };
+
+    using q15 = fixed<std::int16_t, 15>;
+    using q31 = fixed<std::int32_t, 31>;
+
+    template<typename I, int F>
+    constexpr bool is_fixed_v<fixed<I, F>> = true;
+
+//-----------------------------------------------------------------------------
+//  fixed point conversions
+//-----------------------------------------------------------------------------
+    // out = in / 2^F, exact for Q15 and rounded to nearest even for Q31
+    template<typename T>
+    requires (is_fixed_v<T>)
+    void to_float(T const* in, float* out, std::size_t const n)
+    {
+        std::size_t i = 0;
+    #ifdef __AVX2__
+        __m256 const scale = _mm256_set1_ps(1.0f / static_cast<float>(std::int64_t(1) << T::fraction_bits));
+        for (; i + 8 <= n; i += 8) {
+            __m256i v;
+            if constexpr (sizeof(T) == 2) { v = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i_u*)&in[i])); } // AVX2
+            else                          { v = _mm256_loadu_si256((__m256i_u*)&in[i]); }
+            _mm256_storeu_ps(&out[i], _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale)); // AVX
+        }
+    #endif // __AVX2__
+        for (; i < n; i++) {
+            out[i] = static_cast<float>(in[i]);
+        }
+    }
+
+    // out = in * 2^F rounded to nearest even, clamped to the range first so large values and NaN saturate
+    template<typename T>
+    requires (is_fixed_v<T>)
+    void to_fixed(float const* in, T* out, std::size_t const n)
+    {
+        std::size_t i = 0;
+    #ifdef __AVX2__
+        __m256 const scale = _mm256_set1_ps(static_cast<float>(std::int64_t(1) << T::fraction_bits));
+        __m256 const hi = _mm256_set1_ps(sizeof(T) == 2 ? 32767.0f : 2147483520.0f);
+        __m256 const lo = _mm256_set1_ps(-static_cast<float>(std::int64_t(1) << T::fraction_bits));
+        for (; i + 8 <= n; i += 8) {
+            __m256 const s = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(&in[i]), scale), hi), lo);
+            __m256i const v = _mm256_cvtps_epi32(s); // AVX
+            if constexpr (sizeof(T) == 2) { _mm_storeu_si128((__m128i_u*)&out[i], _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1))); } // AVX2
+            else                          { _mm256_storeu_si256((__m256i_u*)&out[i], v); }
+        }
+    #endif // __AVX2__
+        for (; i < n; i++) {
+            out[i] = T(in[i]);
+        }
+    }
+
+    template<typename T, std::size_t N, typename Cont>
+    requires (is_fixed_v<T>)
+    vector<float, N> to_float(vector<T, N, Cont> const& a)
+    {
+        vector<float, N> result;
+        to_float(&a[0], &result[0], N);
+        return result;
+    }
+
+    // simd::to_fixed<simd::q15>(v)
+    template<typename T, std::size_t N, typename Cont>
+    requires (is_fixed_v<T>)
+    vector<T, N> to_fixed(vector<float, N, Cont> const& a)
+    {
+        vector<T, N> result;
+        to_fixed(&a[0], &result[0], N);
+        return result;
+    }
+}
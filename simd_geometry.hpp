@@ -0,0 +1,617 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Batched geometry on many 3 and 4 component vectors. A single vec3 is too small for a register, so every lane holds
+ *  a different vector instead: dot, cross, length and normalize run on one component register at a time. Structure
+ *  of arrays input (a simd::soa of 3 or 4 float/double columns) is loaded as is. Arrays of structs of floats are
+ *  transposed in registers 8 vectors at a time on the way in and transposed back on the way out. mat4 is a column
+ *  major 4x4 float matrix with SSE/AVX multiply, transpose and inverse, and transforms batches of points.
+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_soa.hpp"
+#include "simd_storage.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    template<typename T, typename... Ts>
+    concept geometry_fields = std::is_floating_point_v<T> && (std::is_same_v<T, Ts> && ...)
+                              && (sizeof...(Ts) == 2 || sizeof...(Ts) == 3);
+
+//-----------------------------------------------------------------------------
+//  array of structs transposes
+//-----------------------------------------------------------------------------
+#ifdef __AVX2__
+    // x0 y0 z0 x1 y1 z1 .. z7 to one register per component, the three loads per 128bit lane are reordered with
+    // five shuffles
+    inline std::array<__m256, 3> load_aos3(float const* p) {
+        __m256 const m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 0)), _mm_loadu_ps(p + 12), 1); // AVX
+        __m256 const m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1); // AVX
+        __m256 const m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1); // AVX
+        __m256 const xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+        __m256 const yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+        return {_mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0)),
+                _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)),
+                _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1))};
+    }
+
+    inline void store_aos3(float* p, std::array<__m256, 3> const& c) {
+        __m256 const xy = _mm256_shuffle_ps(c[0], c[1], _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 const yz = _mm256_shuffle_ps(c[1], c[2], _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 const zx = _mm256_shuffle_ps(c[2], c[0], _MM_SHUFFLE(3, 1, 2, 0));
+        __m256 const m03 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 const m14 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        __m256 const m25 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(p + 0, _mm256_castps256_ps128(m03));
+        _mm_storeu_ps(p + 4, _mm256_castps256_ps128(m14));
+        _mm_storeu_ps(p + 8, _mm256_castps256_ps128(m25));
+        _mm_storeu_ps(p + 12, _mm256_extractf128_ps(m03, 1)); // AVX
+        _mm_storeu_ps(p + 16, _mm256_extractf128_ps(m14, 1)); // AVX
+        _mm_storeu_ps(p + 20, _mm256_extractf128_ps(m25, 1)); // AVX
+    }
+
+    // vectors k and k + 4 share a row, so _MM_TRANSPOSE4_PS in each 128bit lane leaves the components in order
+    inline std::array<__m256, 4> transpose4(std::array<__m256, 4> const& r) {
+        __m256 const t0 = _mm256_unpacklo_ps(r[0], r[1]);
+        __m256 const t1 = _mm256_unpacklo_ps(r[2], r[3]);
+        __m256 const t2 = _mm256_unpackhi_ps(r[0], r[1]);
+        __m256 const t3 = _mm256_unpackhi_ps(r[2], r[3]);
+        return {_mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)), _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)),
+                _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0)), _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2))};
+    }
+
+    inline std::array<__m256, 4> load_aos4(float const* p) {
+        std::array<__m256, 4> rows;
+        for (std::size_t k = 0; k < 4; ++k) {
+            rows[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + (k * 4))), _mm_loadu_ps(p + (k * 4) + 16), 1); // AVX
+        }
+        return transpose4(rows);
+    }
+
+    inline void store_aos4(float* p, std::array<__m256, 4> const& c) {
+        std::array<__m256, 4> const rows = transpose4(c);
+        for (std::size_t k = 0; k < 4; ++k) {
+            _mm_storeu_ps(p + (k * 4), _mm256_castps256_ps128(rows[k]));
+            _mm_storeu_ps(p + (k * 4) + 16, _mm256_extractf128_ps(rows[k], 1)); // AVX
+        }
+    }
+#endif // __AVX2__
+
+    // the array of structs kernels below take the register path for floats, doubles stay scalar
+    template<typename T, std::size_t C>
+    constexpr bool has_aos_transpose =
+#ifdef __AVX2__
+        std::is_same_v<T, float> && sizeof(std::array<T, C>) == (C * sizeof(T));
+#else
+        false;
+#endif // __AVX2__
+
+//-----------------------------------------------------------------------------
+//  component kernels
+//-----------------------------------------------------------------------------
+    // written once for registers and once for the scalar tail, every lane is its own vector
+    template<typename T, typename V, std::size_t C>
+    V dot(std::array<V, C> const& a, std::array<V, C> const& b) {
+        V acc = mul<T, V>(a[0], b[0]);
+        for (std::size_t k = 1; k < C; ++k) {
+            acc = add<T, V>(acc, mul<T, V>(a[k], b[k]));
+        }
+        return acc;
+    }
+
+    template<typename T, typename V>
+    std::array<V, 3> cross(std::array<V, 3> const& a, std::array<V, 3> const& b) {
+        return {sub<T, V>(mul<T, V>(a[1], b[2]), mul<T, V>(a[2], b[1])),
+                sub<T, V>(mul<T, V>(a[2], b[0]), mul<T, V>(a[0], b[2])),
+                sub<T, V>(mul<T, V>(a[0], b[1]), mul<T, V>(a[1], b[0]))};
+    }
+
+    // one division for the reciprocal length, rsqrt is only good to 12 bits
+    template<typename T, typename V, std::size_t C>
+    std::array<V, C> normalize(std::array<V, C> const& a) {
+        V const inv = div<T, V>(set<T, V>(T(1)), sqrt<T, V>(dot<T, V>(a, a)));
+        std::array<V, C> result;
+        for (std::size_t k = 0; k < C; ++k) {
+            result[k] = mul<T, V>(a[k], inv);
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t C>
+    T dot(std::array<T, C> const& a, std::array<T, C> const& b) {
+        T acc = a[0] * b[0];
+        for (std::size_t k = 1; k < C; ++k) {
+            acc += a[k] * b[k];
+        }
+        return acc;
+    }
+
+    template<typename T>
+    std::array<T, 3> cross(std::array<T, 3> const& a, std::array<T, 3> const& b) {
+        return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+    }
+
+    template<typename T, std::size_t C>
+    std::array<T, C> normalize(std::array<T, C> const& a) {
+        T const inv = T(1) / std::sqrt(dot(a, a));
+        std::array<T, C> result;
+        for (std::size_t k = 0; k < C; ++k) {
+            result[k] = a[k] * inv;
+        }
+        return result;
+    }
+
+//-----------------------------------------------------------------------------
+//  structure of arrays
+//-----------------------------------------------------------------------------
+    // column pointers of a soa and the vector i of a soa, for the register loops and their tails
+    template<std::size_t N, typename T, typename... Ts>
+    std::array<T*, sizeof...(Ts) + 1> columns(soa<N, T, Ts...>& s) {
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return std::array<T*, sizeof...(Ts) + 1>{&s.template column<I>()[0]...};
+        }(std::index_sequence_for<T, Ts...>{});
+    }
+
+    template<std::size_t N, typename T, typename... Ts>
+    std::array<T const*, sizeof...(Ts) + 1> columns(soa<N, T, Ts...> const& s) {
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return std::array<T const*, sizeof...(Ts) + 1>{&s.template column<I>()[0]...};
+        }(std::index_sequence_for<T, Ts...>{});
+    }
+
+    template<typename V, typename T, std::size_t C>
+    std::array<V, C> load_columns(std::array<T const*, C> const& c, std::size_t const i) {
+        std::array<V, C> result;
+        for (std::size_t k = 0; k < C; ++k) {
+            result[k] = load<V>(c[k] + i);
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t C>
+    std::array<T, C> gather_columns(std::array<T const*, C> const& c, std::size_t const i) {
+        std::array<T, C> result;
+        for (std::size_t k = 0; k < C; ++k) {
+            result[k] = c[k][i];
+        }
+        return result;
+    }
+
+    template<std::size_t N, typename T, typename... Ts>
+    requires (geometry_fields<T, Ts...>)
+    heap_vector<T, N> dot(soa<N, T, Ts...> const& a, soa<N, T, Ts...> const& b)
+    {
+        using V = native_register<T>;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        auto const ca = columns(a);
+        auto const cb = columns(b);
+        heap_vector<T, N> result;
+        std::size_t i = 0;
+
+        for (; i + VN <= N; i += VN) {
+            store<V>(&result[i], dot<T, V>(load_columns<V>(ca, i), load_columns<V>(cb, i)));
+        }
+        for (; i < N; i++) {
+            result[i] = dot(gather_columns(ca, i), gather_columns(cb, i));
+        }
+        return result;
+    }
+
+    template<std::size_t N, typename T, typename... Ts>
+    requires (geometry_fields<T, Ts...>)
+    heap_vector<T, N> length(soa<N, T, Ts...> const& a)
+    {
+        using V = native_register<T>;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        auto const ca = columns(a);
+        heap_vector<T, N> result;
+        std::size_t i = 0;
+
+        for (; i + VN <= N; i += VN) {
+            auto const va = load_columns<V>(ca, i);
+            store<V>(&result[i], sqrt<T, V>(dot<T, V>(va, va)));
+        }
+        for (; i < N; i++) {
+            auto const sa = gather_columns(ca, i);
+            result[i] = std::sqrt(dot(sa, sa));
+        }
+        return result;
+    }
+
+    template<std::size_t N, typename T, typename... Ts>
+    requires (geometry_fields<T, Ts...>)
+    soa<N, T, Ts...> normalize(soa<N, T, Ts...> const& a)
+    {
+        using V = native_register<T>;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        constexpr std::size_t C = sizeof...(Ts) + 1;
+        auto const ca = columns(a);
+        soa<N, T, Ts...> result;
+        auto const cr = columns(result);
+        std::size_t i = 0;
+
+        for (; i + VN <= N; i += VN) {
+            auto const vr = normalize<T, V>(load_columns<V>(ca, i));
+            for (std::size_t k = 0; k < C; ++k) {
+                store<V>(cr[k] + i, vr[k]);
+            }
+        }
+        for (; i < N; i++) {
+            auto const sr = normalize(gather_columns(ca, i));
+            for (std::size_t k = 0; k < C; ++k) {
+                cr[k][i] = sr[k];
+            }
+        }
+        return result;
+    }
+
+    template<std::size_t N, typename T>
+    requires (geometry_fields<T, T, T>)
+    soa<N, T, T, T> cross(soa<N, T, T, T> const& a, soa<N, T, T, T> const& b)
+    {
+        using V = native_register<T>;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        auto const ca = columns(a);
+        auto const cb = columns(b);
+        soa<N, T, T, T> result;
+        auto const cr = columns(result);
+        std::size_t i = 0;
+
+        for (; i + VN <= N; i += VN) {
+            auto const vr = cross<T, V>(load_columns<V>(ca, i), load_columns<V>(cb, i));
+            for (std::size_t k = 0; k < 3; ++k) {
+                store<V>(cr[k] + i, vr[k]);
+            }
+        }
+        for (; i < N; i++) {
+            auto const sr = cross(gather_columns(ca, i), gather_columns(cb, i));
+            for (std::size_t k = 0; k < 3; ++k) {
+                cr[k][i] = sr[k];
+            }
+        }
+        return result;
+    }
+
+//-----------------------------------------------------------------------------
+//  array of structs
+//-----------------------------------------------------------------------------
+#ifdef __AVX2__
+    template<std::size_t C>
+    std::array<__m256, C> load_aos(float const* p) {
+        if constexpr (C == 3) { return load_aos3(p); }
+        else                  { return load_aos4(p); }
+    }
+
+    template<std::size_t C>
+    void store_aos(float* p, std::array<__m256, C> const& c) {
+        if constexpr (C == 3) { store_aos3(p, c); }
+        else                  { store_aos4(p, c); }
+    }
+#endif // __AVX2__
+
+    // out[i] = dot(a[i], b[i]) for n vectors of C components stored one after another
+    template<typename T, std::size_t C>
+    requires (std::is_floating_point_v<T> && (C == 3 || C == 4))
+    void dot(std::array<T, C> const* a, std::array<T, C> const* b, T* out, std::size_t const n)
+    {
+        std::size_t i = 0;
+
+        if constexpr (has_aos_transpose<T, C>) {
+            for (; i + 8 <= n; i += 8) {
+                _mm256_storeu_ps(&out[i], dot<T, __m256>(load_aos<C>(a[i].data()), load_aos<C>(b[i].data())));
+            }
+        }
+        for (; i < n; i++) {
+            out[i] = dot(a[i], b[i]);
+        }
+    }
+
+    template<typename T, std::size_t C>
+    requires (std::is_floating_point_v<T> && (C == 3 || C == 4))
+    void length(std::array<T, C> const* a, T* out, std::size_t const n)
+    {
+        std::size_t i = 0;
+
+        if constexpr (has_aos_transpose<T, C>) {
+            for (; i + 8 <= n; i += 8) {
+                auto const va = load_aos<C>(a[i].data());
+                _mm256_storeu_ps(&out[i], _mm256_sqrt_ps(dot<T, __m256>(va, va)));
+            }
+        }
+        for (; i < n; i++) {
+            out[i] = std::sqrt(dot(a[i], a[i]));
+        }
+    }
+
+    // out may be a
+    template<typename T, std::size_t C>
+    requires (std::is_floating_point_v<T> && (C == 3 || C == 4))
+    void normalize(std::array<T, C> const* a, std::array<T, C>* out, std::size_t const n)
+    {
+        std::size_t i = 0;
+
+        if constexpr (has_aos_transpose<T, C>) {
+            for (; i + 8 <= n; i += 8) {
+                store_aos<C>(out[i].data(), normalize<T, __m256>(load_aos<C>(a[i].data())));
+            }
+        }
+        for (; i < n; i++) {
+            out[i] = normalize(a[i]);
+        }
+    }
+
+    // out may be a or b
+    template<typename T>
+    requires (std::is_floating_point_v<T>)
+    void cross(std::array<T, 3> const* a, std::array<T, 3> const* b, std::array<T, 3>* out, std::size_t const n)
+    {
+        std::size_t i = 0;
+
+        if constexpr (has_aos_transpose<T, 3>) {
+            for (; i + 8 <= n; i += 8) {
+                store_aos<3>(out[i].data(), cross<T, __m256>(load_aos<3>(a[i].data()), load_aos<3>(b[i].data())));
+            }
+        }
+        for (; i < n; i++) {
+            out[i] = cross(a[i], b[i]);
+        }
+    }
+
+//-----------------------------------------------------------------------------
+//  mat4
+//-----------------------------------------------------------------------------
+    // column major 4x4 float matrix acting on column vectors, p' = M p, element (r, c) at m[c * 4 + r]
+    struct mat4 {
+        alignas(32) std::array<float, 16> m;
+
+        static constexpr mat4 identity() { return {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}}; }
+
+        constexpr float& operator()(std::size_t const r, std::size_t const c) { return m[(c * 4) + r]; }
+        constexpr float operator()(std::size_t const r, std::size_t const c) const { return m[(c * 4) + r]; }
+
+        __m128 column(std::size_t const c) const { return _mm_load_ps(&m[c * 4]); }
+    };
+
+    // M v as the columns of M scaled by the broadcast elements of v
+    inline std::array<float, 4> operator*(mat4 const& a, std::array<float, 4> const& v) {
+        __m128 acc = _mm_mul_ps(a.column(0), _mm_set1_ps(v[0]));
+        for (std::size_t k = 1; k < 4; ++k) {
+            acc = fmadd<float, __m128>(a.column(k), _mm_set1_ps(v[k]), acc);
+        }
+        std::array<float, 4> result;
+        _mm_storeu_ps(result.data(), acc);
+        return result;
+    }
+
+    // column j of A B is A times column j of B. With AVX two result columns share a register, each lane half
+    // broadcasting its own element of B
+    inline mat4 operator*(mat4 const& a, mat4 const& b) {
+        mat4 result;
+    #ifdef __AVX__
+        __m256 const b01 = _mm256_load_ps(&b.m[0]);
+        __m256 const b23 = _mm256_load_ps(&b.m[8]);
+        __m256 r01 = _mm256_setzero_ps();
+        __m256 r23 = _mm256_setzero_ps();
+        [&]<std::size_t... k>(std::index_sequence<k...>) {
+            ([&] {
+                __m256 const ak = _mm256_broadcast_ps((__m128 const*)&a.m[k * 4]);                        // AVX
+                r01 = fmadd<float, __m256>(ak, _mm256_shuffle_ps(b01, b01, k * 0x55), r01);
+                r23 = fmadd<float, __m256>(ak, _mm256_shuffle_ps(b23, b23, k * 0x55), r23);
+            }(), ...);
+        }(std::make_index_sequence<4>{});
+        _mm256_store_ps(&result.m[0], r01);
+        _mm256_store_ps(&result.m[8], r23);
+    #else
+        for (std::size_t j = 0; j < 4; ++j) {
+            __m128 acc = _mm_mul_ps(a.column(0), _mm_set1_ps(b(0, j)));
+            for (std::size_t k = 1; k < 4; ++k) {
+                acc = fmadd<float, __m128>(a.column(k), _mm_set1_ps(b(k, j)), acc);
+            }
+            _mm_store_ps(&result.m[j * 4], acc);
+        }
+    #endif // __AVX__
+        return result;
+    }
+
+    inline mat4 transpose(mat4 const& a) {
+        __m128 c0 = a.column(0);
+        __m128 c1 = a.column(1);
+        __m128 c2 = a.column(2);
+        __m128 c3 = a.column(3);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        mat4 result;
+        _mm_store_ps(&result.m[0], c0);
+        _mm_store_ps(&result.m[4], c1);
+        _mm_store_ps(&result.m[8], c2);
+        _mm_store_ps(&result.m[12], c3);
+        return result;
+    }
+
+    // 2x2 blocks held row major in a register: A B, adj(A) B and A adj(B)
+    inline __m128 mat2_mul(__m128 const a, __m128 const b) {
+        return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+
+    inline __m128 mat2_adj_mul(__m128 const a, __m128 const b) {
+        return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+
+    inline __m128 mat2_mul_adj(__m128 const a, __m128 const b) {
+        return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+
+    // blockwise inverse from the adjugates of the four 2x2 blocks, no branches and one division. Inverting the
+    // transpose gives the transposed inverse, so the columns go in where the blocks expect rows. A singular matrix
+    // gives infinities or NaNs
+    inline mat4 inverse(mat4 const& m) {
+        __m128 const c0 = m.column(0);
+        __m128 const c1 = m.column(1);
+        __m128 const c2 = m.column(2);
+        __m128 const c3 = m.column(3);
+
+        __m128 const a = _mm_movelh_ps(c0, c1);
+        __m128 const b = _mm_movehl_ps(c1, c0);
+        __m128 const c = _mm_movelh_ps(c2, c3);
+        __m128 const d = _mm_movehl_ps(c3, c2);
+
+        // |A| |B| |C| |D|
+        __m128 const det_sub = _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+            _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+        __m128 const det_a = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 const det_b = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 const det_c = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 const det_d = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m128 const d_c = mat2_adj_mul(d, c);
+        __m128 const a_b = mat2_adj_mul(a, b);
+        __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), mat2_mul(b, d_c));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), mat2_mul(c, a_b));
+        __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), mat2_mul_adj(d, a_b));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), mat2_mul_adj(a, d_c));
+
+        // |M| = |A| |D| + |B| |C| - tr(adj(A) B adj(D) C)
+        __m128 tr = _mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0)));
+        tr = _mm_hadd_ps(tr, tr);                                                                           // SSE3
+        tr = _mm_hadd_ps(tr, tr);                                                                           // SSE3
+        __m128 const det_m = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+        __m128 const inv_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_m);
+
+        x = _mm_mul_ps(x, inv_det);
+        y = _mm_mul_ps(y, inv_det);
+        z = _mm_mul_ps(z, inv_det);
+        w = _mm_mul_ps(w, inv_det);
+
+        mat4 result;
+        _mm_store_ps(&result.m[0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(&result.m[4], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_store_ps(&result.m[8], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(&result.m[12], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+        return result;
+    }
+
+    // out[i] = a[i] b[i] and out[i] = a b[i], for chains of bone transforms. out may be a or b
+    inline void multiply(mat4 const* a, mat4 const* b, mat4* out, std::size_t const n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = a[i] * b[i];
+        }
+    }
+
+    inline void multiply(mat4 const& a, mat4 const* b, mat4* out, std::size_t const n) {
+        mat4 const pinned = a;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = pinned * b[i];
+        }
+    }
+
+//-----------------------------------------------------------------------------
+//  point transforms
+//-----------------------------------------------------------------------------
+#ifdef __AVX512F__
+    using transform_register = __m512;
+#else
+    using transform_register = native_register<float>;
+#endif // __AVX512F__
+
+    // points (x, y, z, 1) through m, divided by the resulting w when Project is set. The matrix elements are
+    // broadcast once and stay in registers, each iteration moves a register of points (8 with AVX2, 16 with AVX512)
+    template<bool Project>
+    void transform_points_kernel(mat4 const& m, std::array<float const*, 3> const& in, std::array<float*, 3> const& out, std::size_t const n)
+    {
+        using V = transform_register;
+        constexpr std::size_t VN = sizeof(V) / sizeof(float);
+        constexpr std::size_t rows = Project ? 4 : 3;
+
+        std::array<std::array<V, 4>, rows> e;
+        for (std::size_t r = 0; r < rows; ++r) {
+            for (std::size_t c = 0; c < 4; ++c) {
+                e[r][c] = set<float, V>(m(r, c));
+            }
+        }
+
+        std::size_t i = 0;
+        for (; i + VN <= n; i += VN) {
+            V const x = load<V>(in[0] + i);
+            V const y = load<V>(in[1] + i);
+            V const z = load<V>(in[2] + i);
+            std::array<V, rows> p;
+            for (std::size_t r = 0; r < rows; ++r) {
+                p[r] = fmadd<float, V>(e[r][0], x, fmadd<float, V>(e[r][1], y, fmadd<float, V>(e[r][2], z, e[r][3])));
+            }
+            for (std::size_t r = 0; r < 3; ++r) {
+                if constexpr (Project) {
+                    store<V>(out[r] + i, div<float, V>(p[r], p[3]));
+                }
+                else {
+                    store<V>(out[r] + i, p[r]);
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            float const x = in[0][i];
+            float const y = in[1][i];
+            float const z = in[2][i];
+            std::array<float, rows> p;
+            for (std::size_t r = 0; r < rows; ++r) {
+                p[r] = m(r, 0) * x + m(r, 1) * y + m(r, 2) * z + m(r, 3);
+            }
+            for (std::size_t r = 0; r < 3; ++r) {
+                out[r][i] = Project ? p[r] / p[3] : p[r];
+            }
+        }
+    }
+
+    // the full homogeneous transform: x, y and z are divided by w = m(3, 0) x + m(3, 1) y + m(3, 2) z + m(3, 3), so
+    // projections work. For an affine m, w is 1 and the result equals transform_points_affine
+    inline void transform_points(mat4 const& m, std::array<float const*, 3> const& in, std::array<float*, 3> const& out, std::size_t const n)
+    {
+        transform_points_kernel<true>(m, in, out, n);
+    }
+
+    // only the upper 3x4 of m is applied and the bottom row is taken to be (0, 0, 0, 1), which saves the fourth row
+    // and the divides
+    inline void transform_points_affine(mat4 const& m, std::array<float const*, 3> const& in, std::array<float*, 3> const& out, std::size_t const n)
+    {
+        transform_points_kernel<false>(m, in, out, n);
+    }
+
+    // out may be points
+    template<std::size_t N>
+    void transform_points(mat4 const& m, soa<N, float, float, float> const& points, soa<N, float, float, float>& out)
+    {
+        transform_points(m, columns(points), columns(out), N);
+    }
+
+    template<std::size_t N>
+    soa<N, float, float, float> transform_points(mat4 const& m, soa<N, float, float, float> const& points)
+    {
+        soa<N, float, float, float> result;
+        transform_points(m, points, result);
+        return result;
+    }
+
+    template<std::size_t N>
+    void transform_points_affine(mat4 const& m, soa<N, float, float, float> const& points, soa<N, float, float, float>& out)
+    {
+        transform_points_affine(m, columns(points), columns(out), N);
+    }
+
+    template<std::size_t N>
+    soa<N, float, float, float> transform_points_affine(mat4 const& m, soa<N, float, float, float> const& points)
+    {
+        soa<N, float, float, float> result;
+        transform_points_affine(m, points, result);
+        return result;
+    }
+}
@@ -0,0 +1,450 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Checksums and hashing of byte buffers. crc32c uses the SSE4.2 crc32 instruction on three streams at once to hide
+ *  its latency, and joins the streams with a carry-less multiply. crc32 (the zlib / ethernet polynomial) has no
+ *  instruction, so 64 byte blocks are folded into four registers with pclmulqdq and Barrett reduced at the end.
+ *  hash64 is a non-cryptographic hash in the style of xxh3: eight 64bit lanes accumulate 32x32 bit products of the
+ *  input xor a key, and are scrambled with a multiply every 1KB.
+ *
+ *  Every function has a table or scalar fallback that gives the same value, and the crc functions continue from a
+ *  previous result, crc32c(b, crc32c(a)) == crc32c(a followed by b).
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <immintrin.h>
+
+#include "simd_vector.hpp"
+
+namespace simd {
+//-----------------------------------------------------------------------------
+//  crc arithmetic
+//-----------------------------------------------------------------------------
+    // the reflected polynomials, bit 31 is the coefficient of x^0
+    constexpr std::uint32_t crc32_polynomial = 0xEDB88320u;
+    constexpr std::uint32_t crc32c_polynomial = 0x82F63B78u;
+
+    // x^n mod p, one multiply by x at a time, only evaluated at compile time
+    constexpr std::uint32_t crc_xpow(std::uint64_t n, std::uint32_t const poly)
+    {
+        std::uint32_t p = 0x80000000u;
+        for (; n != 0; --n) {
+            p = (p & 1) ? (p >> 1) ^ poly : p >> 1;
+        }
+        return p;
+    }
+
+    // a b mod p
+    constexpr std::uint32_t crc_multiply(std::uint32_t const a, std::uint32_t b, std::uint32_t const poly)
+    {
+        std::uint32_t p = 0;
+        for (std::uint32_t m = 0x80000000u; m != 0; m >>= 1) {
+            if (a & m) {
+                p ^= b;
+            }
+            b = (b & 1) ? (b >> 1) ^ poly : b >> 1;
+        }
+        return p;
+    }
+
+    template<std::uint32_t Poly>
+    constexpr std::array<std::uint32_t, 256> crc_table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (c >> 1) ^ Poly : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    // the byte at a time update, for tails and when the instructions are missing
+    template<std::uint32_t Poly>
+    std::uint32_t crc_bytes(std::uint8_t const* p, std::size_t const n, std::uint32_t c)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            c = crc_table<Poly>[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+        }
+        return c;
+    }
+
+//-----------------------------------------------------------------------------
+//  crc32c
+//-----------------------------------------------------------------------------
+#ifdef __SSE4_2__
+    // the register of a crc32c stream followed by Bytes zero bytes
+    template<std::size_t Bytes>
+    std::uint64_t crc32c_shift(std::uint64_t const c)
+    {
+    #ifdef __PCLMUL__
+        // the product c k is 63 bits, reading it as 64 bits and the crc32 instruction each multiply by x^32 or x
+        static constexpr std::uint32_t k = crc_xpow((Bytes * 8) - 33, crc32c_polynomial);
+        __m128i const prod = _mm_clmulepi64_si128(_mm_cvtsi32_si128(static_cast<int>(c)), _mm_cvtsi32_si128(static_cast<int>(k)), 0x00); // PCLMUL
+        return _mm_crc32_u64(0, static_cast<std::uint64_t>(_mm_cvtsi128_si64(prod))); // SSE4.2
+    #else
+        static constexpr std::uint32_t k = crc_xpow(Bytes * 8, crc32c_polynomial);
+        return crc_multiply(static_cast<std::uint32_t>(c), k, crc32c_polynomial);
+    #endif // __PCLMUL__
+    }
+
+    // blocks of three streams of Stride bytes. Stream 0 carries the crc so far and the others start from zero, the
+    // crc instruction has a latency of three so the three updates per iteration run side by side
+    template<std::size_t Stride>
+    std::uint64_t crc32c_streams(std::uint8_t const*& p, std::size_t& n, std::uint64_t c)
+    {
+        for (; n >= Stride * 3; p += Stride * 3, n -= Stride * 3) {
+            std::uint64_t c1 = 0;
+            std::uint64_t c2 = 0;
+            for (std::size_t i = 0; i < Stride; i += 8) {
+                std::uint64_t w0, w1, w2;
+                std::memcpy(&w0, p + i, 8);
+                std::memcpy(&w1, p + Stride + i, 8);
+                std::memcpy(&w2, p + (Stride * 2) + i, 8);
+                c = _mm_crc32_u64(c, w0); // SSE4.2
+                c1 = _mm_crc32_u64(c1, w1); // SSE4.2
+                c2 = _mm_crc32_u64(c2, w2); // SSE4.2
+            }
+            c = crc32c_shift<Stride * 2>(c) ^ crc32c_shift<Stride>(c1) ^ c2;
+        }
+        return c;
+    }
+#endif // __SSE4_2__
+
+    // crc32c (Castagnoli), as used by iSCSI, ext4 and SSE4.2
+    inline std::uint32_t crc32c(std::uint8_t const* p, std::size_t n, std::uint32_t const crc = 0)
+    {
+    #ifdef __SSE4_2__
+        std::uint64_t c = ~crc;
+        c = crc32c_streams<4096>(p, n, c);
+        c = crc32c_streams<256>(p, n, c);
+        for (; n >= 8; p += 8, n -= 8) {
+            std::uint64_t w;
+            std::memcpy(&w, p, 8);
+            c = _mm_crc32_u64(c, w); // SSE4.2
+        }
+        for (; n > 0; ++p, --n) {
+            c = _mm_crc32_u8(static_cast<std::uint32_t>(c), *p); // SSE4.2
+        }
+        return ~static_cast<std::uint32_t>(c);
+    #else
+        return ~crc_bytes<crc32c_polynomial>(p, n, ~crc);
+    #endif // __SSE4_2__
+    }
+
+//-----------------------------------------------------------------------------
+//  crc32
+//-----------------------------------------------------------------------------
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+    // folds n bytes, at least 64 and a multiple of 16, into the crc register. The constants are x^(512 +- 32),
+    // x^(128 +- 32) and x^64 mod p, and floor(x^64 / p) for the reduction, see Gopal et al. "Fast CRC computation for
+    // generic polynomials using PCLMULQDQ instruction"
+    inline std::uint32_t crc32_fold(std::uint8_t const* p, std::size_t n, std::uint32_t const c)
+    {
+        __m128i const k1k2 = _mm_set_epi64x(0x01C6E41596, 0x0154442BD4);
+        __m128i const k3k4 = _mm_set_epi64x(0x00CCAA009E, 0x01751997D0);
+        __m128i const k5 = _mm_set_epi64x(0, 0x0163CD6124);
+        __m128i const poly = _mm_set_epi64x(0x01F7011641, 0x01DB710641);
+        __m128i const low32 = _mm_setr_epi32(-1, 0, -1, 0);
+
+        // the first 16 bytes are xored with the register so far and folding carries it through
+        std::array<__m128i, 4> x;
+        for (std::size_t r = 0; r < 4; ++r) {
+            x[r] = _mm_loadu_si128((__m128i const*)(p + (r * 16))); // SSE2
+        }
+        x[0] = _mm_xor_si128(x[0], _mm_cvtsi32_si128(static_cast<int>(c)));
+        p += 64;
+        n -= 64;
+
+        // each register is multiplied forward by 512 bits and the next block added in
+        auto const fold = [](__m128i const a, __m128i const k, __m128i const next) {
+            __m128i const lo = _mm_clmulepi64_si128(a, k, 0x00); // PCLMUL
+            __m128i const hi = _mm_clmulepi64_si128(a, k, 0x11); // PCLMUL
+            return _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+        };
+        for (; n >= 64; p += 64, n -= 64) {
+            for (std::size_t r = 0; r < 4; ++r) {
+                x[r] = fold(x[r], k1k2, _mm_loadu_si128((__m128i const*)(p + (r * 16))));
+            }
+        }
+
+        // four registers to one, then whatever 16 byte blocks are left
+        __m128i a = fold(x[0], k3k4, x[1]);
+        a = fold(a, k3k4, x[2]);
+        a = fold(a, k3k4, x[3]);
+        for (; n >= 16; p += 16, n -= 16) {
+            a = fold(a, k3k4, _mm_loadu_si128((__m128i const*)p));
+        }
+
+        // 128 bits to 64, to 32 plus the 32 to reduce, then Barrett reduction
+        a = _mm_xor_si128(_mm_srli_si128(a, 8), _mm_clmulepi64_si128(a, k3k4, 0x10)); // PCLMUL
+        a = _mm_xor_si128(_mm_srli_si128(a, 4), _mm_clmulepi64_si128(_mm_and_si128(a, low32), k5, 0x00)); // PCLMUL
+        __m128i t = _mm_clmulepi64_si128(_mm_and_si128(a, low32), poly, 0x10); // PCLMUL
+        t = _mm_clmulepi64_si128(_mm_and_si128(t, low32), poly, 0x00); // PCLMUL
+        return static_cast<std::uint32_t>(_mm_extract_epi32(_mm_xor_si128(a, t), 1)); // SSE4.1
+    }
+#endif // __PCLMUL__ && __SSE4_1__
+
+    // crc32 as computed by zlib, gzip, png and ethernet
+    inline std::uint32_t crc32(std::uint8_t const* p, std::size_t n, std::uint32_t const crc = 0)
+    {
+        std::uint32_t c = ~crc;
+    #if defined(__PCLMUL__) && defined(__SSE4_1__)
+        if (n >= 64) {
+            std::size_t const m = n & ~std::size_t(15);
+            c = crc32_fold(p, m, c);
+            p += m;
+            n -= m;
+        }
+    #endif // __PCLMUL__ && __SSE4_1__
+        return ~crc_bytes<crc32_polynomial>(p, n, c);
+    }
+
+//-----------------------------------------------------------------------------
+//  hash64
+//-----------------------------------------------------------------------------
+    // 64 byte stripes of eight lanes, 16 stripes to a block between scrambles
+    constexpr std::size_t hash_stripe = 64;
+    constexpr std::size_t hash_block = hash_stripe * 16;
+
+    // stripe s of a block uses key words [s, s + 8), the last stripe [16, 24), the scramble [24, 32) and the final
+    // merge [8, 16). The short inputs use [0, 16)
+    constexpr std::array<std::uint64_t, 32> hash_key = [] {
+        std::array<std::uint64_t, 32> k{};
+        std::uint64_t s = 0;
+        for (auto& w : k) {
+            s += 0x9E3779B97F4A7C15ull;
+            std::uint64_t z = s;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            w = z ^ (z >> 31);
+        }
+        return k;
+    }();
+
+    constexpr std::uint64_t hash_prime64 = 0x9E3779B185EBCA87ull;
+    constexpr std::uint32_t hash_prime32 = 0x9E3779B1u;
+
+    inline std::uint64_t hash_read64(std::uint8_t const* p)
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        return w;
+    }
+
+    inline std::uint64_t hash_read32(std::uint8_t const* p)
+    {
+        std::uint32_t w;
+        std::memcpy(&w, p, 4);
+        return w;
+    }
+
+    // the 128bit product folded to 64 bits
+    inline std::uint64_t hash_fold(std::uint64_t const a, std::uint64_t const b)
+    {
+        unsigned __int128 const m = static_cast<unsigned __int128>(a) * b;
+        return static_cast<std::uint64_t>(m) ^ static_cast<std::uint64_t>(m >> 64);
+    }
+
+    inline std::uint64_t hash_avalanche(std::uint64_t h)
+    {
+        h ^= h >> 37;
+        h *= 0x165667919E3779F9ull;
+        return h ^ (h >> 32);
+    }
+
+    inline std::uint64_t hash_mix16(std::uint8_t const* p, std::uint64_t const* k)
+    {
+        return hash_fold(hash_read64(p) ^ k[0], hash_read64(p + 8) ^ k[1]);
+    }
+
+    // the stripe and scramble steps on eight lanes. The data words are added to the neighbouring lane so no input
+    // bit is lost when a product is zero
+#ifdef __AVX2__
+    struct hash_lanes {
+        std::array<__m256i, 2> acc;
+
+        void stripe(std::uint8_t const* p, std::uint64_t const* k)
+        {
+            for (std::size_t r = 0; r < 2; ++r) {
+                __m256i const d = _mm256_loadu_si256((__m256i const*)(p + (r * 32))); // AVX
+                __m256i const dk = _mm256_xor_si256(d, _mm256_loadu_si256((__m256i const*)(k + (r * 4)))); // AVX2
+                __m256i const prod = _mm256_mul_epu32(dk, _mm256_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1))); // AVX2
+                __m256i const swap = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)); // AVX2
+                acc[r] = _mm256_add_epi64(acc[r], _mm256_add_epi64(prod, swap)); // AVX2
+            }
+        }
+
+        void scramble(std::uint64_t const* k)
+        {
+            __m256i const prime = _mm256_set1_epi32(static_cast<int>(hash_prime32)); // AVX
+            for (std::size_t r = 0; r < 2; ++r) {
+                __m256i a = _mm256_xor_si256(acc[r], _mm256_srli_epi64(acc[r], 47)); // AVX2
+                a = _mm256_xor_si256(a, _mm256_loadu_si256((__m256i const*)(k + (r * 4)))); // AVX2
+                // 64 x 32 bit multiply from the two 32 x 32 bit halves
+                __m256i const lo = _mm256_mul_epu32(a, prime); // AVX2
+                __m256i const hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime); // AVX2
+                acc[r] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)); // AVX2
+            }
+        }
+
+        std::array<std::uint64_t, 8> words() const
+        {
+            alignas(32) std::array<std::uint64_t, 8> w;
+            _mm256_store_si256((__m256i*)&w[0], acc[0]); // AVX
+            _mm256_store_si256((__m256i*)&w[4], acc[1]); // AVX
+            return w;
+        }
+    };
+#else
+    struct hash_lanes {
+        std::array<std::uint64_t, 8> acc;
+
+        void stripe(std::uint8_t const* p, std::uint64_t const* k)
+        {
+            for (std::size_t i = 0; i < 8; ++i) {
+                std::uint64_t const d = hash_read64(p + (i * 8));
+                std::uint64_t const dk = d ^ k[i];
+                acc[i ^ 1] += d;
+                acc[i] += (dk & 0xFFFFFFFFu) * (dk >> 32);
+            }
+        }
+
+        void scramble(std::uint64_t const* k)
+        {
+            for (std::size_t i = 0; i < 8; ++i) {
+                acc[i] = (acc[i] ^ (acc[i] >> 47) ^ k[i]) * hash_prime32;
+            }
+        }
+
+        std::array<std::uint64_t, 8> words() const { return acc; }
+    };
+#endif // __AVX2__
+
+    inline std::uint64_t hash64_long(std::uint8_t const* p, std::size_t const n, std::uint64_t const* key)
+    {
+        hash_lanes lanes;
+        alignas(32) std::array<std::uint64_t, 8> const init = {key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7]};
+        std::memcpy(&lanes.acc, init.data(), sizeof(init));
+
+        // the last stripe is always hashed on its own, overlapping the stripes before it when n is not a multiple
+        std::size_t const blocks = (n - 1) / hash_block;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            std::uint8_t const* const block = p + (b * hash_block);
+            for (std::size_t s = 0; s < hash_block / hash_stripe; ++s) {
+                lanes.stripe(block + (s * hash_stripe), key + s);
+            }
+            lanes.scramble(key + 24);
+        }
+        std::size_t const stripes = ((n - 1) - (blocks * hash_block)) / hash_stripe;
+        for (std::size_t s = 0; s < stripes; ++s) {
+            lanes.stripe(p + (blocks * hash_block) + (s * hash_stripe), key + s);
+        }
+        lanes.stripe(p + n - hash_stripe, key + 16);
+
+        auto const acc = lanes.words();
+        std::uint64_t h = n * hash_prime64;
+        for (std::size_t i = 0; i < 8; i += 2) {
+            h += hash_fold(acc[i] ^ key[8 + i], acc[i + 1] ^ key[9 + i]);
+        }
+        return hash_avalanche(h);
+    }
+
+    // 64bit hash of n bytes. It is not cryptographic, only fast and well mixed, and different seeds give unrelated
+    // functions
+    inline std::uint64_t hash64(std::uint8_t const* p, std::size_t const n, std::uint64_t const seed = 0)
+    {
+        std::array<std::uint64_t, 32> key = hash_key;
+        if (seed != 0) {
+            for (std::size_t i = 0; i < key.size(); i += 2) {
+                key[i] += seed;
+                key[i + 1] -= seed;
+            }
+        }
+
+        if (n > 128) {
+            return hash64_long(p, n, key.data());
+        }
+        std::uint64_t h = n * hash_prime64;
+        if (n > 16) {
+            // pairs of 16 bytes from the front and the back, which overlap in the middle
+            for (std::size_t i = 0; i < ((n - 1) / 32) + 1; ++i) {
+                h += hash_mix16(p + (i * 16), &key[i * 4]);
+                h += hash_mix16(p + n - ((i + 1) * 16), &key[(i * 4) + 2]);
+            }
+        }
+        else {
+            std::uint64_t lo = 0;
+            std::uint64_t hi = 0;
+            if (n >= 8) {
+                lo = hash_read64(p);
+                hi = hash_read64(p + n - 8);
+            }
+            else if (n >= 4) {
+                lo = hash_read32(p) | (hash_read32(p + n - 4) << 32);
+            }
+            else if (n > 0) {
+                lo = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[n >> 1]) << 8) | p[n - 1];
+            }
+            h += hash_fold(lo ^ key[0], hi ^ key[1]);
+        }
+        return hash_avalanche(h);
+    }
+
+//-----------------------------------------------------------------------------
+//  spans and vectors
+//-----------------------------------------------------------------------------
+    inline std::uint32_t crc32c(std::span<std::uint8_t const> const data, std::uint32_t const crc = 0)
+    {
+        return crc32c(data.data(), data.size(), crc);
+    }
+
+    inline std::uint32_t crc32c(std::span<std::byte const> const data, std::uint32_t const crc = 0)
+    {
+        return crc32c(reinterpret_cast<std::uint8_t const*>(data.data()), data.size(), crc);
+    }
+
+    template<std::size_t N, typename Cont>
+    std::uint32_t crc32c(vector<std::uint8_t, N, Cont> const& v, std::uint32_t const crc = 0)
+    {
+        return crc32c(&v[0], N, crc);
+    }
+
+    inline std::uint32_t crc32(std::span<std::uint8_t const> const data, std::uint32_t const crc = 0)
+    {
+        return crc32(data.data(), data.size(), crc);
+    }
+
+    inline std::uint32_t crc32(std::span<std::byte const> const data, std::uint32_t const crc = 0)
+    {
+        return crc32(reinterpret_cast<std::uint8_t const*>(data.data()), data.size(), crc);
+    }
+
+    template<std::size_t N, typename Cont>
+    std::uint32_t crc32(vector<std::uint8_t, N, Cont> const& v, std::uint32_t const crc = 0)
+    {
+        return crc32(&v[0], N, crc);
+    }
+
+    inline std::uint64_t hash64(std::span<std::uint8_t const> const data, std::uint64_t const seed = 0)
+    {
+        return hash64(data.data(), data.size(), seed);
+    }
+
+    inline std::uint64_t hash64(std::span<std::byte const> const data, std::uint64_t const seed = 0)
+    {
+        return hash64(reinterpret_cast<std::uint8_t const*>(data.data()), data.size(), seed);
+    }
+
+    template<std::size_t N, typename Cont>
+    std::uint64_t hash64(vector<std::uint8_t, N, Cont> const& v, std::uint64_t const seed = 0)
+    {
+        return hash64(&v[0], N, seed);
+    }
+}
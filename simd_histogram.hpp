@@ -0,0 +1,167 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Histograms of small integer (uint8_t/uint16_t) vectors. A handful of bins is counted by comparing whole registers
+ *  against every bin. Larger bin counts interleave several sub-histograms so consecutive increments of the same bin
+ *  do not wait on each other's stores, and tables too big for that use AVX512 conflict detection when available.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    // bin counts up to this are counted with one register compare per bin
+    constexpr std::size_t histogram_compare_bins = 8;
+
+    // bucketed compare: each bin keeps a register of per lane counters which wrap after max(T) registers, so they
+    // are flushed into the 32bit bins before that
+    template<typename V, typename T, std::size_t N, std::size_t Bins>
+    inline void histogram_compare(T const* data, std::uint32_t* bins)
+    {
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        constexpr std::size_t flush = std::numeric_limits<T>::max();
+        std::size_t i = 0;
+
+        while (i + VN <= N) {
+            std::array<V, Bins> acc;
+            for (std::size_t b = 0; b < Bins; ++b) {
+                acc[b] = set<T, V>(T(0));
+            }
+
+            for (std::size_t r = 0; r < flush && i + VN <= N; ++r, i += VN) {
+                V const x = load<V>(&data[i]);
+                for (std::size_t b = 0; b < Bins; ++b) {
+                    acc[b] = sub<T, V>(acc[b], cmpeq<T, V>(x, set<T, V>(T(b)))); // a match is all ones, i.e. -1
+                }
+            }
+
+            alignas(64) std::array<T, VN> lanes;
+            for (std::size_t b = 0; b < Bins; ++b) {
+                store<V>(lanes.data(), acc[b]);
+                for (std::size_t l = 0; l < VN; ++l) {
+                    bins[b] += lanes[l];
+                }
+            }
+        }
+
+        for (; i < N; i++) {
+            if (data[i] < Bins) {
+                bins[data[i]]++;
+            }
+        }
+    }
+
+#if defined(__AVX512F__) && defined(__AVX512CD__)
+    // conflict detection: 16 values are widened to 32bit indices, every lane learns how many earlier lanes hold the
+    // same value, and the scatter of the gathered count plus that total lets the last duplicate lane win
+    template<typename T, std::size_t N, std::size_t Bins>
+    inline void histogram_conflict(T const* data, std::uint32_t* bins)
+    {
+        __m512i const one = _mm512_set1_epi32(1);
+        __m512i const limit = _mm512_set1_epi32(static_cast<int>(std::min<std::size_t>(Bins, std::numeric_limits<std::int32_t>::max())));
+        std::size_t i = 0;
+
+        for (; i + 16 <= N; i += 16) {
+            // zero masked widening, the unmasked form has an undefined source that GCC warns about
+            __m512i idx;
+            if constexpr (std::is_same_v<T, std::uint8_t>) { idx = _mm512_maskz_cvtepu8_epi32(0xFFFF, _mm_loadu_si128((__m128i_u*)&data[i])); }    // AVX512F
+            else                                           { idx = _mm512_maskz_cvtepu16_epi32(0xFFFF, _mm256_loadu_si256((__m256i_u*)&data[i])); } // AVX512F
+
+            __mmask16 const in_range = _mm512_cmplt_epi32_mask(idx, limit);
+            __m512i const count = _mm512_add_epi32(simd_popcnt_epi32(_mm512_conflict_epi32(idx)), one);
+            __m512i const old = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), in_range, idx, bins, 4);
+            _mm512_mask_i32scatter_epi32(bins, in_range, idx, _mm512_add_epi32(old, count), 4);
+        }
+
+        for (; i < N; i++) {
+            if (data[i] < Bins) {
+                bins[data[i]]++;
+            }
+        }
+    }
+#endif // __AVX512F__ && __AVX512CD__
+
+    // sub-histogram tables hold every value below Bins plus a discarded slot for the out of range values
+    template<typename T, std::size_t Bins>
+    constexpr std::size_t histogram_slots = std::min<std::size_t>(Bins, std::size_t(std::numeric_limits<T>::max()) + 1) + 1;
+
+    // the sub-histograms live on the stack, bigger tables (a full uint16_t range) go through conflict detection
+    constexpr std::size_t histogram_interleave = 4;
+    constexpr std::size_t histogram_interleave_bytes = 64 * 1024;
+
+    // sub-histograms: consecutive values go to different tables so their increments are independent
+    template<typename T, std::size_t N, std::size_t Bins>
+    inline void histogram_interleaved(T const* data, std::uint32_t* bins)
+    {
+        constexpr std::size_t slots = histogram_slots<T, Bins>;
+        std::array<std::array<std::uint32_t, slots>, histogram_interleave> sub{};
+        std::size_t i = 0;
+
+        auto slot = [](T const x) { return std::min<std::size_t>(x, slots - 1); };
+        for (; i + 4 <= N; i += 4) {
+            sub[0][slot(data[i])]++;
+            sub[1][slot(data[i + 1])]++;
+            sub[2][slot(data[i + 2])]++;
+            sub[3][slot(data[i + 3])]++;
+        }
+        if constexpr (N % 4 != 0) {
+            for (; i < N; i++) {
+                sub[0][slot(data[i])]++;
+            }
+        }
+
+        for (std::size_t b = 0; b < slots - 1; ++b) {
+            bins[b] += sub[0][b] + sub[1][b] + sub[2][b] + sub[3][b];
+        }
+    }
+
+//-----------------------------------------------------------------------------
+//  histogram / bincount
+//-----------------------------------------------------------------------------
+    // add the number of occurrences of each value below Bins to bins, larger values are ignored
+    template <typename T, std::size_t N, typename Cont, std::size_t Bins, typename BinsCont>
+    requires (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::uint16_t>)
+    void histogram(vector<T, N, Cont> const& v, vector<std::uint32_t, Bins, BinsCont>& bins)
+    {
+        T const* const data = &v[0];
+
+        if constexpr (Bins <= histogram_compare_bins) {
+            histogram_compare<typename vector<T, N, Cont>::vreg, T, N, Bins>(data, &bins[0]);
+        }
+        else if constexpr (histogram_interleave * histogram_slots<T, Bins> * sizeof(std::uint32_t) <= histogram_interleave_bytes) {
+            histogram_interleaved<T, N, Bins>(data, &bins[0]);
+        }
+        else {
+        #if defined(__AVX512F__) && defined(__AVX512CD__)
+            histogram_conflict<T, N, Bins>(data, &bins[0]);
+        #else
+            for (std::size_t i = 0; i < N; i++) {
+                if (data[i] < Bins) {
+                    bins[data[i]]++;
+                }
+            }
+        #endif // __AVX512F__ && __AVX512CD__
+        }
+    }
+
+    // number of occurrences of each value below Bins, held by the same storage policy as v. An inline table of a
+    // full uint16_t range is 256KB, so count inline vectors with many bins through histogram() into a heap vector
+    template <std::size_t Bins, typename T, std::size_t N, typename Cont>
+    requires (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::uint16_t>)
+    vector<std::uint32_t, Bins, rebind_storage_t<Cont, std::uint32_t, Bins>> bincount(vector<T, N, Cont> const& v)
+    {
+        vector<std::uint32_t, Bins, rebind_storage_t<Cont, std::uint32_t, Bins>> bins;
+        std::fill(bins.begin(), bins.end(), std::uint32_t(0));
+        histogram(v, bins);
+        return bins;
+    }
+}
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <immintrin.h>
@@ -240,12 +241,20 @@ namespace simd {
         return _mm256_loadu_si256((__m256i *)ui8a.data());
     }
 
+    // widened to 32-bit floats, a 16-bit quotient is never within float rounding of the next integer so truncating
+    // the float division is exact
     inline __m128i simd_div_ui16(__m128i const& a, __m128i const& b) {
-        return a;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 lo = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero)), _mm_cvtepi32_ps(_mm_unpacklo_epi16(b, zero)));
+        const __m128 hi = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero)), _mm_cvtepi32_ps(_mm_unpackhi_epi16(b, zero)));
+        return _mm_packus_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi)); // SSE4.1
     }
 
     inline __m256i simd_div_ui16(__m256i const& a, __m256i const& b) {
-        return a;
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256 lo = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(a, zero)), _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(b, zero)));
+        const __m256 hi = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(a, zero)), _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(b, zero)));
+        return _mm256_packus_epi32(_mm256_cvttps_epi32(lo), _mm256_cvttps_epi32(hi)); // the unpacks and the pack are both per lane
     }
 
     inline __m128i simd_div_si16(__m128i const& a, __m128i const& b) {
@@ -372,4 +381,251 @@ namespace simd {
         // Convert back to integers
         return _mm256_cvttps_epi32(f);
     }
+
+//-----------------------------------------------------------------------------
+//  minimum/maximum instructions
+//-----------------------------------------------------------------------------
+    inline __m128i simd_min_si64(__m128i const& a, __m128i const& b) {
+    #ifdef __AVX512VL__
+        return _mm_min_epi64(a, b);
+    #else // SSE4.2
+        return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b));
+    #endif // __AVX512VL__
+    }
+
+    inline __m256i simd_min_si64(__m256i const& a, __m256i const& b) {
+    #ifdef __AVX512VL__
+        return _mm256_min_epi64(a, b);
+    #else // AVX2
+        return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    #endif // __AVX512VL__
+    }
+
+    inline __m128i simd_max_si64(__m128i const& a, __m128i const& b) {
+    #ifdef __AVX512VL__
+        return _mm_max_epi64(a, b);
+    #else // SSE4.2
+        return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b));
+    #endif // __AVX512VL__
+    }
+
+    inline __m256i simd_max_si64(__m256i const& a, __m256i const& b) {
+    #ifdef __AVX512VL__
+        return _mm256_max_epi64(a, b);
+    #else // AVX2
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+    #endif // __AVX512VL__
+    }
+
+    // no unsigned 64bit compare before AVX512 - flip the sign bits and use the signed compare
+    inline __m128i simd_min_ui64(__m128i const& a, __m128i const& b) {
+    #ifdef __AVX512VL__
+        return _mm_min_epu64(a, b);
+    #else // SSE4.2
+        const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+        return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign)));
+    #endif // __AVX512VL__
+    }
+
+    inline __m256i simd_min_ui64(__m256i const& a, __m256i const& b) {
+    #ifdef __AVX512VL__
+        return _mm256_min_epu64(a, b);
+    #else // AVX2
+        const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+        return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign)));
+    #endif // __AVX512VL__
+    }
+
+    inline __m128i simd_max_ui64(__m128i const& a, __m128i const& b) {
+    #ifdef __AVX512VL__
+        return _mm_max_epu64(a, b);
+    #else // SSE4.2
+        const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+        return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign)));
+    #endif // __AVX512VL__
+    }
+
+    inline __m256i simd_max_ui64(__m256i const& a, __m256i const& b) {
+    #ifdef __AVX512VL__
+        return _mm256_max_epu64(a, b);
+    #else // AVX2
+        const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign)));
+    #endif // __AVX512VL__
+    }
+
+//-----------------------------------------------------------------------------
+//  comparison instructions
+//-----------------------------------------------------------------------------
+    // there is no unsigned greater than - flip the sign bits and use the signed compare
+    inline __m128i simd_cmpgt_epu8(__m128i const& a, __m128i const& b) {
+        const __m128i sign = _mm_set1_epi8(INT8_MIN);
+        return _mm_cmpgt_epi8(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+    }
+
+    inline __m256i simd_cmpgt_epu8(__m256i const& a, __m256i const& b) {
+        const __m256i sign = _mm256_set1_epi8(INT8_MIN);
+        return _mm256_cmpgt_epi8(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    }
+
+    inline __m128i simd_cmpgt_epu16(__m128i const& a, __m128i const& b) {
+        const __m128i sign = _mm_set1_epi16(INT16_MIN);
+        return _mm_cmpgt_epi16(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+    }
+
+    inline __m256i simd_cmpgt_epu16(__m256i const& a, __m256i const& b) {
+        const __m256i sign = _mm256_set1_epi16(INT16_MIN);
+        return _mm256_cmpgt_epi16(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    }
+
+    inline __m128i simd_cmpgt_epu32(__m128i const& a, __m128i const& b) {
+        const __m128i sign = _mm_set1_epi32(INT32_MIN);
+        return _mm_cmpgt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+    }
+
+    inline __m256i simd_cmpgt_epu32(__m256i const& a, __m256i const& b) {
+        const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+        return _mm256_cmpgt_epi32(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    }
+
+    inline __m128i simd_cmpgt_epu64(__m128i const& a, __m128i const& b) {
+        const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+        return _mm_cmpgt_epi64(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+    }
+
+    inline __m256i simd_cmpgt_epu64(__m256i const& a, __m256i const& b) {
+        const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+        return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    }
+
+//-----------------------------------------------------------------------------
+//  population count instructions
+//-----------------------------------------------------------------------------
+#ifdef __AVX512F__
+    inline __m512i simd_popcnt_epi32(__m512i const& a) {
+    #ifdef __AVX512VPOPCNTDQ__
+        return _mm512_popcnt_epi32(a);
+    #else // AVX512F
+        // bit counts of pairs, nibbles then bytes, summed into the top byte by the multiply
+        __m512i x = _mm512_sub_epi32(a, _mm512_and_si512(_mm512_srli_epi32(a, 1), _mm512_set1_epi32(0x55555555)));
+        x = _mm512_add_epi32(_mm512_and_si512(x, _mm512_set1_epi32(0x33333333)), _mm512_and_si512(_mm512_srli_epi32(x, 2), _mm512_set1_epi32(0x33333333)));
+        x = _mm512_and_si512(_mm512_add_epi32(x, _mm512_srli_epi32(x, 4)), _mm512_set1_epi32(0x0F0F0F0F));
+        return _mm512_srli_epi32(_mm512_mullo_epi32(x, _mm512_set1_epi32(0x01010101)), 24);
+    #endif // __AVX512VPOPCNTDQ__
+    }
+#endif // __AVX512F__
+
+//-----------------------------------------------------------------------------
+//  bfloat16 conversion instructions
+//-----------------------------------------------------------------------------
+#ifdef __AVX2__
+    // bf16 is the top half of a float, so widening is a shift into the high 16 bits
+    inline __m256 simd_cvtbf16_ps(__m128i const& a) {
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(a), 16));
+    }
+
+    // round to nearest even, NaNs are kept quiet rather than rounded into infinity
+    inline __m128i simd_cvtps_bf16(__m256 const& a) {
+    #if defined(__AVX512BF16__) && defined(__AVX512VL__)
+        return (__m128i)_mm256_cvtneps_pbh(a);
+    #else
+        const __m256i u = _mm256_castps_si256(a);
+        const __m256i rounded = _mm256_add_epi32(u, _mm256_add_epi32(_mm256_set1_epi32(0x7FFF), _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1))));
+        const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(a, a, _CMP_UNORD_Q));
+        const __m256i bits = _mm256_srli_epi32(_mm256_blendv_epi8(rounded, _mm256_or_si256(u, _mm256_set1_epi32(0x00400000)), nan), 16);
+        const __m256i packed = _mm256_packus_epi32(bits, bits); // per 128bit lane, so the two halves are joined below
+        return _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    #endif // __AVX512BF16__ && __AVX512VL__
+    }
+#endif // __AVX2__
+
+//-----------------------------------------------------------------------------
+//  unsigned to floating point conversion instructions
+//-----------------------------------------------------------------------------
+#ifdef __AVX2__
+    // the high and low 16 bits convert exactly, so the single rounding is in the final add
+    inline __m256 simd_cvtepu32_ps(__m256i const& a) {
+    #ifdef __AVX512VL__
+        return _mm256_cvtepu32_ps(a);
+    #else
+        const __m256 hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(a, 16));
+        const __m256 lo = _mm256_cvtepi32_ps(_mm256_and_si256(a, _mm256_set1_epi32(0xFFFF)));
+        return _mm256_add_ps(_mm256_mul_ps(hi, _mm256_set1_ps(65536.0f)), lo); // the product is exact
+    #endif // __AVX512VL__
+    }
+
+    // flipping the sign bit offsets the value by 2^31, which double holds exactly
+    inline __m256d simd_cvtepu32_pd(__m128i const& a) {
+    #ifdef __AVX512VL__
+        return _mm256_cvtepu32_pd(a);
+    #else
+        const __m256d shifted = _mm256_cvtepi32_pd(_mm_xor_si128(a, _mm_set1_epi32(INT32_MIN)));
+        return _mm256_add_pd(shifted, _mm256_set1_pd(2147483648.0));
+    #endif // __AVX512VL__
+    }
+#endif // __AVX2__
+
+//-----------------------------------------------------------------------------
+//  fixed point instructions
+//-----------------------------------------------------------------------------
+    // pmulhrsw returns INT16_MIN only for INT16_MIN * INT16_MIN, where the true result is out of range
+    inline __m128i simd_mulhrs_sat_epi16(__m128i const& a, __m128i const& b) {
+        const __m128i r = _mm_mulhrs_epi16(a, b); // SSSE3
+        return _mm_xor_si128(r, _mm_cmpeq_epi16(r, _mm_set1_epi16(INT16_MIN)));
+    }
+
+    // there are no saturating 32bit adds: a lane overflowed when the sum's sign differs from both operands, and it
+    // saturates towards the sign of a
+    inline __m128i simd_adds_epi32(__m128i const& a, __m128i const& b) {
+        const __m128i sum = _mm_add_epi32(a, b);
+        const __m128i overflow = _mm_and_si128(_mm_xor_si128(a, sum), _mm_xor_si128(b, sum));
+        const __m128i saturated = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(INT32_MAX));
+        return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(sum), _mm_castsi128_ps(saturated), _mm_castsi128_ps(overflow))); // SSE4.1
+    }
+
+    inline __m128i simd_subs_epi32(__m128i const& a, __m128i const& b) {
+        const __m128i diff = _mm_sub_epi32(a, b);
+        const __m128i overflow = _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, diff));
+        const __m128i saturated = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(INT32_MAX));
+        return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(diff), _mm_castsi128_ps(saturated), _mm_castsi128_ps(overflow))); // SSE4.1
+    }
+
+    // (a b + 2^30) >> 31 from the 64bit products of the even and the odd lanes. Bits 31 to 62 of the rounded product
+    // are the result, shifted down for the even lanes and up for the odd ones
+    inline __m128i simd_mulhrs_sat_epi32(__m128i const& a, __m128i const& b) {
+        const __m128i round = _mm_set1_epi64x(INT64_C(1) << 30);
+        const __m128i even = _mm_add_epi64(_mm_mul_epi32(a, b), round); // SSE4.1
+        const __m128i odd = _mm_add_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), round); // SSE4.1
+        const __m128i r = _mm_blend_epi16(_mm_srli_epi64(even, 31), _mm_slli_epi64(odd, 1), 0xCC); // SSE4.1
+        return _mm_xor_si128(r, _mm_cmpeq_epi32(r, _mm_set1_epi32(INT32_MIN)));
+    }
+
+#ifdef __AVX2__
+    inline __m256i simd_mulhrs_sat_epi16(__m256i const& a, __m256i const& b) {
+        const __m256i r = _mm256_mulhrs_epi16(a, b); // AVX2
+        return _mm256_xor_si256(r, _mm256_cmpeq_epi16(r, _mm256_set1_epi16(INT16_MIN)));
+    }
+
+    inline __m256i simd_adds_epi32(__m256i const& a, __m256i const& b) {
+        const __m256i sum = _mm256_add_epi32(a, b);
+        const __m256i overflow = _mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum));
+        const __m256i saturated = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+        return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(sum), _mm256_castsi256_ps(saturated), _mm256_castsi256_ps(overflow))); // AVX
+    }
+
+    inline __m256i simd_subs_epi32(__m256i const& a, __m256i const& b) {
+        const __m256i diff = _mm256_sub_epi32(a, b);
+        const __m256i overflow = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, diff));
+        const __m256i saturated = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+        return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(diff), _mm256_castsi256_ps(saturated), _mm256_castsi256_ps(overflow))); // AVX
+    }
+
+    inline __m256i simd_mulhrs_sat_epi32(__m256i const& a, __m256i const& b) {
+        const __m256i round = _mm256_set1_epi64x(INT64_C(1) << 30);
+        const __m256i even = _mm256_add_epi64(_mm256_mul_epi32(a, b), round); // AVX2
+        const __m256i odd = _mm256_add_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), round); // AVX2
+        const __m256i r = _mm256_blend_epi32(_mm256_srli_epi64(even, 31), _mm256_slli_epi64(odd, 1), 0xAA); // AVX2
+        return _mm256_xor_si256(r, _mm256_cmpeq_epi32(r, _mm256_set1_epi32(INT32_MIN)));
+    }
+#endif // __AVX2__
 }
@@ -5,12 +5,17 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
 #include <immintrin.h>
 
 #include "simd_intrinsics_alternatives.hpp"
 
 namespace simd {
+    // true for the fixed point element types of simd_fixed.hpp, whose saturating forms are picked here by width
+    template<typename T>
+    constexpr bool is_fixed_v = false;
+
 //-----------------------------------------------------------------------------
 //  load instructions
 //-----------------------------------------------------------------------------
@@ -38,6 +43,20 @@ namespace simd {
     requires (std::is_same_v<V, __m256d>)
     V load(void const* mem_addr) { return _mm256_loadu_pd((double*)mem_addr); }
 
+#ifdef __AVX512F__
+    template<typename V>
+    requires (std::is_same_v<V, __m512i>)
+    V load(void const* mem_addr) { return _mm512_loadu_si512(mem_addr); }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m512>)
+    V load(void const* mem_addr) { return _mm512_loadu_ps(mem_addr); }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m512d>)
+    V load(void const* mem_addr) { return _mm512_loadu_pd(mem_addr); }
+#endif // __AVX512F__
+
 //-----------------------------------------------------------------------------
 //  store instructions
 //-----------------------------------------------------------------------------
@@ -65,6 +84,193 @@ namespace simd {
     requires (std::is_same_v<V, __m256d>)
     void store(void const* mem_addr, V a) { _mm256_storeu_pd((double*)mem_addr, a); }
 
+#ifdef __AVX512F__
+    template<typename V>
+    requires (std::is_same_v<V, __m512i>)
+    void store(void const* mem_addr, V a) { _mm512_storeu_si512((void*)mem_addr, a); }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m512>)
+    void store(void const* mem_addr, V a) { _mm512_storeu_ps((void*)mem_addr, a); }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m512d>)
+    void store(void const* mem_addr, V a) { _mm512_storeu_pd((void*)mem_addr, a); }
+#endif // __AVX512F__
+
+//-----------------------------------------------------------------------------
+//  partial load / store instructions
+//-----------------------------------------------------------------------------
+    // the first count lanes of a register, count is less than the lanes in V. Loads fill the other lanes with 1 so
+    // any op, division included, is safe on them. 8 and 16bit lanes need AVX512BW, AVX2 masked moves are 32/64bit
+#if defined(__AVX512VL__) && defined(__AVX512BW__)
+    template<typename T, typename V>
+    constexpr bool has_partial = true;
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        if constexpr (sizeof(T) == 1)      { return _mm_mask_loadu_epi8(_mm_set1_epi8(1), __mmask16((1u << count) - 1), mem_addr); }    // AVX512BW + AVX512VL
+        else if constexpr (sizeof(T) == 2) { return _mm_mask_loadu_epi16(_mm_set1_epi16(1), __mmask8((1u << count) - 1), mem_addr); }  // AVX512BW + AVX512VL
+        else if constexpr (sizeof(T) == 4) { return _mm_mask_loadu_epi32(_mm_set1_epi32(1), __mmask8((1u << count) - 1), mem_addr); }  // AVX512F + AVX512VL
+        else                               { return _mm_mask_loadu_epi64(_mm_set1_epi64x(1), __mmask8((1u << count) - 1), mem_addr); } // AVX512F + AVX512VL
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    V load_partial(void const* mem_addr, std::size_t const count) { return _mm_mask_loadu_ps(_mm_set1_ps(1.0f), __mmask8((1u << count) - 1), mem_addr); }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V load_partial(void const* mem_addr, std::size_t const count) { return _mm_mask_loadu_pd(_mm_set1_pd(1.0), __mmask8((1u << count) - 1), mem_addr); }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        if constexpr (sizeof(T) == 1)      { return _mm256_mask_loadu_epi8(_mm256_set1_epi8(1), __mmask32((1u << count) - 1), mem_addr); }    // AVX512BW + AVX512VL
+        else if constexpr (sizeof(T) == 2) { return _mm256_mask_loadu_epi16(_mm256_set1_epi16(1), __mmask16((1u << count) - 1), mem_addr); } // AVX512BW + AVX512VL
+        else if constexpr (sizeof(T) == 4) { return _mm256_mask_loadu_epi32(_mm256_set1_epi32(1), __mmask8((1u << count) - 1), mem_addr); }  // AVX512F + AVX512VL
+        else                               { return _mm256_mask_loadu_epi64(_mm256_set1_epi64x(1), __mmask8((1u << count) - 1), mem_addr); } // AVX512F + AVX512VL
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    V load_partial(void const* mem_addr, std::size_t const count) { return _mm256_mask_loadu_ps(_mm256_set1_ps(1.0f), __mmask8((1u << count) - 1), mem_addr); }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V load_partial(void const* mem_addr, std::size_t const count) { return _mm256_mask_loadu_pd(_mm256_set1_pd(1.0), __mmask8((1u << count) - 1), mem_addr); }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) {
+        if constexpr (sizeof(T) == 1)      { _mm_mask_storeu_epi8(mem_addr, __mmask16((1u << count) - 1), a); }  // AVX512BW + AVX512VL
+        else if constexpr (sizeof(T) == 2) { _mm_mask_storeu_epi16(mem_addr, __mmask8((1u << count) - 1), a); }  // AVX512BW + AVX512VL
+        else if constexpr (sizeof(T) == 4) { _mm_mask_storeu_epi32(mem_addr, __mmask8((1u << count) - 1), a); }  // AVX512F + AVX512VL
+        else                               { _mm_mask_storeu_epi64(mem_addr, __mmask8((1u << count) - 1), a); }  // AVX512F + AVX512VL
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm_mask_storeu_ps(mem_addr, __mmask8((1u << count) - 1), a); }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm_mask_storeu_pd(mem_addr, __mmask8((1u << count) - 1), a); }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) {
+        if constexpr (sizeof(T) == 1)      { _mm256_mask_storeu_epi8(mem_addr, __mmask32((1u << count) - 1), a); }  // AVX512BW + AVX512VL
+        else if constexpr (sizeof(T) == 2) { _mm256_mask_storeu_epi16(mem_addr, __mmask16((1u << count) - 1), a); } // AVX512BW + AVX512VL
+        else if constexpr (sizeof(T) == 4) { _mm256_mask_storeu_epi32(mem_addr, __mmask8((1u << count) - 1), a); }  // AVX512F + AVX512VL
+        else                               { _mm256_mask_storeu_epi64(mem_addr, __mmask8((1u << count) - 1), a); }  // AVX512F + AVX512VL
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm256_mask_storeu_ps(mem_addr, __mmask8((1u << count) - 1), a); }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm256_mask_storeu_pd(mem_addr, __mmask8((1u << count) - 1), a); }
+#elif defined(__AVX2__)
+    template<typename T, typename V>
+    constexpr bool has_partial = sizeof(T) >= 4;
+
+    // all ones in the lanes below count
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V lanes_below(std::size_t const count) {
+        if constexpr (sizeof(T) == 4) { return _mm_cmpgt_epi32(_mm_set1_epi32(static_cast<int>(count)), _mm_setr_epi32(0, 1, 2, 3)); } // SSE2
+        else                          { return _mm_cmpgt_epi64(_mm_set1_epi64x(static_cast<long long>(count)), _mm_set_epi64x(1, 0)); }  // SSE4.2
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V lanes_below(std::size_t const count) {
+        if constexpr (sizeof(T) == 4) { return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(count)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); } // AVX2
+        else                          { return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(count)), _mm256_setr_epi64x(0, 1, 2, 3)); } // AVX2
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        __m128i const m = lanes_below<T, __m128i>(count);
+        if constexpr (sizeof(T) == 4) { return _mm_blendv_epi8(_mm_set1_epi32(1), _mm_maskload_epi32((int const*)mem_addr, m), m); }         // AVX2
+        else                          { return _mm_blendv_epi8(_mm_set1_epi64x(1), _mm_maskload_epi64((long long const*)mem_addr, m), m); } // AVX2
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        __m128i const m = lanes_below<T, __m128i>(count);
+        return _mm_blendv_ps(_mm_set1_ps(1.0f), _mm_maskload_ps((float const*)mem_addr, m), _mm_castsi128_ps(m)); // AVX
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        __m128i const m = lanes_below<T, __m128i>(count);
+        return _mm_blendv_pd(_mm_set1_pd(1.0), _mm_maskload_pd((double const*)mem_addr, m), _mm_castsi128_pd(m)); // AVX
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        __m256i const m = lanes_below<T, __m256i>(count);
+        if constexpr (sizeof(T) == 4) { return _mm256_blendv_epi8(_mm256_set1_epi32(1), _mm256_maskload_epi32((int const*)mem_addr, m), m); }         // AVX2
+        else                          { return _mm256_blendv_epi8(_mm256_set1_epi64x(1), _mm256_maskload_epi64((long long const*)mem_addr, m), m); } // AVX2
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        __m256i const m = lanes_below<T, __m256i>(count);
+        return _mm256_blendv_ps(_mm256_set1_ps(1.0f), _mm256_maskload_ps((float const*)mem_addr, m), _mm256_castsi256_ps(m)); // AVX
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        __m256i const m = lanes_below<T, __m256i>(count);
+        return _mm256_blendv_pd(_mm256_set1_pd(1.0), _mm256_maskload_pd((double const*)mem_addr, m), _mm256_castsi256_pd(m)); // AVX
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) {
+        if constexpr (sizeof(T) == 4) { _mm_maskstore_epi32((int*)mem_addr, lanes_below<T, __m128i>(count), a); }       // AVX2
+        else                          { _mm_maskstore_epi64((long long*)mem_addr, lanes_below<T, __m128i>(count), a); } // AVX2
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm_maskstore_ps((float*)mem_addr, lanes_below<T, __m128i>(count), a); } // AVX
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm_maskstore_pd((double*)mem_addr, lanes_below<T, __m128i>(count), a); } // AVX
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) {
+        if constexpr (sizeof(T) == 4) { _mm256_maskstore_epi32((int*)mem_addr, lanes_below<T, __m256i>(count), a); }       // AVX2
+        else                          { _mm256_maskstore_epi64((long long*)mem_addr, lanes_below<T, __m256i>(count), a); } // AVX2
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm256_maskstore_ps((float*)mem_addr, lanes_below<T, __m256i>(count), a); } // AVX
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm256_maskstore_pd((double*)mem_addr, lanes_below<T, __m256i>(count), a); } // AVX
+#else
+    template<typename T, typename V>
+    constexpr bool has_partial = false;
+#endif // __AVX512VL__ && __AVX512BW__
+
 //-----------------------------------------------------------------------------
 //  set instructions
 //-----------------------------------------------------------------------------
@@ -74,7 +280,8 @@ namespace simd {
         if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::int8_t>)        { return _mm_set1_epi8(s); }  // SSE2
         else if constexpr (std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::int16_t>) { return _mm_set1_epi16(s); } // SSE2
         else if constexpr (std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::int32_t>) { return _mm_set1_epi32(s); } // SSE2
-        else if constexpr (std::is_same_v<T, std::uint64_t> || std::is_same_v<T, std::int64_t>) { return _mm_set1_epi64(s); } // SSE2
+        else if constexpr (std::is_same_v<T, std::uint64_t> || std::is_same_v<T, std::int64_t>) { return _mm_set1_epi64x(s); } // SSE2
+        else if constexpr (is_fixed_v<T>)                                                        { return set<typename T::rep, V>(s.raw); }
     }
 
     template<typename T, typename V>
@@ -91,7 +298,8 @@ namespace simd {
         if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::int8_t>)        { return _mm256_set1_epi8(s); }  // AVX2
         else if constexpr (std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::int16_t>) { return _mm256_set1_epi16(s); } // AVX2
         else if constexpr (std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::int32_t>) { return _mm256_set1_epi32(s); } // AVX2
-        else if constexpr (std::is_same_v<T, std::uint64_t> || std::is_same_v<T, std::int64_t>) { return _mm256_set1_epi64(s); } // AVX2
+        else if constexpr (std::is_same_v<T, std::uint64_t> || std::is_same_v<T, std::int64_t>) { return _mm256_set1_epi64x(s); } // AVX2
+        else if constexpr (is_fixed_v<T>)                                                        { return set<typename T::rep, V>(s.raw); }
     }
 
     template<typename T, typename V>
@@ -102,6 +310,16 @@ namespace simd {
     requires (std::is_same_v<V, __m256d>)
     V set(T const s) { return _mm256_set1_pd(s); } // AVX
 
+#ifdef __AVX512F__
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512>)
+    V set(T const s) { return _mm512_set1_ps(s); } // AVX512F
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512d>)
+    V set(T const s) { return _mm512_set1_pd(s); } // AVX512F
+#endif // __AVX512F__
+
 //-----------------------------------------------------------------------------
 //  addition instructions
 //-----------------------------------------------------------------------------
@@ -113,6 +331,8 @@ namespace simd {
         else if constexpr (std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::int16_t>) { return _mm_add_epi16(a, b); } // SSE2
         else if constexpr (std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::int32_t>) { return _mm_add_epi32(a, b); } // SSE2
         else if constexpr (std::is_same_v<T, std::uint64_t> || std::is_same_v<T, std::int64_t>) { return _mm_add_epi64(a, b); } // SSE2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 2)                                      { return _mm_adds_epi16(a, b); } // SSE2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 4)                                      { return simd_adds_epi32(a, b); } // SSE4.1
     }
 
     // 128bit vector float addition
@@ -133,6 +353,8 @@ namespace simd {
         else if constexpr (std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::int16_t>) { return _mm256_add_epi16(a, b); } // AVX2
         else if constexpr (std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::int32_t>) { return _mm256_add_epi32(a, b); } // AVX2
         else if constexpr (std::is_same_v<T, std::uint64_t> || std::is_same_v<T, std::int64_t>) { return _mm256_add_epi64(a, b); } // AVX2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 2)                                      { return _mm256_adds_epi16(a, b); } // AVX2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 4)                                      { return simd_adds_epi32(a, b); } // AVX2
     }
 
     // 256bit vector float addition
@@ -156,6 +378,8 @@ namespace simd {
         else if constexpr (std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::int16_t>) { return _mm_sub_epi16(a, b); } // SSE2
         else if constexpr (std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::int32_t>) { return _mm_sub_epi32(a, b); } // SSE2
         else if constexpr (std::is_same_v<T, std::uint64_t> || std::is_same_v<T, std::int64_t>) { return _mm_sub_epi64(a, b); } // SSE2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 2)                                      { return _mm_subs_epi16(a, b); } // SSE2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 4)                                      { return simd_subs_epi32(a, b); } // SSE4.1
     }
 
     // 128bit vector float subtraction
@@ -176,6 +400,8 @@ namespace simd {
         else if constexpr (std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::int16_t>) { return _mm256_sub_epi16(a, b); } // AVX2
         else if constexpr (std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::int32_t>) { return _mm256_sub_epi32(a, b); } // AVX2
         else if constexpr (std::is_same_v<T, std::uint64_t> || std::is_same_v<T, std::int64_t>) { return _mm256_sub_epi64(a, b); } // AVX2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 2)                                      { return _mm256_subs_epi16(a, b); } // AVX2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 4)                                      { return simd_subs_epi32(a, b); } // AVX2
     }
 
     // 256bit vector float subtraction
@@ -191,6 +417,15 @@ namespace simd {
 //-----------------------------------------------------------------------------
 //  multiplication instructions
 //-----------------------------------------------------------------------------
+    // element types whose integer multiplication has a register implementation, the others are computed scalar
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+    template<typename T>
+    constexpr bool has_vector_mul = !std::is_same_v<T, std::uint64_t>;
+#else
+    template<typename T>
+    constexpr bool has_vector_mul = !std::is_same_v<T, std::uint64_t> && !std::is_same_v<T, std::int64_t>;
+#endif // __AVX512DQ__ && __AVX512VL__
+
     // 128bit vector integer multiplication
     template<typename T, typename V>
     requires (std::is_same_v<V, __m128i>)
@@ -203,6 +438,8 @@ namespace simd {
         else if constexpr (std::is_same_v<T, std::int32_t>)  { return simd_mul_si32(a, b); } // SSE4.1
         else if constexpr (std::is_same_v<T, std::uint64_t>) { return _mm_mul_epu64(a, b); } // TODO
         else if constexpr (std::is_same_v<T, std::int64_t>)  { return _mm_mullo_epi64(a, b); } // AVX512DQ + AVX512VL
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 2)   { return simd_mulhrs_sat_epi16(a, b); } // SSSE3
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 4)   { return simd_mulhrs_sat_epi32(a, b); } // SSE4.1
     }
 
     // 128bit vector float multiplication
@@ -227,6 +464,8 @@ namespace simd {
         else if constexpr (std::is_same_v<T, std::int32_t>)  { return simd_mul_si32(a, b); }
         else if constexpr (std::is_same_v<T, std::uint64_t>) { return _mm256_mul_epu64(a, b); } // TODO
         else if constexpr (std::is_same_v<T, std::int64_t>)  { return _mm256_mullo_epi64(a, b); } // AVX512DQ + AVX512VL
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 2)   { return simd_mulhrs_sat_epi16(a, b); } // AVX2
+        else if constexpr (is_fixed_v<T> && sizeof(T) == 4)   { return simd_mulhrs_sat_epi32(a, b); } // AVX2
     }
 
     // 256bit vector float multiplication
@@ -242,13 +481,17 @@ namespace simd {
 //-----------------------------------------------------------------------------
 //  division instructions
 //-----------------------------------------------------------------------------
+    // likewise for integer division, which has no instruction and only some element widths have an alternative
+    template<typename T>
+    constexpr bool has_vector_div = !std::is_same_v<T, std::int32_t> && !std::is_same_v<T, std::uint64_t> && !std::is_same_v<T, std::int64_t>;
+
     // 128bit vector integer division
     template<typename T, typename V>
     requires (std::is_same_v<V, __m128i>)
     V div(V const a, V const b) {
         if constexpr (std::is_same_v<T, std::uint8_t>)       { return simd_div_ui8(a, b); }  // SSE - FAIL - SVML (Intel only)
         else if constexpr (std::is_same_v<T, std::int8_t>)   { return simd_div_si8(a, b); }  // SSE - FAIL - SVML (Intel only)
-        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm_div_epu16(a, b); } // SSE - FAIL - SVML (Intel only)
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return simd_div_ui16(a, b); } // SSE4.1
         else if constexpr (std::is_same_v<T, std::int16_t>)  { return simd_div_si16(a, b); } // SSE - FAIL - SVML (Intel only)
         else if constexpr (std::is_same_v<T, std::uint32_t>) { return simd_div_ui32(a, b); } // SSE - FAIL - SVML (Intel only)
         else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm_div_epi32(a, b); } // SSE - FAIL - SVML (Intel only)
@@ -290,6 +533,16 @@ namespace simd {
     requires (std::is_same_v<V, __m256d>)
     V div(V const a, V const b) { return _mm256_div_pd(a, b); } // AVX
 
+#ifdef __AVX512F__
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512>)
+    V div(V const a, V const b) { return _mm512_div_ps(a, b); } // AVX512F
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512d>)
+    V div(V const a, V const b) { return _mm512_div_pd(a, b); } // AVX512F
+#endif // __AVX512F__
+
 //-----------------------------------------------------------------------------
 //  comparison instructions
 //-----------------------------------------------------------------------------
@@ -344,4 +597,611 @@ namespace simd {
     requires (std::is_same_v<V, __m256d>)
     V cmpeq(V const a, V const b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); } // AVX
 #endif // __AVX__
+
+//-----------------------------------------------------------------------------
+//  greater than comparison instructions
+//-----------------------------------------------------------------------------
+    // 128bit vector integer greater than
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V cmpgt(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return simd_cmpgt_epu8(a, b); }
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm_cmpgt_epi8(a, b); } // SSE2
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return simd_cmpgt_epu16(a, b); }
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm_cmpgt_epi16(a, b); } // SSE2
+        else if constexpr (std::is_same_v<T, std::uint32_t>) { return simd_cmpgt_epu32(a, b); }
+        else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm_cmpgt_epi32(a, b); } // SSE2
+        else if constexpr (std::is_same_v<T, std::uint64_t>) { return simd_cmpgt_epu64(a, b); }
+        else if constexpr (std::is_same_v<T, std::int64_t>)  { return _mm_cmpgt_epi64(a, b); } // SSE4.2
+    }
+
+    // 128bit vector float greater than
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    V cmpgt(V const a, V const b) { return _mm_cmpgt_ps(a, b); } // SSE
+
+    // 128bit vector double greater than
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V cmpgt(V const a, V const b) { return _mm_cmpgt_pd(a, b); } // SSE2
+
+#ifdef __AVX2__
+    // 256bit vector integer greater than
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V cmpgt(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return simd_cmpgt_epu8(a, b); }
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm256_cmpgt_epi8(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return simd_cmpgt_epu16(a, b); }
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm256_cmpgt_epi16(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::uint32_t>) { return simd_cmpgt_epu32(a, b); }
+        else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm256_cmpgt_epi32(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::uint64_t>) { return simd_cmpgt_epu64(a, b); }
+        else if constexpr (std::is_same_v<T, std::int64_t>)  { return _mm256_cmpgt_epi64(a, b); } // AVX2
+    }
+#endif // __AVX2__
+
+#ifdef __AVX__
+    // 256bit vector float greater than
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    V cmpgt(V const a, V const b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); } // AVX
+
+    // 256bit vector double greater than
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V cmpgt(V const a, V const b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); } // AVX
+#endif // __AVX__
+
+//-----------------------------------------------------------------------------
+//  minimum instructions
+//-----------------------------------------------------------------------------
+    // 128bit vector integer minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V min(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return _mm_min_epu8(a, b); }  // SSE2
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm_min_epi8(a, b); }  // SSE4.1
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm_min_epu16(a, b); } // SSE4.1
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm_min_epi16(a, b); } // SSE2
+        else if constexpr (std::is_same_v<T, std::uint32_t>) { return _mm_min_epu32(a, b); } // SSE4.1
+        else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm_min_epi32(a, b); } // SSE4.1
+        else if constexpr (std::is_same_v<T, std::uint64_t>) { return simd_min_ui64(a, b); }
+        else if constexpr (std::is_same_v<T, std::int64_t>)  { return simd_min_si64(a, b); }
+    }
+
+    // 128bit vector float minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    V min(V const a, V const b) { return _mm_min_ps(a, b); } // SSE
+
+    // 128bit vector double minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V min(V const a, V const b) { return _mm_min_pd(a, b); } // SSE2
+
+#ifdef __AVX2__
+    // 256bit vector integer minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V min(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return _mm256_min_epu8(a, b); }  // AVX2
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm256_min_epi8(a, b); }  // AVX2
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm256_min_epu16(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm256_min_epi16(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::uint32_t>) { return _mm256_min_epu32(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm256_min_epi32(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::uint64_t>) { return simd_min_ui64(a, b); }
+        else if constexpr (std::is_same_v<T, std::int64_t>)  { return simd_min_si64(a, b); }
+    }
+#endif // __AVX2__
+
+#ifdef __AVX__
+    // 256bit vector float minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    V min(V const a, V const b) { return _mm256_min_ps(a, b); } // AVX
+
+    // 256bit vector double minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V min(V const a, V const b) { return _mm256_min_pd(a, b); } // AVX
+#endif // __AVX__
+
+#ifdef __AVX512F__
+    // 512bit vector integer minimum, the AVX512F forms take a full mask and an explicit source because the unmasked
+    // intrinsics pass _mm512_undefined_*() through, which GCC reports as maybe-uninitialized at every inlined call
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512i>)
+    V min(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return _mm512_min_epu8(a, b); }  // AVX512BW
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm512_min_epi8(a, b); }  // AVX512BW
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm512_min_epu16(a, b); } // AVX512BW
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm512_min_epi16(a, b); } // AVX512BW
+        else if constexpr (std::is_same_v<T, std::uint32_t>) { return _mm512_mask_min_epu32(a, 0xFFFF, a, b); } // AVX512F
+        else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm512_mask_min_epi32(a, 0xFFFF, a, b); } // AVX512F
+        else if constexpr (std::is_same_v<T, std::uint64_t>) { return _mm512_mask_min_epu64(a, 0xFF, a, b); } // AVX512F
+        else if constexpr (std::is_same_v<T, std::int64_t>)  { return _mm512_mask_min_epi64(a, 0xFF, a, b); } // AVX512F
+    }
+
+    // 512bit vector float minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512>)
+    V min(V const a, V const b) { return _mm512_mask_min_ps(a, 0xFFFF, a, b); } // AVX512F
+
+    // 512bit vector double minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512d>)
+    V min(V const a, V const b) { return _mm512_mask_min_pd(a, 0xFF, a, b); } // AVX512F
+#endif // __AVX512F__
+
+//-----------------------------------------------------------------------------
+//  maximum instructions
+//-----------------------------------------------------------------------------
+    // 128bit vector integer maximum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V max(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return _mm_max_epu8(a, b); }  // SSE2
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm_max_epi8(a, b); }  // SSE4.1
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm_max_epu16(a, b); } // SSE4.1
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm_max_epi16(a, b); } // SSE2
+        else if constexpr (std::is_same_v<T, std::uint32_t>) { return _mm_max_epu32(a, b); } // SSE4.1
+        else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm_max_epi32(a, b); } // SSE4.1
+        else if constexpr (std::is_same_v<T, std::uint64_t>) { return simd_max_ui64(a, b); }
+        else if constexpr (std::is_same_v<T, std::int64_t>)  { return simd_max_si64(a, b); }
+    }
+
+    // 128bit vector float maximum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    V max(V const a, V const b) { return _mm_max_ps(a, b); } // SSE
+
+    // 128bit vector double maximum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V max(V const a, V const b) { return _mm_max_pd(a, b); } // SSE2
+
+#ifdef __AVX2__
+    // 256bit vector integer maximum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V max(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return _mm256_max_epu8(a, b); }  // AVX2
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm256_max_epi8(a, b); }  // AVX2
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm256_max_epu16(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm256_max_epi16(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::uint32_t>) { return _mm256_max_epu32(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm256_max_epi32(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::uint64_t>) { return simd_max_ui64(a, b); }
+        else if constexpr (std::is_same_v<T, std::int64_t>)  { return simd_max_si64(a, b); }
+    }
+#endif // __AVX2__
+
+#ifdef __AVX__
+    // 256bit vector float maximum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    V max(V const a, V const b) { return _mm256_max_ps(a, b); } // AVX
+
+    // 256bit vector double maximum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V max(V const a, V const b) { return _mm256_max_pd(a, b); } // AVX
+#endif // __AVX__
+
+#ifdef __AVX512F__
+    // 512bit vector integer maximum, masked AVX512F forms as for the minimum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512i>)
+    V max(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return _mm512_max_epu8(a, b); }  // AVX512BW
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm512_max_epi8(a, b); }  // AVX512BW
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm512_max_epu16(a, b); } // AVX512BW
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm512_max_epi16(a, b); } // AVX512BW
+        else if constexpr (std::is_same_v<T, std::uint32_t>) { return _mm512_mask_max_epu32(a, 0xFFFF, a, b); } // AVX512F
+        else if constexpr (std::is_same_v<T, std::int32_t>)  { return _mm512_mask_max_epi32(a, 0xFFFF, a, b); } // AVX512F
+        else if constexpr (std::is_same_v<T, std::uint64_t>) { return _mm512_mask_max_epu64(a, 0xFF, a, b); } // AVX512F
+        else if constexpr (std::is_same_v<T, std::int64_t>)  { return _mm512_mask_max_epi64(a, 0xFF, a, b); } // AVX512F
+    }
+
+    // 512bit vector float maximum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512>)
+    V max(V const a, V const b) { return _mm512_mask_max_ps(a, 0xFFFF, a, b); } // AVX512F
+
+    // 512bit vector double maximum
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512d>)
+    V max(V const a, V const b) { return _mm512_mask_max_pd(a, 0xFF, a, b); } // AVX512F
+#endif // __AVX512F__
+
+//-----------------------------------------------------------------------------
+//  fused multiply add instructions
+//-----------------------------------------------------------------------------
+    // a * b + c, rounded once with FMA and twice without
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    V fmadd(V const a, V const b, V const c) {
+    #ifdef __FMA__
+        return _mm_fmadd_ps(a, b, c);               // FMA
+    #else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);     // SSE
+    #endif // __FMA__
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V fmadd(V const a, V const b, V const c) {
+    #ifdef __FMA__
+        return _mm_fmadd_pd(a, b, c);               // FMA
+    #else
+        return _mm_add_pd(_mm_mul_pd(a, b), c);     // SSE2
+    #endif // __FMA__
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    V fmadd(V const a, V const b, V const c) {
+    #ifdef __FMA__
+        return _mm256_fmadd_ps(a, b, c);            // FMA
+    #else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c); // AVX
+    #endif // __FMA__
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V fmadd(V const a, V const b, V const c) {
+    #ifdef __FMA__
+        return _mm256_fmadd_pd(a, b, c);            // FMA
+    #else
+        return _mm256_add_pd(_mm256_mul_pd(a, b), c); // AVX
+    #endif // __FMA__
+    }
+
+#ifdef __AVX512F__
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512>)
+    V fmadd(V const a, V const b, V const c) { return _mm512_fmadd_ps(a, b, c); } // AVX512F
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m512d>)
+    V fmadd(V const a, V const b, V const c) { return _mm512_fmadd_pd(a, b, c); } // AVX512F
+#endif // __AVX512F__
+
+//-----------------------------------------------------------------------------
+//  square root instructions
+//-----------------------------------------------------------------------------
+    // 128bit vector float square root
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128>)
+    V sqrt(V const a) { return _mm_sqrt_ps(a); } // SSE
+
+    // 128bit vector double square root
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128d>)
+    V sqrt(V const a) { return _mm_sqrt_pd(a); } // SSE2
+
+    // 256bit vector float square root
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256>)
+    V sqrt(V const a) { return _mm256_sqrt_ps(a); } // AVX
+
+    // 256bit vector double square root
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256d>)
+    V sqrt(V const a) { return _mm256_sqrt_pd(a); } // AVX
+
+//-----------------------------------------------------------------------------
+//  movemask instructions
+//-----------------------------------------------------------------------------
+    // one bit per byte for every register type, so lane i of a T vector starts at bit i * sizeof(T)
+    template<typename V>
+    requires (std::is_same_v<V, __m128i>)
+    unsigned movemask(V const a) { return _mm_movemask_epi8(a); } // SSE2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128>)
+    unsigned movemask(V const a) { return _mm_movemask_epi8(_mm_castps_si128(a)); } // SSE2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128d>)
+    unsigned movemask(V const a) { return _mm_movemask_epi8(_mm_castpd_si128(a)); } // SSE2
+
+#ifdef __AVX2__
+    template<typename V>
+    requires (std::is_same_v<V, __m256i>)
+    unsigned movemask(V const a) { return _mm256_movemask_epi8(a); } // AVX2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256>)
+    unsigned movemask(V const a) { return _mm256_movemask_epi8(_mm256_castps_si256(a)); } // AVX2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256d>)
+    unsigned movemask(V const a) { return _mm256_movemask_epi8(_mm256_castpd_si256(a)); } // AVX2
+#endif // __AVX2__
+
+//-----------------------------------------------------------------------------
+//  byte instructions
+//-----------------------------------------------------------------------------
+    // byte i of the result is a[idx[i]] within the same 128bit lane, or zero when the top bit of idx[i] is set
+    template<typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V shuffle_bytes(V const a, V const idx) { return _mm_shuffle_epi8(a, idx); } // SSSE3
+
+    // a 16 byte table in every 128bit lane, for lookups with shuffle_bytes
+    template<typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V broadcast_lane(__m128i const a) { return a; }
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V bitwise_and(V const a, V const b) { return _mm_and_si128(a, b); } // SSE2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V bitwise_or(V const a, V const b) { return _mm_or_si128(a, b); } // SSE2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V bitwise_xor(V const a, V const b) { return _mm_xor_si128(a, b); } // SSE2
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V sub_saturate(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return _mm_subs_epu8(a, b); }  // SSE2
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm_subs_epi8(a, b); }  // SSE2
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm_subs_epu16(a, b); } // SSE2
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm_subs_epi16(a, b); } // SSE2
+    }
+
+    // the last N bytes of prev followed by the first bytes of a, as if the two were one stream
+    template<int N, typename V>
+    requires (std::is_same_v<V, __m128i>)
+    V shift_in(V const prev, V const a) { return _mm_alignr_epi8(a, prev, 16 - N); } // SSSE3
+
+#ifdef __AVX2__
+    template<typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V shuffle_bytes(V const a, V const idx) { return _mm256_shuffle_epi8(a, idx); } // AVX2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V broadcast_lane(__m128i const a) { return _mm256_broadcastsi128_si256(a); } // AVX2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V bitwise_and(V const a, V const b) { return _mm256_and_si256(a, b); } // AVX2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V bitwise_or(V const a, V const b) { return _mm256_or_si256(a, b); } // AVX2
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V bitwise_xor(V const a, V const b) { return _mm256_xor_si256(a, b); } // AVX2
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V sub_saturate(V const a, V const b) {
+        if constexpr (std::is_same_v<T, std::uint8_t>)       { return _mm256_subs_epu8(a, b); }  // AVX2
+        else if constexpr (std::is_same_v<T, std::int8_t>)   { return _mm256_subs_epi8(a, b); }  // AVX2
+        else if constexpr (std::is_same_v<T, std::uint16_t>) { return _mm256_subs_epu16(a, b); } // AVX2
+        else if constexpr (std::is_same_v<T, std::int16_t>)  { return _mm256_subs_epi16(a, b); } // AVX2
+    }
+
+    // alignr works within 128bit lanes, so the lane below each lane of a is made first
+    template<int N, typename V>
+    requires (std::is_same_v<V, __m256i>)
+    V shift_in(V const prev, V const a) { return _mm256_alignr_epi8(a, _mm256_permute2x128_si256(prev, a, 0x21), 16 - N); } // AVX2
+#endif // __AVX2__
+
+//-----------------------------------------------------------------------------
+//  half precision instructions
+//-----------------------------------------------------------------------------
+    // std::float16_t is _Float16 and std::bfloat16_t is __bf16, where the compiler provides them
+    template<typename T>
+#ifdef __FLT16_MAX__
+    constexpr bool is_float16_v = std::is_same_v<T, _Float16>;
+#else
+    constexpr bool is_float16_v = false;
+#endif // __FLT16_MAX__
+
+    template<typename T>
+#ifdef __BFLT16_MAX__
+    constexpr bool is_bfloat16_v = std::is_same_v<T, __bf16>;
+#else
+    constexpr bool is_bfloat16_v = false;
+#endif // __BFLT16_MAX__
+
+    template<typename T>
+    constexpr bool is_half_v = is_float16_v<T> || is_bfloat16_v<T>;
+
+    // without native arithmetic, 8 values at a time are widened to a float register and rounded back when stored
+#if defined(__AVX2__) && defined(__F16C__)
+    template<typename T>
+    constexpr bool has_widen = is_half_v<T>;
+#elif defined(__AVX2__)
+    template<typename T>
+    constexpr bool has_widen = is_bfloat16_v<T>;
+#else
+    template<typename T>
+    constexpr bool has_widen = false;
+#endif // __AVX2__ && __F16C__
+
+#ifdef __AVX2__
+    template<typename T>
+    requires (is_half_v<T>)
+    __m256 widen(void const* mem_addr) {
+        __m128i const a = _mm_loadu_si128((__m128i_u*)mem_addr);
+        if constexpr (is_float16_v<T>) { return _mm256_cvtph_ps(a); } // F16C
+        else                           { return simd_cvtbf16_ps(a); }
+    }
+
+    template<typename T>
+    requires (is_half_v<T>)
+    void narrow(void* mem_addr, __m256 const a) {
+        if constexpr (is_float16_v<T>) { _mm_storeu_si128((__m128i_u*)mem_addr, _mm256_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT)); } // F16C
+        else                           { _mm_storeu_si128((__m128i_u*)mem_addr, simd_cvtps_bf16(a)); }
+    }
+#endif // __AVX2__
+
+    // native fp16 arithmetic, the element type is implied by the register
+#ifdef __AVX512FP16__
+    template<typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V load(void const* mem_addr) { return _mm_loadu_ph(mem_addr); } // AVX512FP16 + AVX512VL
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V load(void const* mem_addr) { return _mm256_loadu_ph(mem_addr); } // AVX512FP16 + AVX512VL
+
+    template<typename V>
+    requires (std::is_same_v<V, __m128h>)
+    void store(void const* mem_addr, V a) { _mm_storeu_ph((void*)mem_addr, a); } // AVX512FP16 + AVX512VL
+
+    template<typename V>
+    requires (std::is_same_v<V, __m256h>)
+    void store(void const* mem_addr, V a) { _mm256_storeu_ph((void*)mem_addr, a); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        return _mm_castsi128_ph(_mm_mask_loadu_epi16(_mm_castph_si128(_mm_set1_ph(static_cast<_Float16>(1.0f))), __mmask8((1u << count) - 1), mem_addr)); // AVX512BW + AVX512VL
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V load_partial(void const* mem_addr, std::size_t const count) {
+        return _mm256_castsi256_ph(_mm256_mask_loadu_epi16(_mm256_castph_si256(_mm256_set1_ph(static_cast<_Float16>(1.0f))), __mmask16((1u << count) - 1), mem_addr)); // AVX512BW + AVX512VL
+    }
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm_mask_storeu_epi16(mem_addr, __mmask8((1u << count) - 1), _mm_castph_si128(a)); } // AVX512BW + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    void store_partial(void* mem_addr, V a, std::size_t const count) { _mm256_mask_storeu_epi16(mem_addr, __mmask16((1u << count) - 1), _mm256_castph_si256(a)); } // AVX512BW + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V set(T const s) { return _mm_set1_ph(s); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V set(T const s) { return _mm256_set1_ph(s); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V add(V const a, V const b) { return _mm_add_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V add(V const a, V const b) { return _mm256_add_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V sub(V const a, V const b) { return _mm_sub_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V sub(V const a, V const b) { return _mm256_sub_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V mul(V const a, V const b) { return _mm_mul_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V mul(V const a, V const b) { return _mm256_mul_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V div(V const a, V const b) { return _mm_div_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V div(V const a, V const b) { return _mm256_div_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V min(V const a, V const b) { return _mm_min_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V min(V const a, V const b) { return _mm256_min_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m128h>)
+    V max(V const a, V const b) { return _mm_max_ph(a, b); } // AVX512FP16 + AVX512VL
+
+    template<typename T, typename V>
+    requires (std::is_same_v<V, __m256h>)
+    V max(V const a, V const b) { return _mm256_max_ph(a, b); } // AVX512FP16 + AVX512VL
+#endif // __AVX512FP16__
+
+//-----------------------------------------------------------------------------
+//  conversion instructions
+//-----------------------------------------------------------------------------
+    // integers of From sign or zero extended to Bytes wide lanes of V, reading as many elements as V has lanes
+    template<typename From, std::size_t Bytes, typename V>
+    requires (std::is_same_v<V, __m128i> && std::is_integral_v<From> && Bytes == 4)
+    V extend_load(From const* mem_addr) {
+        constexpr bool s = std::is_signed_v<From>;
+        if constexpr (sizeof(From) == 1)      { return s ? _mm_cvtepi8_epi32(_mm_loadu_si32(mem_addr)) : _mm_cvtepu8_epi32(_mm_loadu_si32(mem_addr)); } // SSE4.1
+        else if constexpr (sizeof(From) == 2) { return s ? _mm_cvtepi16_epi32(_mm_loadl_epi64((__m128i_u*)mem_addr)) : _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i_u*)mem_addr)); } // SSE4.1
+        else                                  { return _mm_loadu_si128((__m128i_u*)mem_addr); } // SSE2
+    }
+
+#ifdef __AVX2__
+    template<typename From, std::size_t Bytes, typename V>
+    requires (std::is_same_v<V, __m256i> && std::is_integral_v<From> && sizeof(From) <= Bytes)
+    V extend_load(From const* mem_addr) {
+        constexpr bool s = std::is_signed_v<From>;
+        if constexpr (sizeof(From) == Bytes)                  { return load<V>(mem_addr); }
+        else if constexpr (sizeof(From) == 1 && Bytes == 2) { return s ? _mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i_u*)mem_addr)) : _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i_u*)mem_addr)); } // AVX2
+        else if constexpr (sizeof(From) == 1 && Bytes == 4) { return s ? _mm256_cvtepi8_epi32(_mm_loadl_epi64((__m128i_u*)mem_addr)) : _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i_u*)mem_addr)); } // AVX2
+        else if constexpr (sizeof(From) == 1 && Bytes == 8) { return s ? _mm256_cvtepi8_epi64(_mm_loadu_si32(mem_addr)) : _mm256_cvtepu8_epi64(_mm_loadu_si32(mem_addr)); } // AVX2
+        else if constexpr (sizeof(From) == 2 && Bytes == 4) { return s ? _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i_u*)mem_addr)) : _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i_u*)mem_addr)); } // AVX2
+        else if constexpr (sizeof(From) == 2 && Bytes == 8) { return s ? _mm256_cvtepi16_epi64(_mm_loadl_epi64((__m128i_u*)mem_addr)) : _mm256_cvtepu16_epi64(_mm_loadl_epi64((__m128i_u*)mem_addr)); } // AVX2
+        else                                                  { return s ? _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i_u*)mem_addr)) : _mm256_cvtepu32_epi64(_mm_loadu_si128((__m128i_u*)mem_addr)); } // AVX2
+    }
+
+    // mixed element types, the narrower operand is widened in the register as it is loaded. Converting to a narrower
+    // type, and 64bit integers to floating point without AVX512DQ, is left to scalar code
+    template<typename From, typename To>
+    constexpr bool has_convert = std::is_arithmetic_v<From> && std::is_arithmetic_v<To>
+                                 && !std::is_same_v<From, bool> && !std::is_same_v<To, bool> && !is_half_v<From> && !is_half_v<To>
+                                 && sizeof(From) <= sizeof(To) && !(std::is_floating_point_v<From> && std::is_integral_v<To>)
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+                                 ;
+#else
+                                 && !(std::is_integral_v<From> && sizeof(From) == 8 && std::is_floating_point_v<To>);
+#endif // __AVX512DQ__ && __AVX512VL__
+
+    // a 256bit register of To from as many From elements as it has lanes
+    template<typename From, typename To, typename V>
+    requires (has_convert<From, To> && sizeof(V) == 32)
+    V convert_load(From const* mem_addr) {
+        if constexpr (std::is_same_v<From, To>)                 { return load<V>(mem_addr); }
+        else if constexpr (std::is_integral_v<To>)              { return extend_load<From, sizeof(To), V>(mem_addr); }
+        else if constexpr (std::is_same_v<To, float>) {
+            if constexpr (std::is_same_v<From, std::uint32_t>)  { return simd_cvtepu32_ps(load<__m256i>(mem_addr)); }
+            else                                                { return _mm256_cvtepi32_ps(extend_load<From, 4, __m256i>(mem_addr)); } // AVX
+        }
+        else if constexpr (std::is_same_v<From, float>)         { return _mm256_cvtps_pd(_mm_loadu_ps(mem_addr)); } // AVX
+        else if constexpr (std::is_same_v<From, std::uint32_t>) { return simd_cvtepu32_pd(_mm_loadu_si128((__m128i_u*)mem_addr)); }
+        else if constexpr (sizeof(From) <= 4)                   { return _mm256_cvtepi32_pd(extend_load<From, 4, __m128i>(mem_addr)); } // AVX
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+        else if constexpr (std::is_signed_v<From>)              { return _mm256_cvtepi64_pd(load<__m256i>(mem_addr)); } // AVX512DQ + AVX512VL
+        else                                                    { return _mm256_cvtepu64_pd(load<__m256i>(mem_addr)); } // AVX512DQ + AVX512VL
+#endif // __AVX512DQ__ && __AVX512VL__
+    }
+#else
+    template<typename From, typename To>
+    constexpr bool has_convert = false;
+#endif // __AVX2__
 }
@@ -0,0 +1,267 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  The loops behind the vector operators. How many registers an iteration handles and how far ahead of the loads to
+ *  prefetch is a compile time policy per register type, which can instead ask for both to be measured on the host
+ *  the first time a loop runs.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+
+namespace simd {
+    // registers per iteration (1, 2, 4 or 8) and prefetch distance in bytes (0 for none). Specialise for a register
+    // type to change it, with tune = true the two are chosen by timing every combination once per process
+    template<typename V>
+    struct loop_policy {
+        static constexpr std::size_t unroll = 4;
+        static constexpr std::size_t prefetch = 256;
+        static constexpr bool tune = false;
+    };
+
+    // arrays smaller than this fit in L2 and are not prefetched
+    constexpr std::size_t loop_prefetch_min_bytes = 256 * 1024;
+
+    // c = op(a, b) for U registers of a and b at a time, then single registers, then a masked register for the rest
+    template<typename T, typename V, std::size_t U>
+    inline void unrolled_loop(std::size_t& i, std::size_t const n, T const* a, T const* b, T* c, std::size_t const prefetch, auto op)
+    {
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+
+        for (; i + (VN * U) <= n; i += (VN * U)) {
+            if (prefetch != 0) {
+                for (std::size_t line = 0; line < sizeof(V) * U; line += 64) {
+                    _mm_prefetch(reinterpret_cast<char const*>(&a[i]) + prefetch + line, _MM_HINT_T0);
+                    _mm_prefetch(reinterpret_cast<char const*>(&b[i]) + prefetch + line, _MM_HINT_T0);
+                }
+            }
+            [&]<std::size_t... u>(std::index_sequence<u...>) {
+                V const va[U] = {load<V>(&a[i + (u * VN)])...};
+                V const vb[U] = {load<V>(&b[i + (u * VN)])...};
+                (store<V>(&c[i + (u * VN)], op(va[u], vb[u])), ...);
+            }(std::make_index_sequence<U>{});
+        }
+        for (; i + VN <= n; i += VN) {
+            store<V>(&c[i], op(load<V>(&a[i]), load<V>(&b[i])));
+        }
+        if constexpr (has_partial<T, V>) {
+            if (i < n) {
+                store_partial<T, V>(&c[i], op(load_partial<T, V>(&a[i], n - i), load_partial<T, V>(&b[i], n - i)), n - i);
+                i = n;
+            }
+        }
+    }
+
+    // c = op(s, b) with s already broadcast to a register
+    template<typename T, typename V, std::size_t U>
+    inline void unrolled_loop_scalar(std::size_t& i, std::size_t const n, V const s, T const* b, T* c, std::size_t const prefetch, auto op)
+    {
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+
+        for (; i + (VN * U) <= n; i += (VN * U)) {
+            if (prefetch != 0) {
+                for (std::size_t line = 0; line < sizeof(V) * U; line += 64) {
+                    _mm_prefetch(reinterpret_cast<char const*>(&b[i]) + prefetch + line, _MM_HINT_T0);
+                }
+            }
+            [&]<std::size_t... u>(std::index_sequence<u...>) {
+                V const vb[U] = {load<V>(&b[i + (u * VN)])...};
+                (store<V>(&c[i + (u * VN)], op(s, vb[u])), ...);
+            }(std::make_index_sequence<U>{});
+        }
+        for (; i + VN <= n; i += VN) {
+            store<V>(&c[i], op(s, load<V>(&b[i])));
+        }
+        if constexpr (has_partial<T, V>) {
+            if (i < n) {
+                store_partial<T, V>(&c[i], op(s, load_partial<T, V>(&b[i], n - i)), n - i);
+                i = n;
+            }
+        }
+    }
+
+    // 16bit floats without native arithmetic: two registers of a and b are widened to float, op applied, and the
+    // results rounded back to T as they are stored
+    template<typename T, typename V>
+    inline void widening_loop(std::size_t& i, std::size_t const n, T const* a, T const* b, T* c, auto op)
+    {
+        constexpr std::size_t VN = sizeof(V) / sizeof(float);
+
+        for (; i + (VN * 2) <= n; i += (VN * 2)) {
+            V const a1 = widen<T>(&a[i]);
+            V const a2 = widen<T>(&a[i + VN]);
+            V const b1 = widen<T>(&b[i]);
+            V const b2 = widen<T>(&b[i + VN]);
+            narrow<T>(&c[i], op(a1, b1));
+            narrow<T>(&c[i + VN], op(a2, b2));
+        }
+        for (; i + VN <= n; i += VN) {
+            narrow<T>(&c[i], op(widen<T>(&a[i]), widen<T>(&b[i])));
+        }
+    }
+
+    template<typename T, typename V>
+    inline void widening_loop_scalar(std::size_t& i, std::size_t const n, V const s, T const* b, T* c, auto op)
+    {
+        constexpr std::size_t VN = sizeof(V) / sizeof(float);
+
+        for (; i + (VN * 2) <= n; i += (VN * 2)) {
+            V const b1 = widen<T>(&b[i]);
+            V const b2 = widen<T>(&b[i + VN]);
+            narrow<T>(&c[i], op(s, b1));
+            narrow<T>(&c[i + VN], op(s, b2));
+        }
+        for (; i + VN <= n; i += VN) {
+            narrow<T>(&c[i], op(s, widen<T>(&b[i])));
+        }
+    }
+
+    // c = op(a, b) for operands of two element types, each register of a and b is converted to T while it is loaded
+    // so neither is copied to a wider array first
+    template<typename T, typename V, typename A, typename B>
+    inline void converting_loop(std::size_t& i, std::size_t const n, A const* a, B const* b, T* c, auto op)
+    {
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+
+        for (; i + (VN * 2) <= n; i += (VN * 2)) {
+            V const a1 = convert_load<A, T, V>(&a[i]);
+            V const a2 = convert_load<A, T, V>(&a[i + VN]);
+            V const b1 = convert_load<B, T, V>(&b[i]);
+            V const b2 = convert_load<B, T, V>(&b[i + VN]);
+            store<V>(&c[i], op(a1, b1));
+            store<V>(&c[i + VN], op(a2, b2));
+        }
+        for (; i + VN <= n; i += VN) {
+            store<V>(&c[i], op(convert_load<A, T, V>(&a[i]), convert_load<B, T, V>(&b[i])));
+        }
+    }
+
+    template<typename T, typename V, typename B>
+    inline void converting_loop_scalar(std::size_t& i, std::size_t const n, V const s, B const* b, T* c, auto op)
+    {
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+
+        for (; i + (VN * 2) <= n; i += (VN * 2)) {
+            V const b1 = convert_load<B, T, V>(&b[i]);
+            V const b2 = convert_load<B, T, V>(&b[i + VN]);
+            store<V>(&c[i], op(s, b1));
+            store<V>(&c[i + VN], op(s, b2));
+        }
+        for (; i + VN <= n; i += VN) {
+            store<V>(&c[i], op(s, convert_load<B, T, V>(&b[i])));
+        }
+    }
+
+//-----------------------------------------------------------------------------
+//  tuning
+//-----------------------------------------------------------------------------
+    struct loop_tuning {
+        std::size_t unroll;
+        std::size_t prefetch;
+    };
+
+    // times an add over arrays well beyond L2 for every unroll and prefetch distance, the fastest is kept for the
+    // rest of the process
+    template<typename T, typename V>
+    loop_tuning const& tuned_loop()
+    {
+        static loop_tuning const tuning = [] {
+            constexpr std::size_t n = (4 * 1024 * 1024) / sizeof(T);
+            constexpr std::array<std::size_t, 4> prefetches = {0, 256, 512, 1024};
+            auto const a = std::make_unique_for_overwrite<T[]>(n);
+            auto const c = std::make_unique_for_overwrite<T[]>(n);
+            std::fill_n(a.get(), n, T(1));
+
+            auto op = [](V x, V y) { return add<T, V>(x, y); };
+            auto time = [&]<std::size_t U>(std::size_t const prefetch) {
+                auto best = std::chrono::steady_clock::duration::max();
+                for (int r = 0; r < 3; ++r) {
+                    auto const start = std::chrono::steady_clock::now();
+                    std::size_t i = 0;
+                    unrolled_loop<T, V, U>(i, n, a.get(), a.get(), c.get(), prefetch, op);
+                    best = std::min(best, std::chrono::steady_clock::now() - start);
+                }
+                return best;
+            };
+
+            loop_tuning result = {1, 0};
+            auto fastest = std::chrono::steady_clock::duration::max();
+            for (std::size_t const prefetch : prefetches) {
+                std::array<std::pair<std::size_t, std::chrono::steady_clock::duration>, 4> const times = {{
+                    {1, time.template operator()<1>(prefetch)}, {2, time.template operator()<2>(prefetch)},
+                    {4, time.template operator()<4>(prefetch)}, {8, time.template operator()<8>(prefetch)}}};
+                for (auto const& [unroll, t] : times) {
+                    if (t < fastest) {
+                        fastest = t;
+                        result = {unroll, prefetch};
+                    }
+                }
+            }
+            return result;
+        }();
+        return tuning;
+    }
+
+//-----------------------------------------------------------------------------
+//  policy loops
+//-----------------------------------------------------------------------------
+    template<typename T, typename V>
+    inline void policy_loop(std::size_t& i, std::size_t const n, T const* a, T const* b, T* c, auto op)
+    {
+        using policy = loop_policy<V>;
+        static_assert(policy::unroll == 1 || policy::unroll == 2 || policy::unroll == 4 || policy::unroll == 8);
+
+        if constexpr (is_half_v<T> && std::is_same_v<V, __m256>) {
+            widening_loop<T, V>(i, n, a, b, c, op);
+        }
+        else if constexpr (policy::tune) {
+            loop_tuning const& t = tuned_loop<T, V>();
+            std::size_t const prefetch = n * sizeof(T) >= loop_prefetch_min_bytes ? t.prefetch : 0;
+            switch (t.unroll) {
+                case 1:  unrolled_loop<T, V, 1>(i, n, a, b, c, prefetch, op); break;
+                case 2:  unrolled_loop<T, V, 2>(i, n, a, b, c, prefetch, op); break;
+                case 4:  unrolled_loop<T, V, 4>(i, n, a, b, c, prefetch, op); break;
+                default: unrolled_loop<T, V, 8>(i, n, a, b, c, prefetch, op); break;
+            }
+        }
+        else {
+            std::size_t const prefetch = n * sizeof(T) >= loop_prefetch_min_bytes ? policy::prefetch : 0;
+            unrolled_loop<T, V, policy::unroll>(i, n, a, b, c, prefetch, op);
+        }
+    }
+
+    template<typename T, typename V>
+    inline void policy_loop_scalar(std::size_t& i, std::size_t const n, T const s, T const* b, T* c, auto op)
+    {
+        using policy = loop_policy<V>;
+        static_assert(policy::unroll == 1 || policy::unroll == 2 || policy::unroll == 4 || policy::unroll == 8);
+        V const vs = set<T, V>(s);
+
+        if constexpr (is_half_v<T> && std::is_same_v<V, __m256>) {
+            widening_loop_scalar<T, V>(i, n, vs, b, c, op);
+        }
+        else if constexpr (policy::tune) {
+            loop_tuning const& t = tuned_loop<T, V>();
+            std::size_t const prefetch = n * sizeof(T) >= loop_prefetch_min_bytes ? t.prefetch : 0;
+            switch (t.unroll) {
+                case 1:  unrolled_loop_scalar<T, V, 1>(i, n, vs, b, c, prefetch, op); break;
+                case 2:  unrolled_loop_scalar<T, V, 2>(i, n, vs, b, c, prefetch, op); break;
+                case 4:  unrolled_loop_scalar<T, V, 4>(i, n, vs, b, c, prefetch, op); break;
+                default: unrolled_loop_scalar<T, V, 8>(i, n, vs, b, c, prefetch, op); break;
+            }
+        }
+        else {
+            std::size_t const prefetch = n * sizeof(T) >= loop_prefetch_min_bytes ? policy::prefetch : 0;
+            unrolled_loop_scalar<T, V, policy::unroll>(i, n, vs, b, c, prefetch, op);
+        }
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Memory mapped files of T. The mapping is viewed as consecutive simd::vector<T, Chunk> chunks, so the operators,
+ *  searches and histograms run straight on the page cache, and results assigned into the chunks of a mapped output
+ *  file are written back by the kernel - the file is never copied through a user space buffer.
+ */
+#pragma once
+
+#if __has_include(<sys/mman.h>)
+
+#include <cerrno>
+#include <cstddef>
+#include <new>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "simd_vector.hpp"
+
+namespace simd {
+    // Chunk elements per view, the default is 16KB - small enough that a chunk and a result stay in L1/L2 while a
+    // pipeline of operators runs over it
+    template<typename T, std::size_t Chunk = (16 * 1024) / sizeof(T)>
+    class mapped_array {
+    public:
+        using chunk_type = vector<T, Chunk>;
+
+        static_assert(sizeof(chunk_type) == Chunk * sizeof(T), "Chunk * sizeof(T) must be a multiple of 64 bytes");
+
+        // map an existing file for reading, writes through chunk() stay private to this process
+        explicit mapped_array(std::string const& path)
+        {
+            int const fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), path);
+            }
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0) {
+                int const err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), path);
+            }
+
+            count = static_cast<std::size_t>(st.st_size) / sizeof(T);
+            map(fd, PROT_READ | PROT_WRITE, MAP_PRIVATE, path);
+        }
+
+        // create (or truncate) a file of n elements, everything written to it reaches the file
+        static mapped_array create(std::string const& path, std::size_t const n)
+        {
+            int const fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), path);
+            }
+            if (::ftruncate(fd, static_cast<off_t>(n * sizeof(T))) != 0) {
+                int const err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), path);
+            }
+
+            mapped_array result;
+            result.count = n;
+            result.map(fd, PROT_READ | PROT_WRITE, MAP_SHARED, path);
+            return result;
+        }
+
+        mapped_array(mapped_array&& other) noexcept
+            : ptr(std::exchange(other.ptr, nullptr)), count(std::exchange(other.count, 0)), bytes(std::exchange(other.bytes, 0)) {}
+
+        mapped_array& operator=(mapped_array&& other) noexcept
+        {
+            std::swap(ptr, other.ptr);
+            std::swap(count, other.count);
+            std::swap(bytes, other.bytes);
+            return *this;
+        }
+
+        mapped_array(mapped_array const&) = delete;
+        mapped_array& operator=(mapped_array const&) = delete;
+
+        ~mapped_array()
+        {
+            if (ptr != nullptr) {
+                ::munmap(ptr, bytes);
+            }
+        }
+
+        std::size_t size() const noexcept { return count; }
+        std::size_t chunks() const noexcept { return count / Chunk; }
+
+        T* data() noexcept { return ptr; }
+        T const* data() const noexcept { return ptr; }
+        T* begin() noexcept { return ptr; }
+        T* end() noexcept { return ptr + count; }
+        T const* begin() const noexcept { return ptr; }
+        T const* end() const noexcept { return ptr + count; }
+
+        T& operator[](std::size_t index) noexcept { return ptr[index]; }
+        T const& operator[](std::size_t index) const noexcept { return ptr[index]; }
+
+        // the mapping is page aligned and every chunk starts a multiple of 64 bytes in, so a chunk has the layout
+        // and alignment of the inline simd::vector
+        chunk_type& chunk(std::size_t k) noexcept
+        {
+            return *std::launder(reinterpret_cast<chunk_type*>(ptr + (k * Chunk)));
+        }
+
+        chunk_type const& chunk(std::size_t k) const noexcept
+        {
+            return *std::launder(reinterpret_cast<chunk_type const*>(ptr + (k * Chunk)));
+        }
+
+        // the elements after the last whole chunk
+        std::span<T> tail() noexcept { return {ptr + (chunks() * Chunk), count % Chunk}; }
+        std::span<T const> tail() const noexcept { return {ptr + (chunks() * Chunk), count % Chunk}; }
+
+        // write dirty pages of a created file back now rather than when the kernel gets round to it
+        void sync()
+        {
+            if (ptr != nullptr && ::msync(ptr, bytes, MS_SYNC) != 0) {
+                throw std::system_error(errno, std::generic_category(), "msync");
+            }
+        }
+
+    private:
+        mapped_array() = default;
+
+        // the descriptor is closed whether or not mapping succeeds, the mapping holds its own reference to the file
+        void map(int const fd, int const prot, int const flags, std::string const& path)
+        {
+            bytes = count * sizeof(T);
+            if (bytes == 0) {
+                ::close(fd);
+                return;
+            }
+
+            void* const p = ::mmap(nullptr, bytes, prot, flags, fd, 0);
+            int const err = errno;
+            ::close(fd);
+            if (p == MAP_FAILED) {
+                throw std::system_error(err, std::generic_category(), path);
+            }
+
+            // the kernel reads ahead aggressively and drops pages behind, huge pages are a hint which file systems
+            // without large folio support ignore
+            ::madvise(p, bytes, MADV_SEQUENTIAL);
+        #ifdef MADV_HUGEPAGE
+            ::madvise(p, bytes, MADV_HUGEPAGE);
+        #endif // MADV_HUGEPAGE
+            ptr = static_cast<T*>(p);
+        }
+
+        T* ptr = nullptr;
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+    };
+}
+
+#endif // __has_include(<sys/mman.h>)
@@ -0,0 +1,390 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Matrix-vector products. A matrix-vector product reads every element of A once and does one multiply-add with it,
+ *  so it is limited by memory bandwidth and both kernels stream A in storage order. Rows of a row major A are dot
+ *  products, four rows at a time sharing each load of x. Columns of a column major A are added, scaled by x, four at
+ *  a time to a block of y that stays in L1. A transposed product is the other kernel on the same memory, and large
+ *  products can be split by rows over threads.
+ *
+ *  Transposes of 1, 2, 4 and 8 byte elements are done a square tile of registers at a time: a row per register, then
+ *  log2(rows) rounds of unpacks. Large matrices are walked in blocks small enough that both the rows read and the
+ *  columns written stay in L1.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    enum class matrix_layout {
+        row_major,
+        column_major
+    };
+
+//-----------------------------------------------------------------------------
+//  kernels
+//-----------------------------------------------------------------------------
+    // y[r] = dot(a row r, x) for R rows, two registers of each row per iteration gives 2R independent fmadd chains
+    template<typename T, std::size_t R>
+    void gemv_rows(T const* a, std::size_t const lda, T const* x, T* y, std::size_t const cols)
+    {
+        using V = native_register<T>;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        std::array<std::array<V, 2>, R> acc;
+        for (auto& row : acc) {
+            row = {set<T, V>(T(0)), set<T, V>(T(0))};
+        }
+
+        std::size_t c = 0;
+        for (; c + (VN * 2) <= cols; c += (VN * 2)) {
+            V const x1 = load<V>(&x[c]);
+            V const x2 = load<V>(&x[c + VN]);
+            [&]<std::size_t... r>(std::index_sequence<r...>) {
+                ((acc[r][0] = fmadd<T, V>(load<V>(&a[(r * lda) + c]), x1, acc[r][0]),
+                  acc[r][1] = fmadd<T, V>(load<V>(&a[(r * lda) + c + VN]), x2, acc[r][1])), ...);
+            }(std::make_index_sequence<R>{});
+        }
+        for (; c + VN <= cols; c += VN) {
+            V const x1 = load<V>(&x[c]);
+            [&]<std::size_t... r>(std::index_sequence<r...>) {
+                ((acc[r][0] = fmadd<T, V>(load<V>(&a[(r * lda) + c]), x1, acc[r][0])), ...);
+            }(std::make_index_sequence<R>{});
+        }
+
+        for (std::size_t r = 0; r < R; ++r) {
+            alignas(64) std::array<T, VN> lanes;
+            store<V>(lanes.data(), add<T, V>(acc[r][0], acc[r][1]));
+            T sum = T(0);
+            for (std::size_t l = 0; l < VN; ++l) {
+                sum += lanes[l];
+            }
+            for (std::size_t k = c; k < cols; ++k) {
+                sum += a[(r * lda) + k] * x[k];
+            }
+            y[r] = sum;
+        }
+    }
+
+    // y[first, last) = sum over columns c of a column c * x[c], for column major A with column stride lda. A block of
+    // y small enough for L1 takes four columns per pass, so A is read as four sequential streams rather than
+    // jumping a whole column ahead for every register
+    template<typename T>
+    void gemv_columns(T const* a, std::size_t const lda, T const* x, T* y, std::size_t const first, std::size_t const last, std::size_t const cols)
+    {
+        using V = native_register<T>;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        constexpr std::size_t block = 4096 / sizeof(T);
+
+        for (std::size_t b = first; b < last; b += block) {
+            std::size_t const end = std::min(last, b + block);
+            std::fill(&y[b], &y[end], T(0));
+
+            std::size_t c = 0;
+            for (; c + 4 <= cols; c += 4) {
+                std::array<V, 4> const xc = {set<T, V>(x[c]), set<T, V>(x[c + 1]), set<T, V>(x[c + 2]), set<T, V>(x[c + 3])};
+                std::array<T const*, 4> const col = {&a[c * lda], &a[(c + 1) * lda], &a[(c + 2) * lda], &a[(c + 3) * lda]};
+                std::size_t r = b;
+                for (; r + VN <= end; r += VN) {
+                    V acc = load<V>(&y[r]);
+                    [&]<std::size_t... k>(std::index_sequence<k...>) {
+                        ((acc = fmadd<T, V>(load<V>(&col[k][r]), xc[k], acc)), ...);
+                    }(std::make_index_sequence<4>{});
+                    store<V>(&y[r], acc);
+                }
+                for (; r < end; ++r) {
+                    y[r] += col[0][r] * x[c] + col[1][r] * x[c + 1] + col[2][r] * x[c + 2] + col[3][r] * x[c + 3];
+                }
+            }
+            for (; c < cols; ++c) {
+                V const xc = set<T, V>(x[c]);
+                std::size_t r = b;
+                for (; r + VN <= end; r += VN) {
+                    store<V>(&y[r], fmadd<T, V>(load<V>(&a[(c * lda) + r]), xc, load<V>(&y[r])));
+                }
+                for (; r < end; ++r) {
+                    y[r] += a[(c * lda) + r] * x[c];
+                }
+            }
+        }
+    }
+
+    // y[first, last) for row major A, four rows at a time and the remaining rows together
+    template<typename T>
+    void gemv_rows(T const* a, std::size_t const lda, T const* x, T* y, std::size_t const first, std::size_t const last, std::size_t const cols)
+    {
+        std::size_t r = first;
+        for (; r + 4 <= last; r += 4) {
+            gemv_rows<T, 4>(&a[r * lda], lda, x, &y[r], cols);
+        }
+        switch (last - r) {
+            case 3:  gemv_rows<T, 3>(&a[r * lda], lda, x, &y[r], cols); break;
+            case 2:  gemv_rows<T, 2>(&a[r * lda], lda, x, &y[r], cols); break;
+            case 1:  gemv_rows<T, 1>(&a[r * lda], lda, x, &y[r], cols); break;
+            default: break;
+        }
+    }
+
+    // rows [0, rows) cut into threads contiguous ranges of whole blocks, the calling thread takes the first. A
+    // thread count of 0 (as hardware_concurrency may report) runs on the calling thread, and the workers are
+    // jthreads so those already started are joined if starting another throws
+    inline void split_rows(std::size_t const rows, std::size_t const threads, std::size_t const block, auto kernel)
+    {
+        std::size_t const n = std::max<std::size_t>(threads, 1);
+        std::size_t const per_thread = ((rows + (n * block) - 1) / (n * block)) * block;
+        if (n == 1 || per_thread >= rows) {
+            kernel(std::size_t(0), rows);
+            return;
+        }
+
+        std::vector<std::jthread> workers;
+        for (std::size_t first = per_thread; first < rows; first += per_thread) {
+            workers.emplace_back(kernel, first, std::min(rows, first + per_thread));
+        }
+        kernel(std::size_t(0), per_thread);
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+//-----------------------------------------------------------------------------
+//  gemv
+//-----------------------------------------------------------------------------
+    // y = A x for a rows x cols matrix stored densely in the given layout, y has rows elements
+    template<typename T>
+    requires (std::is_floating_point_v<T>)
+    void gemv(T const* a, T const* x, T* y, std::size_t const rows, std::size_t const cols,
+              matrix_layout const layout = matrix_layout::row_major, std::size_t const threads = 1)
+    {
+        if (layout == matrix_layout::row_major) {
+            split_rows(rows, threads, 4, [=](std::size_t const first, std::size_t const last) { gemv_rows(a, cols, x, y, first, last, cols); });
+        }
+        else {
+            split_rows(rows, threads, sizeof(native_register<T>) / sizeof(T), [=](std::size_t const first, std::size_t const last) { gemv_columns(a, rows, x, y, first, last, cols); });
+        }
+    }
+
+    // y = A^T x for the same rows x cols matrix, y has cols elements. The transpose of a row major matrix is the
+    // column major matrix in the same memory, so this is gemv with the layout and dimensions swapped
+    template<typename T>
+    requires (std::is_floating_point_v<T>)
+    void gemv_transposed(T const* a, T const* x, T* y, std::size_t const rows, std::size_t const cols,
+                         matrix_layout const layout = matrix_layout::row_major, std::size_t const threads = 1)
+    {
+        matrix_layout const swapped = layout == matrix_layout::row_major ? matrix_layout::column_major : matrix_layout::row_major;
+        gemv(a, x, y, cols, rows, swapped, threads);
+    }
+
+    // row major Rows x Cols matrix held in a simd::vector
+    template<std::size_t Rows, std::size_t Cols, typename T, typename ContA, typename ContX>
+    requires (std::is_floating_point_v<T>)
+    vector<T, Rows> gemv(vector<T, Rows * Cols, ContA> const& a, vector<T, Cols, ContX> const& x)
+    {
+        vector<T, Rows> result;
+        gemv(&a[0], &x[0], &result[0], Rows, Cols);
+        return result;
+    }
+
+    template<std::size_t Rows, std::size_t Cols, typename T, typename ContA, typename ContX>
+    requires (std::is_floating_point_v<T>)
+    vector<T, Cols> gemv_transposed(vector<T, Rows * Cols, ContA> const& a, vector<T, Rows, ContX> const& x)
+    {
+        vector<T, Cols> result;
+        gemv_transposed(&a[0], &x[0], &result[0], Rows, Cols);
+        return result;
+    }
+
+//-----------------------------------------------------------------------------
+//  register transposes
+//-----------------------------------------------------------------------------
+    // one round of unpacks: rows 2i and 2i + 1 interleaved, the low halves first and then the high halves. Repeated
+    // with element widths doubling, it leaves column j of the input in row bit_reverse(j)
+    template<std::size_t N>
+    std::array<__m128i, N> unpack_round(std::array<__m128i, N> const& r, auto lo, auto hi) {
+        return [&]<std::size_t... i>(std::index_sequence<i...>) {
+            return std::array<__m128i, N>{lo(r[2 * i], r[(2 * i) + 1])..., hi(r[2 * i], r[(2 * i) + 1])...};
+        }(std::make_index_sequence<N / 2>{});
+    }
+
+    template<std::size_t N>
+    constexpr std::size_t bit_reverse(std::size_t const j) {
+        std::size_t rev = 0;
+        for (std::size_t b = 1; b < N; b <<= 1) {
+            rev = (rev << 1) | ((j & b) != 0 ? 1 : 0);
+        }
+        return rev;
+    }
+
+    template<std::size_t N>
+    std::array<__m128i, N> bit_reverse_rows(std::array<__m128i, N> const& r) {
+        return [&]<std::size_t... i>(std::index_sequence<i...>) {
+            return std::array<__m128i, N>{r[bit_reverse<N>(i)]...};
+        }(std::make_index_sequence<N>{});
+    }
+
+    // N registers of N elements of type T, row i of the result is column i of the input
+    template<typename T, typename V, std::size_t N>
+    requires ((N * sizeof(T)) == sizeof(V))
+    std::array<V, N> transpose(std::array<V, N> const& r) {
+        if constexpr (std::is_same_v<V, __m128>) {
+            __m128 r0 = r[0], r1 = r[1], r2 = r[2], r3 = r[3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            return {r0, r1, r2, r3};
+        }
+        else if constexpr (std::is_same_v<V, __m128d>) {
+            return {_mm_unpacklo_pd(r[0], r[1]), _mm_unpackhi_pd(r[0], r[1])};
+        }
+        else if constexpr (std::is_same_v<V, __m128i> && sizeof(T) == 4) {
+            std::array<__m128, 4> const t = transpose<float, __m128>(std::array<__m128, 4>{
+                _mm_castsi128_ps(r[0]), _mm_castsi128_ps(r[1]), _mm_castsi128_ps(r[2]), _mm_castsi128_ps(r[3])});
+            return {_mm_castps_si128(t[0]), _mm_castps_si128(t[1]), _mm_castps_si128(t[2]), _mm_castps_si128(t[3])};
+        }
+        else if constexpr (std::is_same_v<V, __m128i> && sizeof(T) == 8) {
+            return {_mm_unpacklo_epi64(r[0], r[1]), _mm_unpackhi_epi64(r[0], r[1])};
+        }
+        else if constexpr (std::is_same_v<V, __m128i> && sizeof(T) == 2) {
+            auto t = unpack_round(r, [](__m128i a, __m128i b) { return _mm_unpacklo_epi16(a, b); }, [](__m128i a, __m128i b) { return _mm_unpackhi_epi16(a, b); });
+            t = unpack_round(t, [](__m128i a, __m128i b) { return _mm_unpacklo_epi32(a, b); }, [](__m128i a, __m128i b) { return _mm_unpackhi_epi32(a, b); });
+            t = unpack_round(t, [](__m128i a, __m128i b) { return _mm_unpacklo_epi64(a, b); }, [](__m128i a, __m128i b) { return _mm_unpackhi_epi64(a, b); });
+            return bit_reverse_rows(t);
+        }
+        else if constexpr (std::is_same_v<V, __m128i> && sizeof(T) == 1) {
+            auto t = unpack_round(r, [](__m128i a, __m128i b) { return _mm_unpacklo_epi8(a, b); }, [](__m128i a, __m128i b) { return _mm_unpackhi_epi8(a, b); });
+            t = unpack_round(t, [](__m128i a, __m128i b) { return _mm_unpacklo_epi16(a, b); }, [](__m128i a, __m128i b) { return _mm_unpackhi_epi16(a, b); });
+            t = unpack_round(t, [](__m128i a, __m128i b) { return _mm_unpacklo_epi32(a, b); }, [](__m128i a, __m128i b) { return _mm_unpackhi_epi32(a, b); });
+            t = unpack_round(t, [](__m128i a, __m128i b) { return _mm_unpacklo_epi64(a, b); }, [](__m128i a, __m128i b) { return _mm_unpackhi_epi64(a, b); });
+            return bit_reverse_rows(t);
+        }
+    #ifdef __AVX__
+        else if constexpr (std::is_same_v<V, __m256>) {
+            // 4x4 transposes in each 128bit lane, then the high lanes of rows i and the low lanes of rows i + 4 swapped
+            __m256 const t0 = _mm256_unpacklo_ps(r[0], r[1]);
+            __m256 const t1 = _mm256_unpackhi_ps(r[0], r[1]);
+            __m256 const t2 = _mm256_unpacklo_ps(r[2], r[3]);
+            __m256 const t3 = _mm256_unpackhi_ps(r[2], r[3]);
+            __m256 const t4 = _mm256_unpacklo_ps(r[4], r[5]);
+            __m256 const t5 = _mm256_unpackhi_ps(r[4], r[5]);
+            __m256 const t6 = _mm256_unpacklo_ps(r[6], r[7]);
+            __m256 const t7 = _mm256_unpackhi_ps(r[6], r[7]);
+            __m256 const u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 const u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 const u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 const u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 const u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 const u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 const u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 const u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+            return {_mm256_permute2f128_ps(u0, u4, 0x20), _mm256_permute2f128_ps(u1, u5, 0x20),             // AVX
+                    _mm256_permute2f128_ps(u2, u6, 0x20), _mm256_permute2f128_ps(u3, u7, 0x20),             // AVX
+                    _mm256_permute2f128_ps(u0, u4, 0x31), _mm256_permute2f128_ps(u1, u5, 0x31),             // AVX
+                    _mm256_permute2f128_ps(u2, u6, 0x31), _mm256_permute2f128_ps(u3, u7, 0x31)};            // AVX
+        }
+        else if constexpr (std::is_same_v<V, __m256i> && sizeof(T) == 4) {
+            return [&]<std::size_t... i>(std::index_sequence<i...>) {
+                std::array<__m256, 8> const t = transpose<float, __m256>(std::array<__m256, 8>{_mm256_castsi256_ps(r[i])...});
+                return std::array<__m256i, 8>{_mm256_castps_si256(t[i])...};
+            }(std::make_index_sequence<8>{});
+        }
+        else if constexpr (std::is_same_v<V, __m256i> && sizeof(T) == 8) {
+            std::array<__m256d, 4> const t = transpose<double, __m256d>(std::array<__m256d, 4>{
+                _mm256_castsi256_pd(r[0]), _mm256_castsi256_pd(r[1]), _mm256_castsi256_pd(r[2]), _mm256_castsi256_pd(r[3])});
+            return {_mm256_castpd_si256(t[0]), _mm256_castpd_si256(t[1]), _mm256_castpd_si256(t[2]), _mm256_castpd_si256(t[3])};
+        }
+        else if constexpr (std::is_same_v<V, __m256d>) {
+            __m256d const t0 = _mm256_unpacklo_pd(r[0], r[1]);
+            __m256d const t1 = _mm256_unpackhi_pd(r[0], r[1]);
+            __m256d const t2 = _mm256_unpacklo_pd(r[2], r[3]);
+            __m256d const t3 = _mm256_unpackhi_pd(r[2], r[3]);
+            return {_mm256_permute2f128_pd(t0, t2, 0x20), _mm256_permute2f128_pd(t1, t3, 0x20),             // AVX
+                    _mm256_permute2f128_pd(t0, t2, 0x31), _mm256_permute2f128_pd(t1, t3, 0x31)};           // AVX
+        }
+    #endif // __AVX__
+        else {
+            static_assert(sizeof(V) == 0, "no register transpose for this element and register type");
+        }
+    }
+
+    // side of the square tile the register transpose takes for elements of type T, and the register of one row
+    template<typename T>
+    constexpr std::size_t transpose_tile =
+#ifdef __AVX__
+        sizeof(T) == 1 ? 16 : sizeof(T) == 2 ? 8 : sizeof(T) == 4 ? 8 : 4;
+#else
+        sizeof(T) == 1 ? 16 : sizeof(T) == 2 ? 8 : sizeof(T) == 4 ? 4 : 2;
+#endif // __AVX__
+
+    template<typename T>
+    using transpose_register =
+#ifdef __AVX__
+        std::conditional_t<sizeof(T) == 8, __m256d, std::conditional_t<sizeof(T) == 4, __m256, __m128i>>;
+#else
+        std::conditional_t<sizeof(T) == 8, __m128d, std::conditional_t<sizeof(T) == 4, __m128, __m128i>>;
+#endif // __AVX__
+
+    // the tile whose rows start at in, in_stride elements apart, written as columns starting at out. Elements are
+    // only moved, so ints go through float registers as well
+    template<typename T>
+    void transpose_tile_at(T const* in, std::size_t const in_stride, T* out, std::size_t const out_stride)
+    {
+        using V = transpose_register<T>;
+        [&]<std::size_t... i>(std::index_sequence<i...>) {
+            std::array<V, sizeof...(i)> const rows = transpose<T, V>(std::array<V, sizeof...(i)>{load<V>(in + (i * in_stride))...});
+            (store<V>(out + (i * out_stride), rows[i]), ...);
+        }(std::make_index_sequence<transpose_tile<T>>{});
+    }
+
+//-----------------------------------------------------------------------------
+//  transpose
+//-----------------------------------------------------------------------------
+    // out (cols x rows) = in (rows x cols) transposed, both row major, out may not be in. Blocks of at most 8KB are
+    // done tile by tile, the edges that do not fill a tile element by element
+    template<typename T>
+    requires (std::is_trivially_copyable_v<T> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8))
+    void transpose(T const* in, T* out, std::size_t const rows, std::size_t const cols)
+    {
+        constexpr std::size_t B = transpose_tile<T>;
+        constexpr std::size_t block = sizeof(T) <= 2 ? 64 : 32;
+
+        for (std::size_t rb = 0; rb < rows; rb += block) {
+            std::size_t const r_end = std::min(rows, rb + block);
+            for (std::size_t cb = 0; cb < cols; cb += block) {
+                std::size_t const c_end = std::min(cols, cb + block);
+                std::size_t r = rb;
+                for (; r + B <= r_end; r += B) {
+                    std::size_t c = cb;
+                    for (; c + B <= c_end; c += B) {
+                        transpose_tile_at(&in[(r * cols) + c], cols, &out[(c * rows) + r], rows);
+                    }
+                    for (; c < c_end; ++c) {
+                        for (std::size_t k = r; k < r + B; ++k) {
+                            out[(c * rows) + k] = in[(k * cols) + c];
+                        }
+                    }
+                }
+                for (; r < r_end; ++r) {
+                    for (std::size_t c = cb; c < c_end; ++c) {
+                        out[(c * rows) + r] = in[(r * cols) + c];
+                    }
+                }
+            }
+        }
+    }
+
+    // row major Rows x Cols matrix held in a simd::vector, the result is Cols x Rows
+    template<std::size_t Rows, std::size_t Cols, typename T, typename Cont>
+    vector<T, Rows * Cols> transpose(vector<T, Rows * Cols, Cont> const& a)
+    {
+        vector<T, Rows * Cols> result;
+        transpose(&a[0], &result[0], Rows, Cols);
+        return result;
+    }
+}
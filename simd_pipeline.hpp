@@ -0,0 +1,193 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Cache tiled pipelines of elementwise stages. Rather than every stage streaming the whole array through memory,
+ *  the array is cut into tiles small enough to stay in L1 and each tile passes through every stage, and optionally
+ *  a final reduction, before the next tile is loaded.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    // a tile is read from the input and written to the output (or a scratch tile), so two tiles share a 32KB L1
+    constexpr std::size_t pipeline_tile_bytes = 16 * 1024;
+
+//-----------------------------------------------------------------------------
+//  stages
+//-----------------------------------------------------------------------------
+    // each stage maps a register and, for the tail of a tile, a single element
+    template<typename T>
+    struct scale {
+        T value;
+
+        template<typename V>
+        V operator()(V const a) const { return mul<T, V>(a, set<T, V>(value)); }
+        T operator()(T const a) const { return a * value; }
+    };
+
+    template<typename T>
+    struct offset {
+        T value;
+
+        template<typename V>
+        V operator()(V const a) const { return add<T, V>(a, set<T, V>(value)); }
+        T operator()(T const a) const { return a + value; }
+    };
+
+    template<typename T>
+    struct clamp {
+        T lo;
+        T hi;
+
+        template<typename V>
+        V operator()(V const a) const { return min<T, V>(max<T, V>(a, set<T, V>(lo)), set<T, V>(hi)); }
+        T operator()(T const a) const { return std::min(std::max(a, lo), hi); }
+    };
+
+//-----------------------------------------------------------------------------
+//  reductions
+//-----------------------------------------------------------------------------
+    // each reduction provides the value that leaves the other operand unchanged, the register and the scalar op
+    template<typename T>
+    struct plus {
+        static constexpr T identity = T(0);
+
+        template<typename V>
+        V operator()(V const a, V const b) const { return add<T, V>(a, b); }
+        T operator()(T const a, T const b) const { return a + b; }
+    };
+
+    template<typename T>
+    struct minimum {
+        static constexpr T identity = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                                           : std::numeric_limits<T>::max();
+
+        template<typename V>
+        V operator()(V const a, V const b) const { return min<T, V>(a, b); }
+        T operator()(T const a, T const b) const { return std::min(a, b); }
+    };
+
+    template<typename T>
+    struct maximum {
+        static constexpr T identity = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                                           : std::numeric_limits<T>::lowest();
+
+        template<typename V>
+        V operator()(V const a, V const b) const { return max<T, V>(a, b); }
+        T operator()(T const a, T const b) const { return std::max(a, b); }
+    };
+
+//-----------------------------------------------------------------------------
+//  pipeline
+//-----------------------------------------------------------------------------
+    template<typename... Stages>
+    class pipeline {
+    public:
+        constexpr explicit pipeline(Stages... stages) : steps(stages...) {}
+
+        // out = stages(in), in and out may be the same array
+        template<typename T>
+        void transform(T const* in, T* out, std::size_t const n) const
+        {
+            constexpr std::size_t tile = pipeline_tile_bytes / sizeof(T);
+
+            for (std::size_t t = 0; t < n; t += tile) {
+                run_tile(in + t, out + t, std::min(tile, n - t));
+            }
+        }
+
+        template<typename T, std::size_t N, typename ContA, typename ContB>
+        void transform(vector<T, N, ContA> const& in, vector<T, N, ContB>& out) const
+        {
+            transform(&in[0], &out[0], N);
+        }
+
+        // reduction of stages(in), the staged tile lives in a scratch tile so nothing is written back to memory
+        template<typename T, typename Reducer>
+        T reduce(T const* in, std::size_t const n, Reducer const& reducer) const
+        {
+            using V = native_register<T>;
+            constexpr std::size_t VN = sizeof(V) / sizeof(T);
+            constexpr std::size_t tile = pipeline_tile_bytes / sizeof(T);
+            alignas(64) std::array<T, tile> scratch;
+
+            V acc1 = set<T, V>(Reducer::identity);
+            V acc2 = acc1;
+            T result = Reducer::identity;
+
+            for (std::size_t t = 0; t < n; t += tile) {
+                std::size_t const len = std::min(tile, n - t);
+                T const* src = in + t;
+                if constexpr (sizeof...(Stages) != 0) {
+                    run_tile(src, scratch.data(), len);
+                    src = scratch.data();
+                }
+
+                std::size_t i = 0;
+                for (; i + (VN * 2) <= len; i += (VN * 2)) {
+                    acc1 = reducer(acc1, load<V>(&src[i]));
+                    acc2 = reducer(acc2, load<V>(&src[i + VN]));
+                }
+                for (; i < len; i++) {
+                    result = reducer(result, src[i]);
+                }
+            }
+
+            alignas(64) std::array<T, VN> lanes;
+            store<V>(lanes.data(), reducer(acc1, acc2));
+            for (std::size_t l = 0; l < VN; ++l) {
+                result = reducer(result, lanes[l]);
+            }
+            return result;
+        }
+
+        template<typename T, std::size_t N, typename Cont, typename Reducer>
+        T reduce(vector<T, N, Cont> const& in, Reducer const& reducer) const
+        {
+            return reduce(&in[0], N, reducer);
+        }
+
+    private:
+        // the first stage reads the input, the rest work in place on the output tile while it is still in L1
+        template<typename T>
+        void run_tile(T const* in, T* out, std::size_t const len) const
+        {
+            if constexpr (sizeof...(Stages) == 0) {
+                std::copy_n(in, len, out);
+            }
+            else {
+                std::apply([&](auto const&... stage) { ((stage_loop(in, out, len, stage), in = out), ...); }, steps);
+            }
+        }
+
+        template<typename T, typename Stage>
+        static void stage_loop(T const* in, T* out, std::size_t const len, Stage const& stage)
+        {
+            using V = native_register<T>;
+            constexpr std::size_t VN = sizeof(V) / sizeof(T);
+            std::size_t i = 0;
+
+            for (; i + (VN * 2) <= len; i += (VN * 2)) {
+                V const a1 = load<V>(&in[i]);
+                V const a2 = load<V>(&in[i + VN]);
+                store<V>(&out[i], stage(a1));
+                store<V>(&out[i + VN], stage(a2));
+            }
+            for (; i < len; i++) {
+                out[i] = stage(in[i]);
+            }
+        }
+
+        std::tuple<Stages...> steps;
+    };
+}
@@ -0,0 +1,205 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Polynomial and rational function evaluation over arrays. Coefficients are given highest degree first, like numpy's
+ *  polyval, either as a template argument pack or as a std::array whose size fixes the degree. Both are unrolled at
+ *  compile time into fmadd chains: Horner's form by default, or Estrin's form, which evaluates pairs of terms
+ *  independently and so has a dependency chain of log2(degree) fmadds instead of degree.
+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    enum class poly_form {
+        horner,
+        estrin
+    };
+
+    // compile time coefficients of one side of a rational function, highest degree first
+    template<auto... Coeffs>
+    struct poly {
+        static constexpr std::size_t size = sizeof...(Coeffs);
+
+        template<typename T>
+        static constexpr std::array<T, sizeof...(Coeffs)> as = {static_cast<T>(Coeffs)...};
+    };
+
+//-----------------------------------------------------------------------------
+//  register kernels
+//-----------------------------------------------------------------------------
+    template<typename T, typename V, std::size_t K>
+    V horner(V const x, std::array<T, K> const& c) {
+        V acc = set<T, V>(c[0]);
+        [&]<std::size_t... k>(std::index_sequence<k...>) {
+            ((acc = fmadd<T, V>(acc, x, set<T, V>(c[k + 1]))), ...);
+        }(std::make_index_sequence<K - 1>{});
+        return acc;
+    }
+
+    // terms[j] is the coefficient of xp^j, each level folds neighbouring pairs and squares xp
+    template<typename T, typename V, std::size_t M>
+    V estrin_level(std::array<V, M> const& terms, V const xp) {
+        if constexpr (M == 1) {
+            return terms[0];
+        }
+        else {
+            std::array<V, (M + 1) / 2> next;
+            [&]<std::size_t... j>(std::index_sequence<j...>) {
+                ((next[j] = fmadd<T, V>(terms[(2 * j) + 1], xp, terms[2 * j])), ...);
+            }(std::make_index_sequence<M / 2>{});
+            if constexpr ((M % 2) != 0) {
+                next[M / 2] = terms[M - 1];
+            }
+            return estrin_level<T, V, (M + 1) / 2>(next, mul<T, V>(xp, xp));
+        }
+    }
+
+    template<typename T, typename V, std::size_t K>
+    V estrin(V const x, std::array<T, K> const& c) {
+        std::array<V, K> terms;
+        [&]<std::size_t... k>(std::index_sequence<k...>) {
+            ((terms[k] = set<T, V>(c[K - 1 - k])), ...);
+        }(std::make_index_sequence<K>{});
+        return estrin_level<T, V, K>(terms, x);
+    }
+
+    // the scalar tail, without masked moves, always in Horner's form
+    template<typename T, std::size_t K>
+    T horner(T const x, std::array<T, K> const& c) {
+        T acc = c[0];
+        for (std::size_t k = 1; k < K; ++k) {
+        #ifdef __FMA__
+            acc = std::fma(acc, x, c[k]);
+        #else
+            acc = acc * x + c[k];
+        #endif // __FMA__
+        }
+        return acc;
+    }
+
+//-----------------------------------------------------------------------------
+//  evaluation loops
+//-----------------------------------------------------------------------------
+    // out[i] = f(in[i]) a register at a time, the last partial register masked where the register type allows
+    template<typename T>
+    void poly_loop(T const* in, T* out, std::size_t const n, auto register_f, auto scalar_f)
+    {
+        using V = native_register<T>;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        std::size_t i = 0;
+
+        for (; i + (VN * 2) <= n; i += (VN * 2)) {
+            V const x1 = load<V>(&in[i]);
+            V const x2 = load<V>(&in[i + VN]);
+            store<V>(&out[i], register_f(x1));
+            store<V>(&out[i + VN], register_f(x2));
+        }
+        for (; i + VN <= n; i += VN) {
+            store<V>(&out[i], register_f(load<V>(&in[i])));
+        }
+        if constexpr (has_partial<T, V>) {
+            if (i < n) {
+                // the unused lanes repeat the first remaining input rather than load_partial's 1, which may be a
+                // root of q: a rational function then only divides by zero there if that input does so itself
+                alignas(64) std::array<T, VN> x;
+                x.fill(in[i]);
+                std::copy(&in[i], &in[n], x.data());
+                store_partial<T, V>(&out[i], register_f(load<V>(x.data())), n - i);
+                i = n;
+            }
+        }
+        for (; i < n; i++) {
+            out[i] = scalar_f(in[i]);
+        }
+    }
+
+    // out = p(in), out may be in
+    template<typename T, std::size_t K>
+    requires (std::is_floating_point_v<T> && K > 0)
+    void polyval(std::array<T, K> const& c, T const* in, T* out, std::size_t const n, poly_form const form = poly_form::horner)
+    {
+        using V = native_register<T>;
+        auto const scalar_f = [&c](T const x) { return horner(x, c); };
+
+        if (form == poly_form::estrin) {
+            poly_loop(in, out, n, [&c](V const x) { return estrin<T, V>(x, c); }, scalar_f);
+        }
+        else {
+            poly_loop(in, out, n, [&c](V const x) { return horner<T, V>(x, c); }, scalar_f);
+        }
+    }
+
+    // out = p(in) / q(in), both numerator and denominator in the same form
+    template<typename T, std::size_t KP, std::size_t KQ>
+    requires (std::is_floating_point_v<T> && KP > 0 && KQ > 0)
+    void ratval(std::array<T, KP> const& p, std::array<T, KQ> const& q, T const* in, T* out, std::size_t const n,
+                poly_form const form = poly_form::horner)
+    {
+        using V = native_register<T>;
+        auto const scalar_f = [&p, &q](T const x) { return horner(x, p) / horner(x, q); };
+
+        if (form == poly_form::estrin) {
+            poly_loop(in, out, n, [&p, &q](V const x) { return div<T, V>(estrin<T, V>(x, p), estrin<T, V>(x, q)); }, scalar_f);
+        }
+        else {
+            poly_loop(in, out, n, [&p, &q](V const x) { return div<T, V>(horner<T, V>(x, p), horner<T, V>(x, q)); }, scalar_f);
+        }
+    }
+
+//-----------------------------------------------------------------------------
+//  vectors
+//-----------------------------------------------------------------------------
+    template<typename T, std::size_t K, std::size_t N, typename Cont>
+    vector<T, N> polyval(std::array<T, K> const& c, vector<T, N, Cont> const& x, poly_form const form = poly_form::horner)
+    {
+        vector<T, N> result;
+        polyval(c, &x[0], &result[0], N, form);
+        return result;
+    }
+
+    template<typename T, std::size_t KP, std::size_t KQ, std::size_t N, typename Cont>
+    vector<T, N> ratval(std::array<T, KP> const& p, std::array<T, KQ> const& q, vector<T, N, Cont> const& x,
+                        poly_form const form = poly_form::horner)
+    {
+        vector<T, N> result;
+        ratval(p, q, &x[0], &result[0], N, form);
+        return result;
+    }
+
+    // simd::polyval<c0, c1, c2>(x) for c0 x^2 + c1 x + c2, the coefficients converted to the element type of x
+    template<auto... Coeffs, typename T, std::size_t N, typename Cont>
+    requires (sizeof...(Coeffs) > 0 && (std::is_arithmetic_v<decltype(Coeffs)> && ...))
+    vector<T, N> polyval(vector<T, N, Cont> const& x, poly_form const form = poly_form::horner)
+    {
+        return polyval(poly<Coeffs...>::template as<T>, x, form);
+    }
+
+    template<auto... Coeffs, typename T>
+    requires (sizeof...(Coeffs) > 0 && (std::is_arithmetic_v<decltype(Coeffs)> && ...))
+    void polyval(T const* in, T* out, std::size_t const n, poly_form const form = poly_form::horner)
+    {
+        polyval(poly<Coeffs...>::template as<T>, in, out, n, form);
+    }
+
+    // simd::ratval<simd::poly<p...>, simd::poly<q...>>(x)
+    template<typename P, typename Q, typename T, std::size_t N, typename Cont>
+    vector<T, N> ratval(vector<T, N, Cont> const& x, poly_form const form = poly_form::horner)
+    {
+        return ratval(P::template as<T>, Q::template as<T>, x, form);
+    }
+
+    template<typename P, typename Q, typename T>
+    void ratval(T const* in, T* out, std::size_t const n, poly_form const form = poly_form::horner)
+    {
+        ratval(P::template as<T>, Q::template as<T>, in, out, n, form);
+    }
+}
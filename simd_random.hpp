@@ -0,0 +1,535 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Random number generation a register of independent streams at a time. xoshiro256++ keeps 8 lanes of state, each
+ *  lane 2^128 steps ahead of the one before, and is the fastest source of bits. philox4x32-10 is counter based: word
+ *  w of (seed, stream) is a pure function of the three, so streams can be generated in parallel, skipped ahead with
+ *  seek and reproduced exactly. Both give the same words with or without AVX2 and however a fill is split up.
+ *
+ *  The fill functions turn words into uniform integers (multiply-shift), uniform floats (random mantissa bits under
+ *  the exponent of 1.0) and normal floats (Box-Muller, with float log and sincos kernels).
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_polynomial.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    // anything that can write n random 32bit words
+    template<typename E>
+    concept random_engine = requires(E& e, std::uint32_t* out, std::size_t n) { e.fill(out, n); };
+
+//-----------------------------------------------------------------------------
+//  xoshiro256++
+//-----------------------------------------------------------------------------
+    class xoshiro256pp {
+    public:
+        static constexpr std::size_t lanes = 8;
+
+        // lane 0 is seeded from splitmix64(seed) as the reference implementation suggests, lane k + 1 is lane k jumped
+        // ahead by 2^128 steps
+        explicit xoshiro256pp(std::uint64_t seed)
+        {
+            std::array<std::uint64_t, 4> lane;
+            for (auto& w : lane) {
+                seed += 0x9E3779B97F4A7C15ull;
+                std::uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                w = z ^ (z >> 31);
+            }
+            for (std::size_t l = 0; l < lanes; ++l) {
+                for (std::size_t w = 0; w < 4; ++w) {
+                    state[w][l] = lane[w];
+                }
+                jump(lane);
+            }
+        }
+
+        // moves every lane 2^128 * lanes steps ahead, past the start of the next lane, for another set of streams
+        void jump()
+        {
+            for (std::size_t l = 0; l < lanes; ++l) {
+                std::array<std::uint64_t, 4> lane = {state[0][l], state[1][l], state[2][l], state[3][l]};
+                for (std::size_t k = 0; k < lanes; ++k) {
+                    jump(lane);
+                }
+                for (std::size_t w = 0; w < 4; ++w) {
+                    state[w][l] = lane[w];
+                }
+            }
+            used = pending.size();
+        }
+
+        // each step gives one 64bit word per lane, in lane order, split into its low and high 32 bits
+        void fill(std::uint32_t* out, std::size_t const n)
+        {
+            std::size_t i = 0;
+            for (; i < n && used < pending.size(); i++) {
+                out[i] = pending[used++];
+            }
+
+        #ifdef __AVX2__
+            if (i + (lanes * 2) <= n) {
+                std::array<__m256i, 4> a;
+                std::array<__m256i, 4> b;
+                for (std::size_t w = 0; w < 4; ++w) {
+                    a[w] = _mm256_load_si256((__m256i const*)&state[w][0]);
+                    b[w] = _mm256_load_si256((__m256i const*)&state[w][4]);
+                }
+                for (; i + (lanes * 2) <= n; i += (lanes * 2)) {
+                    _mm256_storeu_si256((__m256i_u*)&out[i], step(a)); // AVX
+                    _mm256_storeu_si256((__m256i_u*)&out[i + 8], step(b)); // AVX
+                }
+                for (std::size_t w = 0; w < 4; ++w) {
+                    _mm256_store_si256((__m256i*)&state[w][0], a[w]);
+                    _mm256_store_si256((__m256i*)&state[w][4], b[w]);
+                }
+            }
+        #endif // __AVX2__
+            for (; i + (lanes * 2) <= n; i += (lanes * 2)) {
+                step(&out[i]);
+            }
+
+            if (i < n) {
+                step(pending.data());
+                used = 0;
+                for (; i < n; i++) {
+                    out[i] = pending[used++];
+                }
+            }
+        }
+
+    private:
+        static constexpr std::uint64_t rotl(std::uint64_t const x, int const k) { return (x << k) | (x >> (64 - k)); }
+
+        static void next(std::array<std::uint64_t, 4>& s)
+        {
+            std::uint64_t const t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+        }
+
+        static void jump(std::array<std::uint64_t, 4>& s)
+        {
+            constexpr std::array<std::uint64_t, 4> poly = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+            std::array<std::uint64_t, 4> result = {};
+            for (std::uint64_t const p : poly) {
+                for (int b = 0; b < 64; ++b) {
+                    if ((p & (std::uint64_t(1) << b)) != 0) {
+                        for (std::size_t w = 0; w < 4; ++w) {
+                            result[w] ^= s[w];
+                        }
+                    }
+                    next(s);
+                }
+            }
+            s = result;
+        }
+
+        void step(std::uint32_t* out)
+        {
+            for (std::size_t l = 0; l < lanes; ++l) {
+                std::array<std::uint64_t, 4> s = {state[0][l], state[1][l], state[2][l], state[3][l]};
+                std::uint64_t const result = rotl(s[0] + s[3], 23) + s[0];
+                next(s);
+                for (std::size_t w = 0; w < 4; ++w) {
+                    state[w][l] = s[w];
+                }
+                out[2 * l] = static_cast<std::uint32_t>(result);
+                out[(2 * l) + 1] = static_cast<std::uint32_t>(result >> 32);
+            }
+        }
+
+    #ifdef __AVX2__
+        template<int K>
+        static __m256i rotl(__m256i const x) {
+        #ifdef __AVX512VL__
+            return _mm256_rol_epi64(x, K); // AVX512F + AVX512VL
+        #else
+            return _mm256_or_si256(_mm256_slli_epi64(x, K), _mm256_srli_epi64(x, 64 - K)); // AVX2
+        #endif // __AVX512VL__
+        }
+
+        static __m256i step(std::array<__m256i, 4>& s)
+        {
+            __m256i const result = _mm256_add_epi64(rotl<23>(_mm256_add_epi64(s[0], s[3])), s[0]); // AVX2
+            __m256i const t = _mm256_slli_epi64(s[1], 17); // AVX2
+            s[2] = _mm256_xor_si256(s[2], s[0]);
+            s[3] = _mm256_xor_si256(s[3], s[1]);
+            s[1] = _mm256_xor_si256(s[1], s[2]);
+            s[0] = _mm256_xor_si256(s[0], s[3]);
+            s[2] = _mm256_xor_si256(s[2], t);
+            s[3] = rotl<45>(s[3]);
+            return result;
+        }
+    #endif // __AVX2__
+
+        alignas(32) std::array<std::array<std::uint64_t, lanes>, 4> state;
+        std::array<std::uint32_t, lanes * 2> pending = {};
+        std::size_t used = lanes * 2;
+    };
+
+//-----------------------------------------------------------------------------
+//  philox4x32-10
+//-----------------------------------------------------------------------------
+    class philox4x32 {
+    public:
+        // the seed is the 64bit key, the stream the upper half of the 128bit counter and the block the lower half
+        explicit philox4x32(std::uint64_t const seed, std::uint64_t const stream = 0) : seed(seed), stream(stream) {}
+
+        // the next fill starts at word w of the stream
+        void seek(std::uint64_t const w) { position = w; }
+
+        std::uint64_t tell() const { return position; }
+
+        // the four words of one block, as in the Random123 reference
+        std::array<std::uint32_t, 4> block(std::uint64_t const b) const
+        {
+            std::array<std::uint32_t, 4> c = {static_cast<std::uint32_t>(b), static_cast<std::uint32_t>(b >> 32),
+                                              static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)};
+            std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+            std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+            for (int r = 0; r < 10; ++r) {
+                std::uint64_t const p0 = std::uint64_t(m0) * c[0];
+                std::uint64_t const p1 = std::uint64_t(m1) * c[2];
+                c = {static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k0, static_cast<std::uint32_t>(p1),
+                     static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k1, static_cast<std::uint32_t>(p0)};
+                k0 += w0;
+                k1 += w1;
+            }
+            return c;
+        }
+
+        void fill(std::uint32_t* out, std::size_t const n)
+        {
+            std::size_t i = 0;
+            for (; i < n && (position % 4) != 0; i++, position++) {
+                out[i] = block(position / 4)[position % 4];
+            }
+
+        #ifdef __AVX2__
+            // 8 blocks per iteration, word j of each block in register j
+            for (; i + 32 <= n; i += 32, position += 32) {
+                std::array<__m256i, 4> c = counters(position / 4);
+                __m256i k0 = _mm256_set1_epi32(static_cast<int>(seed));
+                __m256i k1 = _mm256_set1_epi32(static_cast<int>(seed >> 32));
+                for (int r = 0; r < 10; ++r) {
+                    auto const [hi0, lo0] = mulhilo(_mm256_set1_epi32(static_cast<int>(m0)), c[0]);
+                    auto const [hi1, lo1] = mulhilo(_mm256_set1_epi32(static_cast<int>(m1)), c[2]);
+                    c = {_mm256_xor_si256(_mm256_xor_si256(hi1, c[1]), k0), lo1, _mm256_xor_si256(_mm256_xor_si256(hi0, c[3]), k1), lo0};
+                    k0 = _mm256_add_epi32(k0, _mm256_set1_epi32(static_cast<int>(w0)));
+                    k1 = _mm256_add_epi32(k1, _mm256_set1_epi32(static_cast<int>(w1)));
+                }
+
+                // 4x4 transposes in each 128bit lane give blocks 0 and 4, 1 and 5, 2 and 6, 3 and 7
+                __m256i const t0 = _mm256_unpacklo_epi32(c[0], c[1]); // AVX2
+                __m256i const t1 = _mm256_unpacklo_epi32(c[2], c[3]); // AVX2
+                __m256i const t2 = _mm256_unpackhi_epi32(c[0], c[1]); // AVX2
+                __m256i const t3 = _mm256_unpackhi_epi32(c[2], c[3]); // AVX2
+                __m256i const b04 = _mm256_unpacklo_epi64(t0, t1); // AVX2
+                __m256i const b15 = _mm256_unpackhi_epi64(t0, t1); // AVX2
+                __m256i const b26 = _mm256_unpacklo_epi64(t2, t3); // AVX2
+                __m256i const b37 = _mm256_unpackhi_epi64(t2, t3); // AVX2
+                _mm256_storeu_si256((__m256i_u*)&out[i], _mm256_permute2x128_si256(b04, b15, 0x20)); // AVX2
+                _mm256_storeu_si256((__m256i_u*)&out[i + 8], _mm256_permute2x128_si256(b26, b37, 0x20)); // AVX2
+                _mm256_storeu_si256((__m256i_u*)&out[i + 16], _mm256_permute2x128_si256(b04, b15, 0x31)); // AVX2
+                _mm256_storeu_si256((__m256i_u*)&out[i + 24], _mm256_permute2x128_si256(b26, b37, 0x31)); // AVX2
+            }
+        #endif // __AVX2__
+            for (; i + 4 <= n; i += 4, position += 4) {
+                std::array<std::uint32_t, 4> const c = block(position / 4);
+                std::copy_n(c.data(), 4, &out[i]);
+            }
+            for (; i < n; i++, position++) {
+                out[i] = block(position / 4)[position % 4];
+            }
+        }
+
+    private:
+        static constexpr std::uint32_t m0 = 0xD2511F53;
+        static constexpr std::uint32_t m1 = 0xCD9E8D57;
+        static constexpr std::uint32_t w0 = 0x9E3779B9;
+        static constexpr std::uint32_t w1 = 0xBB67AE85;
+
+    #ifdef __AVX2__
+        // the high and low halves of the 32x32 bit products, the even lanes from one multiply and the odd from another
+        static std::array<__m256i, 2> mulhilo(__m256i const m, __m256i const x)
+        {
+            __m256i const even = _mm256_mul_epu32(m, x); // AVX2
+            __m256i const odd = _mm256_mul_epu32(m, _mm256_srli_epi64(x, 32)); // AVX2
+            return {_mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA), _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA)}; // AVX2
+        }
+
+        // blocks b to b + 7, the carry out of the low word of the block number into the high one done per lane
+        std::array<__m256i, 4> counters(std::uint64_t const b) const
+        {
+            __m256i const lo = _mm256_set1_epi32(static_cast<int>(b));
+            __m256i const c0 = _mm256_add_epi32(lo, _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            __m256i const sign = _mm256_set1_epi32(INT32_MIN);
+            __m256i const carry = _mm256_cmpgt_epi32(_mm256_xor_si256(lo, sign), _mm256_xor_si256(c0, sign)); // AVX2
+            return {c0, _mm256_sub_epi32(_mm256_set1_epi32(static_cast<int>(b >> 32)), carry),
+                    _mm256_set1_epi32(static_cast<int>(stream)), _mm256_set1_epi32(static_cast<int>(stream >> 32))};
+        }
+    #endif // __AVX2__
+
+        std::uint64_t seed;
+        std::uint64_t stream;
+        std::uint64_t position = 0;
+    };
+
+//-----------------------------------------------------------------------------
+//  transcendental kernels
+//-----------------------------------------------------------------------------
+    // the scalar tails use std::log, std::sin and std::cos, so the lanes of a register and the tail may differ in
+    // the last bit
+#ifdef __AVX2__
+    // natural log of positive normal floats, the cephes logf reduction to a mantissa in [sqrt(0.5), sqrt(2)) and its
+    // degree 8 polynomial
+    inline __m256 log_ps(__m256 const x)
+    {
+        constexpr std::array<float, 9> p = {7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f, 1.4249322787e-1f,
+                                            -1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f};
+        __m256i const bits = _mm256_castps_si256(x);
+        __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126))); // AVX2
+        __m256 const m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F000000)));
+        __m256 const small = _mm256_cmp_ps(m, _mm256_set1_ps(0.70710678f), _CMP_LT_OQ); // AVX
+        __m256 const one = _mm256_set1_ps(1.0f);
+        e = _mm256_sub_ps(e, _mm256_and_ps(small, one));
+        __m256 const t = _mm256_add_ps(_mm256_sub_ps(m, one), _mm256_and_ps(small, m));
+        __m256 const z = _mm256_mul_ps(t, t);
+        __m256 y = _mm256_mul_ps(_mm256_mul_ps(horner<float, __m256>(t, p), t), z);
+        y = fmadd<float, __m256>(e, _mm256_set1_ps(-2.12194440e-4f), y);
+        y = fmadd<float, __m256>(z, _mm256_set1_ps(-0.5f), y);
+        return fmadd<float, __m256>(e, _mm256_set1_ps(0.693359375f), _mm256_add_ps(t, y));
+    }
+
+    // sin and cos of 2 pi u for u in [0, 1): the nearest quarter turn q is taken out exactly, the remaining angle in
+    // [-pi/4, pi/4] goes through the cephes polynomials, and q swaps and negates the two
+    inline std::array<__m256, 2> sincos_turns_ps(__m256 const u)
+    {
+        constexpr std::array<float, 3> sp = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+        constexpr std::array<float, 3> cp = {2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f};
+        __m256 const q = _mm256_round_ps(_mm256_mul_ps(u, _mm256_set1_ps(4.0f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); // AVX
+        __m256 const a = _mm256_mul_ps(fmadd<float, __m256>(q, _mm256_set1_ps(-0.25f), u), _mm256_set1_ps(2.0f * std::numbers::pi_v<float>));
+        __m256 const z = _mm256_mul_ps(a, a);
+        __m256 const s = fmadd<float, __m256>(_mm256_mul_ps(a, z), horner<float, __m256>(z, sp), a);
+        __m256 const c = fmadd<float, __m256>(_mm256_mul_ps(z, z), horner<float, __m256>(z, cp), fmadd<float, __m256>(z, _mm256_set1_ps(-0.5f), _mm256_set1_ps(1.0f)));
+
+        __m256i const qi = _mm256_cvtps_epi32(q);
+        __m256 const swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(qi, _mm256_set1_epi32(1)), _mm256_set1_epi32(1))); // AVX2
+        __m256 const sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(qi, _mm256_set1_epi32(2)), 30)); // AVX2
+        __m256 const cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(qi, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30)); // AVX2
+        return {_mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sin_sign), _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cos_sign)}; // AVX
+    }
+#endif // __AVX2__
+
+//-----------------------------------------------------------------------------
+//  distributions
+//-----------------------------------------------------------------------------
+    // words are generated this many at a time into a buffer that stays in L1 and then transformed
+    constexpr std::size_t random_chunk = 512;
+
+    // 23 or 52 random mantissa bits under the exponent of 1.0 give [1, 2), minus 1 is [0, 1)
+    inline float unit_float(std::uint32_t const w) { return std::bit_cast<float>((w >> 9) | 0x3F800000u) - 1.0f; }
+    inline double unit_double(std::uint64_t const w) { return std::bit_cast<double>((w >> 12) | 0x3FF0000000000000ull) - 1.0; }
+
+    // integers are lo + (w * (hi - lo + 1)) >> 32 (or 64), biased by at most (hi - lo + 1) / 2^32 (or 2^64); floats
+    // are lo + u (hi - lo) for u in [0, 1)
+    template<typename T>
+    void uniform_block(std::uint32_t const* w, T* out, std::size_t const n, T const lo, T const hi)
+    {
+        std::size_t i = 0;
+        if constexpr (std::is_floating_point_v<T> && sizeof(T) == 8) {
+            for (; i < n; i++) {
+                std::uint64_t bits;
+                std::memcpy(&bits, &w[2 * i], sizeof(bits));
+                out[i] = lo + (unit_double(bits) * (hi - lo));
+            }
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+        #ifdef __AVX2__
+            __m256 const vlo = _mm256_set1_ps(lo);
+            __m256 const range = _mm256_set1_ps(hi - lo);
+            for (; i + 8 <= n; i += 8) {
+                __m256i const bits = _mm256_or_si256(_mm256_srli_epi32(_mm256_loadu_si256((__m256i_u*)&w[i]), 9), _mm256_set1_epi32(0x3F800000)); // AVX2
+                __m256 const u = _mm256_sub_ps(_mm256_castsi256_ps(bits), _mm256_set1_ps(1.0f));
+                _mm256_storeu_ps(&out[i], fmadd<float, __m256>(u, range, vlo));
+            }
+        #endif // __AVX2__
+            for (; i < n; i++) {
+                out[i] = lo + (unit_float(w[i]) * (hi - lo));
+            }
+        }
+        else if constexpr (sizeof(T) == 8) {
+            using U = std::make_unsigned_t<T>;
+            U const range = static_cast<U>(static_cast<U>(hi) - static_cast<U>(lo));
+            for (; i < n; i++) {
+                std::uint64_t bits;
+                std::memcpy(&bits, &w[2 * i], sizeof(bits));
+                U const offset = range == std::numeric_limits<U>::max() ? bits : static_cast<U>((static_cast<unsigned __int128>(bits) * (range + 1)) >> 64);
+                out[i] = static_cast<T>(static_cast<U>(lo) + offset);
+            }
+        }
+        else {
+            std::uint64_t const range = static_cast<std::uint64_t>(static_cast<std::int64_t>(hi) - static_cast<std::int64_t>(lo)) + 1;
+        #ifdef __AVX2__
+            if constexpr (sizeof(T) == 4) {
+                __m256i const vlo = _mm256_set1_epi32(static_cast<int>(lo));
+                __m256i const vrange = _mm256_set1_epi32(static_cast<int>(range));
+                for (; range <= std::numeric_limits<std::uint32_t>::max() && i + 8 <= n; i += 8) {
+                    __m256i const x = _mm256_loadu_si256((__m256i_u*)&w[i]);
+                    __m256i const even = _mm256_mul_epu32(x, vrange); // AVX2
+                    __m256i const odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), vrange); // AVX2
+                    __m256i const high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA); // AVX2
+                    _mm256_storeu_si256((__m256i_u*)&out[i], _mm256_add_epi32(high, vlo));
+                }
+            }
+        #endif // __AVX2__
+            for (; i < n; i++) {
+                std::uint64_t const offset = (static_cast<std::uint64_t>(w[i]) * range) >> 32;
+                out[i] = static_cast<T>(static_cast<std::int64_t>(lo) + static_cast<std::int64_t>(offset));
+            }
+        }
+    }
+
+    // Box-Muller on pairs of uniforms: r = sqrt(-2 log(1 - u1)), and r cos(2 pi u2), r sin(2 pi u2) are two
+    // independent normals. Doubles pair neighbouring words. Floats come in groups of 16 words, word k paired with
+    // word k + 8, the cosines going to the first 8 outputs and the sines to the last 8. Registers and scalar code
+    // pair the same words, and a group cut short by n still reads all 16. With 23 bits in u1 floats stop at about
+    // 5.6 standard deviations
+    template<typename T>
+    void normal_block(std::uint32_t const* w, T* out, std::size_t const n, T const mean, T const stddev)
+    {
+        std::size_t i = 0;
+        if constexpr (sizeof(T) == 8) {
+            for (; i < n; i += 2) {
+                std::uint64_t b1;
+                std::uint64_t b2;
+                std::memcpy(&b1, &w[2 * i], sizeof(b1));
+                std::memcpy(&b2, &w[(2 * i) + 2], sizeof(b2));
+                double const r = std::sqrt(-2.0 * std::log(1.0 - unit_double(b1)));
+                double const theta = 2.0 * std::numbers::pi * unit_double(b2);
+                out[i] = mean + (stddev * r * std::cos(theta));
+                if (i + 1 < n) {
+                    out[i + 1] = mean + (stddev * r * std::sin(theta));
+                }
+            }
+        }
+        else {
+        #ifdef __AVX2__
+            __m256 const vmean = _mm256_set1_ps(mean);
+            __m256 const vstddev = _mm256_set1_ps(stddev);
+            __m256 const one = _mm256_set1_ps(1.0f);
+            auto const group = [&](std::uint32_t const* g, float* o) {
+                __m256i const b1 = _mm256_or_si256(_mm256_srli_epi32(_mm256_loadu_si256((__m256i_u*)&g[0]), 9), _mm256_set1_epi32(0x3F800000)); // AVX2
+                __m256i const b2 = _mm256_or_si256(_mm256_srli_epi32(_mm256_loadu_si256((__m256i_u*)&g[8]), 9), _mm256_set1_epi32(0x3F800000)); // AVX2
+                __m256 const u1 = _mm256_sub_ps(_mm256_set1_ps(2.0f), _mm256_castsi256_ps(b1));
+                __m256 const u2 = _mm256_sub_ps(_mm256_castsi256_ps(b2), one);
+                __m256 const r = _mm256_mul_ps(_mm256_sqrt_ps(_mm256_mul_ps(log_ps(u1), _mm256_set1_ps(-2.0f))), vstddev);
+                auto const [s, c] = sincos_turns_ps(u2);
+                _mm256_storeu_ps(&o[0], fmadd<float, __m256>(r, c, vmean));
+                _mm256_storeu_ps(&o[8], fmadd<float, __m256>(r, s, vmean));
+            };
+            for (; i + 16 <= n; i += 16) {
+                group(&w[i], &out[i]);
+            }
+            if (i < n) {
+                std::array<float, 16> last;
+                group(&w[i], last.data());
+                std::copy_n(last.begin(), n - i, &out[i]);
+            }
+        #else
+            for (; i < n; i += 16) {
+                for (std::size_t k = 0; k < 8 && i + k < n; ++k) {
+                    float const r = std::sqrt(-2.0f * std::log(1.0f - unit_float(w[i + k])));
+                    float const theta = 2.0f * std::numbers::pi_v<float> * unit_float(w[i + k + 8]);
+                    out[i + k] = mean + (stddev * r * std::cos(theta));
+                    if (i + k + 8 < n) {
+                        out[i + k + 8] = mean + (stddev * r * std::sin(theta));
+                    }
+                }
+            }
+        #endif // __AVX2__
+        }
+    }
+
+    // integers in [lo, hi], floats in [lo, hi)
+    template<typename T>
+    requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+    void fill_uniform(random_engine auto& engine, T* out, std::size_t const n, std::type_identity_t<T> const lo = T(0),
+                      std::type_identity_t<T> const hi = std::is_floating_point_v<T> ? T(1) : std::numeric_limits<T>::max())
+    {
+        constexpr std::size_t words = sizeof(T) == 8 ? 2 : 1;
+        alignas(32) std::array<std::uint32_t, random_chunk> w;
+        for (std::size_t i = 0; i < n; i += random_chunk / words) {
+            std::size_t const m = std::min(n - i, random_chunk / words);
+            engine.fill(w.data(), m * words);
+            uniform_block(w.data(), &out[i], m, lo, hi);
+        }
+    }
+
+    // a normal distribution. The uniforms are drawn a whole group at a time, 16 words for floats and a pair of
+    // doubles, so a count that is not a multiple of the group uses up the rest of its last group. Filling in parts
+    // that are whole groups gives the same values as one fill
+    template<typename T>
+    requires (std::is_floating_point_v<T>)
+    void fill_normal(random_engine auto& engine, T* out, std::size_t const n, std::type_identity_t<T> const mean = T(0),
+                     std::type_identity_t<T> const stddev = T(1))
+    {
+        constexpr std::size_t words = sizeof(T) == 8 ? 2 : 1;
+        constexpr std::size_t group = sizeof(T) == 8 ? 2 : 16;
+        alignas(32) std::array<std::uint32_t, random_chunk> w;
+        for (std::size_t i = 0; i < n; i += random_chunk / words) {
+            std::size_t const m = std::min(n - i, random_chunk / words);
+            engine.fill(w.data(), ((m + group - 1) / group) * group * words);
+            normal_block(w.data(), &out[i], m, mean, stddev);
+        }
+    }
+
+    template<typename T, std::size_t Extent>
+    void fill_uniform(random_engine auto& engine, std::span<T, Extent> out, std::type_identity_t<T> const lo = T(0),
+                      std::type_identity_t<T> const hi = std::is_floating_point_v<T> ? T(1) : std::numeric_limits<T>::max())
+    {
+        fill_uniform(engine, out.data(), out.size(), lo, hi);
+    }
+
+    template<typename T, std::size_t Extent>
+    void fill_normal(random_engine auto& engine, std::span<T, Extent> out, std::type_identity_t<T> const mean = T(0),
+                     std::type_identity_t<T> const stddev = T(1))
+    {
+        fill_normal(engine, out.data(), out.size(), mean, stddev);
+    }
+
+    template<typename T, std::size_t N, typename Cont>
+    void fill_uniform(random_engine auto& engine, vector<T, N, Cont>& out, std::type_identity_t<T> const lo = T(0),
+                      std::type_identity_t<T> const hi = std::is_floating_point_v<T> ? T(1) : std::numeric_limits<T>::max())
+    {
+        fill_uniform(engine, &out[0], N, lo, hi);
+    }
+
+    template<typename T, std::size_t N, typename Cont>
+    void fill_normal(random_engine auto& engine, vector<T, N, Cont>& out, std::type_identity_t<T> const mean = T(0),
+                     std::type_identity_t<T> const stddev = T(1))
+    {
+        fill_normal(engine, &out[0], N, mean, stddev);
+    }
+}
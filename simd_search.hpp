@@ -0,0 +1,158 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Searching of simd::vector. Registers are compared and reduced to a bitmask with movemask, the first match is
+ *  found with a trailing zero count and the search exits at the first register pair that holds a match.
+ */
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+//-----------------------------------------------------------------------------
+//  comparison predicates
+//-----------------------------------------------------------------------------
+    // each predicate provides the register test, one bit per byte as produced by movemask, and the scalar test
+    // used for the tail of the vector
+    template<typename T>
+    struct equal_to {
+        T value;
+
+        template<typename V>
+        unsigned mask(V const a) const { return movemask(cmpeq<T, V>(a, set<T, V>(value))); }
+        bool operator()(T const a) const { return a == value; }
+    };
+
+    template<typename T>
+    struct not_equal_to {
+        T value;
+
+        template<typename V>
+        unsigned mask(V const a) const { return ~movemask(cmpeq<T, V>(a, set<T, V>(value))) & (0xFFFFFFFFu >> (32 - sizeof(V))); }
+        bool operator()(T const a) const { return a != value; }
+    };
+
+    template<typename T>
+    struct less {
+        T value;
+
+        template<typename V>
+        unsigned mask(V const a) const { return movemask(cmpgt<T, V>(set<T, V>(value), a)); }
+        bool operator()(T const a) const { return a < value; }
+    };
+
+    template<typename T>
+    struct greater {
+        T value;
+
+        template<typename V>
+        unsigned mask(V const a) const { return movemask(cmpgt<T, V>(a, set<T, V>(value))); }
+        bool operator()(T const a) const { return a > value; }
+    };
+
+//-----------------------------------------------------------------------------
+//  find / contains / count
+//-----------------------------------------------------------------------------
+    // index of the first element matching the predicate, N when there is none
+    template <typename T, std::size_t N, typename Cont, typename Pred>
+    std::size_t find_if(vector<T, N, Cont> const& v, Pred const& pred)
+    {
+        using V = typename vector<T, N, Cont>::vreg;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        std::size_t i = 0;
+
+        // two registers are tested per iteration and their masks joined so a single branch covers both
+        for (; i + (VN * 2) <= N; i += (VN * 2)) {
+            std::uint64_t const m = std::uint64_t(pred.template mask<V>(load<V>(&v[i]))) |
+                                    (std::uint64_t(pred.template mask<V>(load<V>(&v[i + VN]))) << sizeof(V));
+            if (m != 0) {
+                return i + (std::countr_zero(m) / sizeof(T));
+            }
+        }
+        for (; i + VN <= N; i += VN) {
+            unsigned const m = pred.template mask<V>(load<V>(&v[i]));
+            if (m != 0) {
+                return i + (std::countr_zero(m) / sizeof(T));
+            }
+        }
+        for (; i < N; i++) {
+            if (pred(v[i])) {
+                return i;
+            }
+        }
+        return N;
+    }
+
+    // index of the first element equal to value, N when there is none
+    template <typename T, std::size_t N, typename Cont>
+    std::size_t find(vector<T, N, Cont> const& v, std::type_identity_t<T> const value)
+    {
+        return find_if(v, equal_to<T>{value});
+    }
+
+    template <typename T, std::size_t N, typename Cont>
+    bool contains(vector<T, N, Cont> const& v, std::type_identity_t<T> const value)
+    {
+        return find_if(v, equal_to<T>{value}) != N;
+    }
+
+    // number of elements matching the predicate
+    template <typename T, std::size_t N, typename Cont, typename Pred>
+    std::size_t count_if(vector<T, N, Cont> const& v, Pred const& pred)
+    {
+        using V = typename vector<T, N, Cont>::vreg;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        std::size_t bits = 0;
+        std::size_t result = 0;
+        std::size_t i = 0;
+
+        // every matching lane sets sizeof(T) bits of the mask
+        for (; i + VN <= N; i += VN) {
+            bits += std::popcount(pred.template mask<V>(load<V>(&v[i])));
+        }
+        for (; i < N; i++) {
+            result += pred(v[i]) ? 1 : 0;
+        }
+        return result + (bits / sizeof(T));
+    }
+
+    // number of elements equal to value
+    template <typename T, std::size_t N, typename Cont>
+    std::size_t count(vector<T, N, Cont> const& v, std::type_identity_t<T> const value)
+    {
+        return count_if(v, equal_to<T>{value});
+    }
+
+//-----------------------------------------------------------------------------
+//  mismatch
+//-----------------------------------------------------------------------------
+    // index of the first element where a and b differ, N when they are equal
+    template <typename T, std::size_t N, typename ContA, typename ContB>
+    std::size_t mismatch(vector<T, N, ContA> const& a, vector<T, N, ContB> const& b)
+    {
+        using V = typename vector<T, N, ContA>::vreg;
+        constexpr std::size_t VN = sizeof(V) / sizeof(T);
+        constexpr unsigned full = 0xFFFFFFFFu >> (32 - sizeof(V));
+        std::size_t i = 0;
+
+        for (; i + VN <= N; i += VN) {
+            unsigned const m = ~movemask(cmpeq<T, V>(load<V>(&a[i]), load<V>(&b[i]))) & full;
+            if (m != 0) {
+                return i + (std::countr_zero(m) / sizeof(T));
+            }
+        }
+        for (; i < N; i++) {
+            if (a[i] != b[i]) {
+                return i;
+            }
+        }
+        return N;
+    }
+}
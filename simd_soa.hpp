@@ -0,0 +1,95 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Structure of arrays container. Each field of N records is its own 64 byte aligned simd::vector column, so the
+ *  vector operators run across a field with unit stride loads, while rows are still reachable as tuples of
+ *  references. Records are copied in and out of an array of structs through member pointers.
+ */
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "simd_storage.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    template <std::size_t N, typename... Fields>
+    requires (sizeof...(Fields) > 0 && (std::is_arithmetic_v<Fields> && ...))
+    class soa {
+    public:
+        template<std::size_t I>
+        using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+        // columns live on the heap, record counts in the millions do not fit on the stack, and move by pointer
+        template<std::size_t I>
+        using column_type = heap_vector<field_type<I>, N>;
+
+        static constexpr std::size_t size() noexcept { return N; }
+
+        template<std::size_t I>
+        column_type<I>& column() noexcept { return std::get<I>(columns); }
+
+        template<std::size_t I>
+        column_type<I> const& column() const noexcept { return std::get<I>(columns); }
+
+        // row proxy, assigning a tuple to it writes every field of the row
+        std::tuple<Fields&...> operator[](std::size_t index)
+        {
+            return std::apply([index](auto&... c) { return std::tuple<Fields&...>(c[index]...); }, columns);
+        }
+
+        std::tuple<Fields const&...> operator[](std::size_t index) const
+        {
+            return std::apply([index](auto const&... c) { return std::tuple<Fields const&...>(c[index]...); }, columns);
+        }
+
+        // one pass over the records, each record is read once and scattered to every column
+        template<typename Record>
+        void load_aos(Record const* records, Fields Record::*... members)
+        {
+            load_aos(records, std::index_sequence_for<Fields...>{}, members...);
+        }
+
+        template<typename Record>
+        void store_aos(Record* records, Fields Record::*... members) const
+        {
+            store_aos(records, std::index_sequence_for<Fields...>{}, members...);
+        }
+
+        template<typename Record>
+        static soa from_aos(Record const* records, Fields Record::*... members)
+        {
+            soa result;
+            result.load_aos(records, members...);
+            return result;
+        }
+
+    private:
+        template<typename Record, std::size_t... I>
+        void load_aos(Record const* records, std::index_sequence<I...>, Fields Record::*... members)
+        {
+            for (std::size_t i = 0; i < N; i++) {
+                ((std::get<I>(columns)[i] = records[i].*members), ...);
+            }
+        }
+
+        template<typename Record, std::size_t... I>
+        void store_aos(Record* records, std::index_sequence<I...>, Fields Record::*... members) const
+        {
+            for (std::size_t i = 0; i < N; i++) {
+                ((records[i].*members = std::get<I>(columns)[i]), ...);
+            }
+        }
+
+        std::tuple<heap_vector<Fields, N>...> columns;
+    };
+
+    template<std::size_t I, std::size_t N, typename... Fields>
+    auto& get(soa<N, Fields...>& s) noexcept { return s.template column<I>(); }
+
+    template<std::size_t I, std::size_t N, typename... Fields>
+    auto const& get(soa<N, Fields...> const& s) noexcept { return s.template column<I>(); }
+}
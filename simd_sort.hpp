@@ -0,0 +1,296 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Sorting of simd::vector. Each register is sorted with an in-register bitonic network (min/max plus a lane
+ *  permute), neighbouring registers are merged in-register, then the sorted runs are merged through memory with a
+ *  vectorised bitonic merge that consumes one register at a time from whichever run has the smaller head. NaN values
+ *  are placed after every other value.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+    // element types with an in-register sorting network, everything else falls back to std::sort
+    template<typename T>
+    constexpr bool is_sort_network_type_v = std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t> ||
+                                            (std::is_floating_point_v<T> && (sizeof(T) == 4 || sizeof(T) == 8));
+
+#if defined(__AVX512F__)
+    template<typename T>
+    using sort_vreg = std::conditional_t<std::is_integral_v<T>, __m512i,
+                      std::conditional_t<sizeof(T) == 4, __m512, __m512d>>;
+#elif defined(__AVX2__)
+    template<typename T>
+    using sort_vreg = std::conditional_t<std::is_integral_v<T>, __m256i,
+                      std::conditional_t<sizeof(T) == 4, __m256, __m256d>>;
+#endif
+
+//-----------------------------------------------------------------------------
+//  lane permute / blend
+//-----------------------------------------------------------------------------
+    // exchange lane i with lane i ^ J, every element type is permuted as 32bit words. The AVX-512 permutes are the
+    // full mask forms with v as source, as in the min/max wrappers, so GCC sees no undefined source register
+    template<typename T, typename V, std::size_t J>
+    inline V permute_xor(V const v) {
+        constexpr std::size_t W = sizeof(V) / sizeof(std::int32_t);
+        constexpr std::size_t S = sizeof(T) / sizeof(std::int32_t);
+        alignas(64) static constexpr std::array<std::int32_t, W> idx = [] {
+            std::array<std::int32_t, W> r{};
+            for (std::size_t i = 0; i < W; ++i) { r[i] = static_cast<std::int32_t>((((i / S) ^ J) * S) + (i % S)); }
+            return r;
+        }();
+
+    #if defined(__AVX512F__)
+        if constexpr (std::is_same_v<V, __m512i>)      { return _mm512_mask_permutexvar_epi32(v, 0xFFFF, _mm512_load_si512(idx.data()), v); }
+        else if constexpr (std::is_same_v<V, __m512>)  { return _mm512_mask_permutexvar_ps(v, 0xFFFF, _mm512_load_si512(idx.data()), v); }
+        else if constexpr (std::is_same_v<V, __m512d>) { return _mm512_castps_pd(_mm512_mask_permutexvar_ps(_mm512_castpd_ps(v), 0xFFFF, _mm512_load_si512(idx.data()), _mm512_castpd_ps(v))); }
+    #elif defined(__AVX2__)
+        if constexpr (std::is_same_v<V, __m256i>)      { return _mm256_permutevar8x32_epi32(v, _mm256_load_si256((__m256i*)idx.data())); }
+        else if constexpr (std::is_same_v<V, __m256>)  { return _mm256_permutevar8x32_ps(v, _mm256_load_si256((__m256i*)idx.data())); }
+        else if constexpr (std::is_same_v<V, __m256d>) { return _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), _mm256_load_si256((__m256i*)idx.data()))); }
+    #endif
+    }
+
+    // take lane i from b where bit i of M is set, otherwise from a
+    template<typename T, typename V, unsigned M>
+    inline V blend_lanes(V const a, V const b) {
+    #if defined(__AVX512F__)
+        if constexpr (std::is_same_v<V, __m512i> && sizeof(T) == 4) { return _mm512_mask_blend_epi32(M, a, b); }
+        else if constexpr (std::is_same_v<V, __m512i>)              { return _mm512_mask_blend_epi64(M, a, b); }
+        else if constexpr (std::is_same_v<V, __m512>)               { return _mm512_mask_blend_ps(M, a, b); }
+        else if constexpr (std::is_same_v<V, __m512d>)              { return _mm512_mask_blend_pd(M, a, b); }
+    #elif defined(__AVX2__)
+        if constexpr (std::is_same_v<V, __m256i> && sizeof(T) == 4) { return _mm256_blend_epi32(a, b, M); }
+        else if constexpr (std::is_same_v<V, __m256i>)              { return _mm256_blend_epi32(a, b, (M & 1 ? 0x03 : 0) | (M & 2 ? 0x0C : 0) | (M & 4 ? 0x30 : 0) | (M & 8 ? 0xC0 : 0)); }
+        else if constexpr (std::is_same_v<V, __m256>)               { return _mm256_blend_ps(a, b, M); }
+        else if constexpr (std::is_same_v<V, __m256d>)              { return _mm256_blend_pd(a, b, M); }
+    #endif
+    }
+
+//-----------------------------------------------------------------------------
+//  bitonic network
+//-----------------------------------------------------------------------------
+    // one compare-exchange step of the bitonic network with block size K and partner distance J
+    template<typename T, typename V, std::size_t K, std::size_t J>
+    inline V bitonic_step(V const v) {
+        constexpr std::size_t W = sizeof(V) / sizeof(T);
+        // lane i keeps the maximum when it is the upper lane of an ascending pair or the lower lane of a descending one
+        constexpr unsigned M = [] {
+            unsigned m = 0;
+            for (std::size_t i = 0; i < W; ++i) { m |= (((i & J) != 0) != ((i & K) != 0)) ? (1u << i) : 0u; }
+            return m;
+        }();
+
+        V const p = permute_xor<T, V, J>(v);
+        return blend_lanes<T, V, M>(min<T, V>(v, p), max<T, V>(v, p));
+    }
+
+    template<typename T, typename V, std::size_t K, std::size_t J>
+    inline V bitonic_steps(V const v) {
+        if constexpr (J > 1) { return bitonic_steps<T, V, K, J / 2>(bitonic_step<T, V, K, J>(v)); }
+        else                 { return bitonic_step<T, V, K, J>(v); }
+    }
+
+    // sort the lanes of a single register in ascending order
+    template<typename T, typename V, std::size_t K = 2>
+    inline V sort_register(V const v) {
+        constexpr std::size_t W = sizeof(V) / sizeof(T);
+        if constexpr (K < W) { return sort_register<T, V, K * 2>(bitonic_steps<T, V, K, K / 2>(v)); }
+        else                 { return bitonic_steps<T, V, K, K / 2>(v); }
+    }
+
+    // merge two sorted registers, a receives the lowest lanes and b the highest, both sorted
+    template<typename T, typename V>
+    inline void merge_registers(V& a, V& b) {
+        constexpr std::size_t W = sizeof(V) / sizeof(T);
+        V const r = permute_xor<T, V, W - 1>(b); // reverse b so that a:r is bitonic
+        V const lo = min<T, V>(a, r);
+        V const hi = max<T, V>(a, r);
+        a = bitonic_steps<T, V, W, W / 2>(lo);
+        b = bitonic_steps<T, V, W, W / 2>(hi);
+    }
+
+//-----------------------------------------------------------------------------
+//  run merging
+//-----------------------------------------------------------------------------
+    // merge sorted runs a[0, na) and b[0, nb) into out, all lengths are non-zero multiples of the register width
+    template<typename T, typename V>
+    inline void merge_runs(T const* a, std::size_t na, T const* b, std::size_t nb, T* out) {
+        constexpr std::size_t W = sizeof(V) / sizeof(T);
+        V lo = load<V>(a);
+        V hi = load<V>(b);
+        std::size_t ia = W;
+        std::size_t ib = W;
+
+        merge_registers<T, V>(lo, hi);
+        store<V>(out, lo);
+        out += W;
+
+        // hi always holds the largest W elements seen so far, so the next register comes from the run whose
+        // head is smaller
+        while (ia < na || ib < nb) {
+            if (ib >= nb || (ia < na && a[ia] <= b[ib])) { lo = load<V>(&a[ia]); ia += W; }
+            else                                         { lo = load<V>(&b[ib]); ib += W; }
+
+            merge_registers<T, V>(lo, hi);
+            store<V>(out, lo);
+            out += W;
+        }
+        store<V>(out, hi);
+    }
+
+    // sort buf[0, n) where n is a multiple of the register width, returns whichever of buf/tmp holds the result
+    template<typename T, typename V>
+    inline T* sort_runs(T* buf, T* tmp, std::size_t n) {
+        constexpr std::size_t W = sizeof(V) / sizeof(T);
+        std::size_t i = 0;
+
+        for (; i + (W * 2) <= n; i += (W * 2)) {
+            V a = sort_register<T, V>(load<V>(&buf[i]));
+            V b = sort_register<T, V>(load<V>(&buf[i + W]));
+            merge_registers<T, V>(a, b);
+            store<V>(&buf[i], a);
+            store<V>(&buf[i + W], b);
+        }
+        for (; i < n; i += W) {
+            store<V>(&buf[i], sort_register<T, V>(load<V>(&buf[i])));
+        }
+
+        T* src = buf;
+        T* dst = tmp;
+        for (std::size_t run = W * 2; run < n; run *= 2) {
+            for (std::size_t s = 0; s < n; s += run * 2) {
+                std::size_t const na = std::min(run, n - s);
+                std::size_t const nb = std::min(run, n - s - na);
+                if (nb == 0) { std::copy(&src[s], &src[s + na], &dst[s]); }
+                else         { merge_runs<T, V>(&src[s], na, &src[s + na], nb, &dst[s]); }
+            }
+            std::swap(src, dst);
+        }
+        return src;
+    }
+
+    // scratch buffers of up to this many elements live on the stack, a heap or huge page vector can be far larger
+    constexpr std::size_t sort_stack_elements = 1024;
+
+    // call f with two scratch buffers of M elements each
+    template<typename T, std::size_t M, typename F>
+    inline void with_sort_scratch(F&& f) {
+        if constexpr (M <= sort_stack_elements) {
+            alignas(64) std::array<T, M> buf;
+            alignas(64) std::array<T, M> tmp;
+            f(buf.data(), tmp.data());
+        }
+        else {
+            auto const scratch = std::make_unique_for_overwrite<T[]>(M * 2);
+            f(scratch.get(), scratch.get() + M);
+        }
+    }
+
+    // sort n elements through a padded buffer of M elements, the padding is filled with the largest value
+    template<typename T, std::size_t M>
+    inline void sort_padded(T* first, std::size_t n) {
+    #if defined(__AVX512F__) || defined(__AVX2__)
+        using V = sort_vreg<T>;
+        with_sort_scratch<T, M>([first, n](T* buf, T* tmp) {
+            std::copy(first, first + n, buf);
+            std::fill(buf + n, buf + M, std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                                             : std::numeric_limits<T>::max());
+            T const* const sorted = sort_runs<T, V>(buf, tmp, M);
+            std::copy(sorted, sorted + n, first);
+        });
+    #else
+        std::sort(first, first + n);
+    #endif
+    }
+
+//-----------------------------------------------------------------------------
+//  sort / argsort
+//-----------------------------------------------------------------------------
+    // sort the vector in ascending order, NaN values end up last
+    template <typename T, std::size_t N, typename Cont>
+    void sort(vector<T, N, Cont>& v)
+    {
+        // NaN compares false either way, the network's min/max would drop or duplicate it and std::sort has no
+        // strict weak order, so the NaNs are moved behind the range that gets sorted
+        std::size_t n = N;
+        if constexpr (std::is_floating_point_v<T>) {
+            n = static_cast<std::size_t>(std::partition(v.begin(), v.begin() + N, [](T const x) { return !std::isnan(x); }) - v.begin());
+        }
+
+    #if defined(__AVX512F__) || defined(__AVX2__)
+        if constexpr (is_sort_network_type_v<T> && N > 1) {
+            constexpr std::size_t W = sizeof(sort_vreg<T>) / sizeof(T);
+            sort_padded<T, ((N + W - 1) / W) * W>(v.begin(), n);
+            return;
+        }
+    #endif
+        std::sort(v.begin(), v.begin() + n);
+    }
+
+    // indices that would sort the vector in ascending order, equal elements keep their original order and NaN values
+    // come last. The indices are held by the same storage policy as v
+    template <typename T, std::size_t N, typename Cont>
+    vector<std::size_t, N, rebind_storage_t<Cont, std::size_t, N>> argsort(vector<T, N, Cont> const& v)
+    {
+        vector<std::size_t, N, rebind_storage_t<Cont, std::size_t, N>> result;
+
+    #if defined(__AVX512F__) || defined(__AVX2__)
+        // keys of 32bits or less are packed above their index into an int64 and sorted by the int64 network, the
+        // index in the low half makes the sort stable
+        if constexpr ((std::is_integral_v<T> || sizeof(T) == 4) && sizeof(T) <= 4 && N > 1 && N <= std::numeric_limits<std::uint32_t>::max()) {
+            constexpr std::size_t W = sizeof(sort_vreg<std::int64_t>) / sizeof(std::int64_t);
+            constexpr std::size_t M = ((N + W - 1) / W) * W;
+            using V = sort_vreg<std::int64_t>;
+
+            with_sort_scratch<std::int64_t, M>([&v, &result](std::int64_t* buf, std::int64_t* tmp) {
+                for (std::size_t i = 0; i < N; ++i) {
+                    std::int32_t key;
+                    if constexpr (std::is_floating_point_v<T>) {
+                        // order preserving float to int mapping, -0.0 is folded into +0.0 and every NaN sorts last
+                        key = std::bit_cast<std::int32_t>(v[i] == T(0) ? T(0) : v[i]);
+                        key ^= (key >> 31) & 0x7FFFFFFF;
+                        key = std::isnan(v[i]) ? std::numeric_limits<std::int32_t>::max() : key;
+                    }
+                    else if constexpr (std::is_same_v<T, std::uint32_t>) {
+                        key = static_cast<std::int32_t>(v[i] ^ 0x80000000u);
+                    }
+                    else {
+                        key = static_cast<std::int32_t>(v[i]);
+                    }
+                    buf[i] = static_cast<std::int64_t>(static_cast<std::uint64_t>(static_cast<std::int64_t>(key) << 32) | i);
+                }
+                std::fill(buf + N, buf + M, std::numeric_limits<std::int64_t>::max());
+
+                std::int64_t const* const sorted = sort_runs<std::int64_t, V>(buf, tmp, M);
+                for (std::size_t i = 0; i < N; ++i) {
+                    result[i] = static_cast<std::uint32_t>(sorted[i]);
+                }
+            });
+            return result;
+        }
+    #endif
+
+        // 64bit keys do not fit beside their index, sort the indices with the scalar comparator instead
+        std::iota(result.begin(), result.begin() + N, std::size_t(0));
+        std::stable_sort(result.begin(), result.begin() + N, [&v](std::size_t a, std::size_t b) {
+            if constexpr (std::is_floating_point_v<T>) { return v[a] < v[b] || (!std::isnan(v[a]) && std::isnan(v[b])); }
+            else                                       { return v[a] < v[b]; }
+        });
+        return result;
+    }
+}
@@ -0,0 +1,434 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Sparse vectors of float or double, held as strictly increasing 32bit indices and their values. Operations
+ *  against a dense array gather its elements a register at a time (vgatherdps / vgatherdpd), so only the cache
+ *  lines holding nonzeros are read. Conversion from dense compacts the nonzero lanes of each register to the front,
+ *  with vcompressps under AVX512 and a permute table under AVX2. scatter_add accumulates (index, value) pairs that
+ *  may repeat, adding repeated indices in rounds found with AVX512 conflict detection.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <immintrin.h>
+
+#include "simd_intrinsics_wrappers.hpp"
+#include "simd_vector.hpp"
+
+namespace simd {
+#if defined(__AVX512F__)
+    template<typename T>
+    using sparse_vreg = std::conditional_t<sizeof(T) == 4, __m512, __m512d>;
+
+    // the indices of one register of values
+    template<typename T>
+    using sparse_ireg = std::conditional_t<sizeof(T) == 4, __m512i, __m256i>;
+#elif defined(__AVX2__)
+    template<typename T>
+    using sparse_vreg = std::conditional_t<sizeof(T) == 4, __m256, __m256d>;
+
+    template<typename T>
+    using sparse_ireg = std::conditional_t<sizeof(T) == 4, __m256i, __m128i>;
+#endif
+
+//-----------------------------------------------------------------------------
+//  gather / scatter / compact
+//-----------------------------------------------------------------------------
+#if defined(__AVX512F__) || defined(__AVX2__)
+    template<typename T>
+    constexpr std::size_t sparse_lanes = sizeof(sparse_vreg<T>) / sizeof(T);
+
+    // masked gathers from a zeroed source with every lane enabled, the unmasked forms start from an undefined
+    // register that GCC reports as maybe-uninitialized, as in simd_histogram.hpp
+    template<typename T>
+    sparse_vreg<T> sparse_gather(T const* base, sparse_ireg<T> const idx)
+    {
+    #if defined(__AVX512F__)
+        if constexpr (sizeof(T) == 4) { return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, idx, base, 4); } // AVX512F
+        else                          { return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, idx, base, 8); }   // AVX512F
+    #else
+        if constexpr (sizeof(T) == 4) { return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, idx, _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4); } // AVX2
+        else                          { return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, idx, _mm256_castsi256_pd(_mm256_set1_epi32(-1)), 8); } // AVX2
+    #endif // __AVX512F__
+    }
+
+    // once per call, so a store and a scalar sum is as quick as a shuffle tree
+    template<typename T>
+    T sparse_reduce(sparse_vreg<T> const a)
+    {
+        alignas(64) std::array<T, sparse_lanes<T>> lanes;
+        store<sparse_vreg<T>>(lanes.data(), a);
+        T sum = T(0);
+        for (T const x : lanes) {
+            sum += x;
+        }
+        return sum;
+    }
+
+    // lane numbers of the set bits of each mask, one byte per 32bit slot for permutevar8x32, so a double takes two
+    template<std::size_t Slots>
+    constexpr std::array<std::uint64_t, (1u << (8 / Slots))> compact_table = [] {
+        std::array<std::uint64_t, (1u << (8 / Slots))> t{};
+        for (std::size_t m = 0; m < t.size(); ++m) {
+            std::size_t k = 0;
+            for (std::size_t lane = 0; lane < 8 / Slots; ++lane) {
+                if (m & (std::size_t(1) << lane)) {
+                    for (std::size_t s = 0; s < Slots; ++s, ++k) {
+                        t[m] |= std::uint64_t((lane * Slots) + s) << (k * 8);
+                    }
+                }
+            }
+        }
+        return t;
+    }();
+
+    // writes the nonzero elements of dense[0, n) and their indices plus base, returns how many. Every register
+    // stores a whole register of each, so both outputs need sparse_lanes<T> elements of room past the count
+    template<typename T>
+    std::size_t sparse_compact(T const* dense, std::size_t const n, std::uint32_t const base, std::uint32_t* idx, T* val)
+    {
+        using V = sparse_vreg<T>;
+        constexpr std::size_t L = sparse_lanes<T>;
+        std::size_t count = 0;
+        std::size_t i = 0;
+
+    #if defined(__AVX512F__)
+        // compressing in a register then storing whole is faster than a compressing store on most cores
+        __m512i const iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        for (; i + L <= n; i += L) {
+            V const v = load<V>(&dense[i]);
+            __mmask16 m;
+            if constexpr (sizeof(T) == 4) { m = _mm512_cmp_ps_mask(v, _mm512_setzero_ps(), _CMP_NEQ_UQ); } // AVX512F
+            else                          { m = _mm512_cmp_pd_mask(v, _mm512_setzero_pd(), _CMP_NEQ_UQ); } // AVX512F
+            if (m == 0) {
+                continue;
+            }
+            __m512i const j = _mm512_maskz_compress_epi32(m, _mm512_add_epi32(iota, _mm512_set1_epi32(static_cast<int>(base + i)))); // AVX512F
+            if constexpr (sizeof(T) == 4) {
+                _mm512_storeu_si512(&idx[count], j); // AVX512F
+                _mm512_storeu_ps(&val[count], _mm512_maskz_compress_ps(m, v)); // AVX512F
+            }
+            else {
+                _mm512_mask_storeu_epi32(&idx[count], 0xFF, j); // AVX512F
+                _mm512_storeu_pd(&val[count], _mm512_maskz_compress_pd(static_cast<__mmask8>(m), v)); // AVX512F
+            }
+            count += std::popcount(static_cast<unsigned>(m));
+        }
+    #else
+        __m256i const iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        for (; i + L <= n; i += L) {
+            V const v = load<V>(&dense[i]);
+            unsigned m;
+            if constexpr (sizeof(T) == 4) { m = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_NEQ_UQ))); } // AVX
+            else                          { m = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(v, _mm256_setzero_pd(), _CMP_NEQ_UQ))); } // AVX
+            if (m == 0) {
+                continue;
+            }
+            __m256i const lanes = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(compact_table<1>[m]))); // AVX2
+            __m256i const j = _mm256_permutevar8x32_epi32(_mm256_add_epi32(iota, _mm256_set1_epi32(static_cast<int>(base + i))), lanes); // AVX2
+            if constexpr (sizeof(T) == 4) {
+                _mm256_storeu_si256((__m256i*)&idx[count], j); // AVX
+                _mm256_storeu_ps(&val[count], _mm256_permutevar8x32_ps(v, lanes)); // AVX2
+            }
+            else {
+                __m256i const slots = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(compact_table<2>[m]))); // AVX2
+                _mm_storeu_si128((__m128i*)&idx[count], _mm256_castsi256_si128(j)); // SSE2
+                _mm256_storeu_pd(&val[count], _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), slots))); // AVX2
+            }
+            count += std::popcount(m);
+        }
+    #endif // __AVX512F__
+
+        for (; i < n; ++i) {
+            if (dense[i] != T(0)) {
+                idx[count] = base + static_cast<std::uint32_t>(i);
+                val[count] = dense[i];
+                ++count;
+            }
+        }
+        return count;
+    }
+#endif // __AVX512F__ || __AVX2__
+
+//-----------------------------------------------------------------------------
+//  sparse_vector
+//-----------------------------------------------------------------------------
+    template<typename T>
+    requires (std::is_same_v<T, float> || std::is_same_v<T, double>)
+    class sparse_vector {
+    public:
+        using index_type = std::uint32_t;
+
+        static constexpr std::size_t max_dimension = std::size_t(1) << 31;
+
+        sparse_vector() = default;
+
+        // at most 2^31, vgatherdps and the scatters sign extend their 32bit indices so higher ones would go negative
+        explicit sparse_vector(std::size_t const dimension) : dim(dimension)
+        {
+            if (dimension > max_dimension) {
+                throw std::invalid_argument("sparse_vector dimension is above 2^31");
+            }
+        }
+
+        // the indices must be strictly increasing and below dimension
+        sparse_vector(std::size_t const dimension, std::vector<index_type> indices, std::vector<T> values)
+            : sparse_vector(dimension)
+        {
+            if (indices.size() != values.size()) {
+                throw std::invalid_argument("sparse_vector indices and values differ in length");
+            }
+            for (std::size_t k = 0; k < indices.size(); ++k) {
+                if (indices[k] >= dimension || (k > 0 && indices[k] <= indices[k - 1])) {
+                    throw std::invalid_argument("sparse_vector indices must be increasing and below the dimension");
+                }
+            }
+            idx = std::move(indices);
+            val = std::move(values);
+        }
+
+        // the nonzero elements of dense[0, n), found a register at a time. Blocks are compacted into a buffer on
+        // the stack and appended, so dense is read once
+        static sparse_vector from_dense(T const* dense, std::size_t const n)
+        {
+            sparse_vector result(n);
+        #if defined(__AVX512F__) || defined(__AVX2__)
+            constexpr std::size_t block = 1024;
+            std::array<index_type, block + sparse_lanes<T>> bi;
+            std::array<T, block + sparse_lanes<T>> bv;
+            for (std::size_t i = 0; i < n; i += block) {
+                std::size_t const count = sparse_compact(dense + i, std::min(block, n - i), static_cast<index_type>(i), bi.data(), bv.data());
+                result.idx.insert(result.idx.end(), bi.begin(), bi.begin() + count);
+                result.val.insert(result.val.end(), bv.begin(), bv.begin() + count);
+            }
+        #else
+            for (std::size_t i = 0; i < n; ++i) {
+                if (dense[i] != T(0)) {
+                    result.push_back(static_cast<index_type>(i), dense[i]);
+                }
+            }
+        #endif // __AVX512F__ || __AVX2__
+            return result;
+        }
+
+        template<std::size_t N, typename Cont>
+        static sparse_vector from_dense(vector<T, N, Cont> const& v)
+        {
+            return from_dense(&v[0], N);
+        }
+
+        // writes all dimension() elements
+        void to_dense(T* out) const
+        {
+            std::fill_n(out, dim, T(0));
+            for (std::size_t k = 0; k < idx.size(); ++k) {
+                out[idx[k]] = val[k];
+            }
+        }
+
+        template<std::size_t N, typename Cont>
+        void to_dense(vector<T, N, Cont>& out) const
+        {
+            if (N != dim) {
+                throw std::invalid_argument("sparse_vector dimension differs from the dense vector");
+            }
+            to_dense(&out[0]);
+        }
+
+        // i must be above every index already held
+        void push_back(index_type const i, T const v)
+        {
+            idx.push_back(i);
+            val.push_back(v);
+        }
+
+        void reserve(std::size_t const n)
+        {
+            idx.reserve(n);
+            val.reserve(n);
+        }
+
+        void clear()
+        {
+            idx.clear();
+            val.clear();
+        }
+
+        std::size_t dimension() const { return dim; }
+        std::size_t nonzeros() const { return idx.size(); }
+
+        std::span<index_type const> indices() const { return idx; }
+        std::span<T const> values() const { return val; }
+        std::span<T> values() { return val; }
+
+    private:
+        std::size_t dim = 0;
+        std::vector<index_type> idx;
+        std::vector<T> val;
+    };
+
+//-----------------------------------------------------------------------------
+//  sparse-dense operations
+//-----------------------------------------------------------------------------
+    // sum of a[i] dense[i] over the nonzeros of a, dense holds at least a.dimension() elements
+    template<typename T>
+    T dot(sparse_vector<T> const& a, T const* dense)
+    {
+        std::uint32_t const* const idx = a.indices().data();
+        T const* const val = a.values().data();
+        std::size_t const n = a.nonzeros();
+        std::size_t i = 0;
+        T sum = T(0);
+
+    #if defined(__AVX512F__) || defined(__AVX2__)
+        // two accumulators so the gathers of one register do not wait on the fmadd of the other
+        using V = sparse_vreg<T>;
+        using I = sparse_ireg<T>;
+        constexpr std::size_t L = sparse_lanes<T>;
+        V acc0 = set<T, V>(T(0));
+        V acc1 = set<T, V>(T(0));
+        for (; i + (L * 2) <= n; i += L * 2) {
+            acc0 = fmadd<T, V>(load<V>(&val[i]), sparse_gather<T>(dense, load<I>(&idx[i])), acc0);
+            acc1 = fmadd<T, V>(load<V>(&val[i + L]), sparse_gather<T>(dense, load<I>(&idx[i + L])), acc1);
+        }
+        for (; i + L <= n; i += L) {
+            acc0 = fmadd<T, V>(load<V>(&val[i]), sparse_gather<T>(dense, load<I>(&idx[i])), acc0);
+        }
+        sum = sparse_reduce<T>(acc0) + sparse_reduce<T>(acc1);
+    #endif // __AVX512F__ || __AVX2__
+
+        for (; i < n; ++i) {
+            sum += val[i] * dense[idx[i]];
+        }
+        return sum;
+    }
+
+    // y += alpha x. The indices of x are distinct, so AVX512 scatters a whole register back at once
+    template<typename T>
+    void axpy(std::type_identity_t<T> const alpha, sparse_vector<T> const& x, T* y)
+    {
+        std::uint32_t const* const idx = x.indices().data();
+        T const* const val = x.values().data();
+        std::size_t const n = x.nonzeros();
+        std::size_t i = 0;
+
+    #if defined(__AVX512F__)
+        using V = sparse_vreg<T>;
+        using I = sparse_ireg<T>;
+        constexpr std::size_t L = sparse_lanes<T>;
+        V const a = set<T, V>(alpha);
+        for (; i + L <= n; i += L) {
+            I const j = load<I>(&idx[i]);
+            V const r = fmadd<T, V>(a, load<V>(&val[i]), sparse_gather<T>(y, j));
+            if constexpr (sizeof(T) == 4) { _mm512_i32scatter_ps(y, j, r, 4); } // AVX512F
+            else                          { _mm512_i32scatter_pd(y, j, r, 8); } // AVX512F
+        }
+    #endif // __AVX512F__
+
+        for (; i < n; ++i) {
+            y[idx[i]] += alpha * val[i];
+        }
+    }
+
+    // y[idx[k]] += val[k], where an index may appear more than once and every index is below 2^31. Each register is
+    // added in rounds, a round taking the lanes with no earlier lane still waiting on the same index, so repeats see
+    // each other's sums
+    template<typename T>
+    requires (std::is_same_v<T, float> || std::is_same_v<T, double>)
+    void scatter_add(std::uint32_t const* idx, T const* val, std::size_t const n, T* y)
+    {
+        std::size_t i = 0;
+
+    #if defined(__AVX512F__) && defined(__AVX512CD__) && defined(__AVX512VL__)
+        using V = sparse_vreg<T>;
+        using I = sparse_ireg<T>;
+        constexpr std::size_t L = sparse_lanes<T>;
+        for (; i + L <= n; i += L) {
+            I const j = load<I>(&idx[i]);
+            V const v = load<V>(&val[i]);
+            if constexpr (sizeof(T) == 4) {
+                __m512i const conflicts = _mm512_conflict_epi32(j); // AVX512CD
+                __mmask16 waiting = 0xFFFF;
+                do {
+                    __mmask16 const ready = _mm512_mask_testn_epi32_mask(waiting, conflicts, _mm512_set1_epi32(waiting)); // AVX512F
+                    __m512 const old = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), ready, j, y, 4); // AVX512F
+                    _mm512_mask_i32scatter_ps(y, ready, j, _mm512_add_ps(old, v), 4); // AVX512F
+                    waiting &= ~ready;
+                } while (waiting != 0);
+            }
+            else {
+                __m256i const conflicts = _mm256_conflict_epi32(j); // AVX512CD + AVX512VL
+                __mmask8 waiting = 0xFF;
+                do {
+                    __mmask8 const ready = _mm256_mask_testn_epi32_mask(waiting, conflicts, _mm256_set1_epi32(waiting)); // AVX512F + AVX512VL
+                    __m512d const old = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), ready, j, y, 8); // AVX512F
+                    _mm512_mask_i32scatter_pd(y, ready, j, _mm512_add_pd(old, v), 8); // AVX512F
+                    waiting &= ~ready;
+                } while (waiting != 0);
+            }
+        }
+    #endif // __AVX512F__ && __AVX512CD__ && __AVX512VL__
+
+        for (; i < n; ++i) {
+            y[idx[i]] += val[i];
+        }
+    }
+
+//-----------------------------------------------------------------------------
+//  spans and vectors
+//-----------------------------------------------------------------------------
+    template<typename T>
+    T dot(sparse_vector<T> const& a, std::span<T const> const dense)
+    {
+        if (dense.size() < a.dimension()) {
+            throw std::invalid_argument("dense operand is shorter than the sparse_vector dimension");
+        }
+        return dot(a, dense.data());
+    }
+
+    template<typename T, std::size_t N, typename Cont>
+    T dot(sparse_vector<T> const& a, vector<T, N, Cont> const& dense)
+    {
+        return dot(a, std::span<T const>(&dense[0], N));
+    }
+
+    template<typename T>
+    void axpy(std::type_identity_t<T> const alpha, sparse_vector<T> const& x, std::span<T> const y)
+    {
+        if (y.size() < x.dimension()) {
+            throw std::invalid_argument("dense operand is shorter than the sparse_vector dimension");
+        }
+        axpy(alpha, x, y.data());
+    }
+
+    template<typename T, std::size_t N, typename Cont>
+    void axpy(std::type_identity_t<T> const alpha, sparse_vector<T> const& x, vector<T, N, Cont>& y)
+    {
+        axpy(alpha, x, std::span<T>(&y[0], N));
+    }
+
+    // every index must be below y.size()
+    template<typename T>
+    void scatter_add(std::span<std::uint32_t const> const idx, std::span<T const> const val, std::span<T> const y)
+    {
+        if (idx.size() != val.size()) {
+            throw std::invalid_argument("scatter_add indices and values differ in length");
+        }
+        scatter_add(idx.data(), val.data(), idx.size(), y.data());
+    }
+
+    template<typename T, std::size_t N, typename Cont>
+    void scatter_add(std::span<std::uint32_t const> const idx, std::span<T const> const val, vector<T, N, Cont>& y)
+    {
+        scatter_add(idx, val, std::span<T>(&y[0], N));
+    }
+}
@@ -0,0 +1,225 @@
+/*
+ *  SIMD (single instruction multiple data) header library
+ *
+ *  Storage policies for the Cont parameter of simd::vector. The default T[N] keeps the elements inline, the
+ *  policies here own a 64 byte aligned buffer obtained from an allocator: the aligned heap, a thread local pool of
+ *  reusable blocks, or 2MB huge pages. Each allocator recycles freed blocks through a thread local free list, so the
+ *  temporaries of an expression do not reach the heap or mmap once warm. Moving a vector with one of these hands
+ *  the buffer over instead of copying the elements, which lets the rvalue operators reuse a dying operand as their
+ *  result.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif // __linux__
+
+#include "simd_vector.hpp"
+
+namespace simd {
+//-----------------------------------------------------------------------------
+//  allocators
+//-----------------------------------------------------------------------------
+    // 64 byte aligned blocks straight from the heap
+    struct aligned_heap {
+        template<std::size_t Bytes>
+        static void* allocate() { return ::operator new(Bytes, std::align_val_t(64)); }
+
+        template<std::size_t Bytes>
+        static void deallocate(void* p) { ::operator delete(p, std::align_val_t(64)); }
+    };
+
+    // whole 2MB pages, from the reserved huge page pool when there is one and otherwise as transparent huge pages
+    struct huge_pages {
+        static constexpr std::size_t page = 2 * 1024 * 1024;
+
+        template<std::size_t Bytes>
+        static void* allocate() {
+            constexpr std::size_t size = ((Bytes + page - 1) / page) * page;
+        #ifdef __linux__
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                return p;
+            }
+
+            // over-allocate by a page so the mapping can be trimmed to a 2MB boundary
+            p = mmap(nullptr, size + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            char* const base = static_cast<char*>(p);
+            char* const aligned = base + ((page - (reinterpret_cast<std::size_t>(base) % page)) % page);
+            if (aligned != base) {
+                munmap(base, aligned - base);
+            }
+            if (aligned + size != base + size + page) {
+                munmap(aligned + size, (base + size + page) - (aligned + size));
+            }
+            madvise(aligned, size, MADV_HUGEPAGE);
+            return aligned;
+        #else
+            return ::operator new(size, std::align_val_t(page));
+        #endif // __linux__
+        }
+
+        template<std::size_t Bytes>
+        static void deallocate(void* p) {
+            constexpr std::size_t size = ((Bytes + page - 1) / page) * page;
+        #ifdef __linux__
+            munmap(p, size);
+        #else
+            ::operator delete(p, std::align_val_t(page));
+        #endif // __linux__
+        }
+    };
+
+    // thread local free list of blocks of one size from Source. Up to Keep freed blocks are held for reuse and any
+    // beyond that go back to Source, the held blocks are returned when the thread exits
+    template<std::size_t Bytes, typename Source, std::size_t Keep>
+    class block_pool {
+    public:
+        // cleared when the thread's pool is destroyed. A static or thread_local vector destroyed after it still frees
+        // its block, and that (or any later allocation) has to bypass the pool and go to Source directly
+        static inline thread_local bool alive = true;
+
+        static block_pool& local() {
+            thread_local block_pool pool;
+            return pool;
+        }
+
+        void* pop() {
+            if (head == nullptr) {
+                return Source::template allocate<Bytes>();
+            }
+            node* const n = head;
+            head = n->next;
+            --held;
+            return n;
+        }
+
+        void push(void* p) {
+            if (held == Keep) {
+                Source::template deallocate<Bytes>(p);
+                return;
+            }
+            head = ::new (p) node{head};
+            ++held;
+        }
+
+        ~block_pool() {
+            alive = false;
+            while (head != nullptr) {
+                node* const n = head->next;
+                Source::template deallocate<Bytes>(head);
+                head = n;
+            }
+        }
+
+    private:
+        struct node { node* next; };
+        node* head = nullptr;
+        std::size_t held = 0;
+    };
+
+    // blocks recycled through the thread's block_pool, after warm up a temporary costs a list pop and push rather
+    // than a trip through Source. A block freed on another thread joins that thread's pool
+    template<typename Source, std::size_t Keep>
+    struct cached_allocator {
+        template<std::size_t Bytes>
+        static void* allocate() {
+            using pool = block_pool<Bytes, Source, Keep>;
+            return pool::alive ? pool::local().pop() : Source::template allocate<Bytes>();
+        }
+
+        template<std::size_t Bytes>
+        static void deallocate(void* p) {
+            using pool = block_pool<Bytes, Source, Keep>;
+            if (pool::alive) { pool::local().push(p); }
+            else             { Source::template deallocate<Bytes>(p); }
+        }
+    };
+
+    // the heap and huge page policies keep a few blocks of each size, enough for the temporaries of an expression,
+    // so operators do not call the allocator or mmap once warm. The pool keeps every block it is given back
+    using aligned_allocator = cached_allocator<aligned_heap, 4>;
+    using pool_allocator = cached_allocator<aligned_heap, SIZE_MAX>;
+    using huge_page_allocator = cached_allocator<huge_pages, 4>;
+
+//-----------------------------------------------------------------------------
+//  buffer storage
+//-----------------------------------------------------------------------------
+    // owning buffer of N elements, indexes and decays to T* like the inline array so simd::vector treats both alike.
+    // Elements start uninitialised, as with the inline array, and a moved from buffer is empty until assigned to
+    template<typename T, std::size_t N, typename Allocator>
+    class buffer_storage {
+    public:
+        buffer_storage() : ptr(static_cast<T*>(Allocator::template allocate<bytes>())) {}
+
+        buffer_storage(std::initializer_list<T> init) : buffer_storage() {
+            std::copy_n(init.begin(), std::min(init.size(), N), ptr);
+        }
+
+        buffer_storage(buffer_storage const& other) : buffer_storage() {
+            std::copy_n(other.ptr, N, ptr);
+        }
+
+        buffer_storage(buffer_storage&& other) noexcept : ptr(std::exchange(other.ptr, nullptr)) {}
+
+        buffer_storage& operator=(buffer_storage const& other) {
+            if (this != &other) {
+                if (ptr == nullptr) {
+                    ptr = static_cast<T*>(Allocator::template allocate<bytes>());
+                }
+                std::copy_n(other.ptr, N, ptr);
+            }
+            return *this;
+        }
+
+        // the old buffer leaves with other, so assignment never frees or allocates
+        buffer_storage& operator=(buffer_storage&& other) noexcept {
+            std::swap(ptr, other.ptr);
+            return *this;
+        }
+
+        ~buffer_storage() {
+            if (ptr != nullptr) {
+                Allocator::template deallocate<bytes>(ptr);
+            }
+        }
+
+        T& operator[](std::size_t index) const noexcept { return ptr[index]; }
+        operator T*() const noexcept { return ptr; }
+
+    private:
+        static constexpr std::size_t bytes = (((sizeof(T) * (N ? N : 1)) + 63) / 64) * 64;
+        T* ptr;
+    };
+
+    template<typename T, std::size_t M, typename Allocator, typename U, std::size_t N>
+    struct rebind_storage<buffer_storage<T, M, Allocator>, U, N> { using type = buffer_storage<U, N, Allocator>; };
+
+    template<typename T, std::size_t N>
+    using heap_storage = buffer_storage<T, N, aligned_allocator>;
+
+    template<typename T, std::size_t N>
+    using pool_storage = buffer_storage<T, N, pool_allocator>;
+
+    template<typename T, std::size_t N>
+    using huge_page_storage = buffer_storage<T, N, huge_page_allocator>;
+
+    template<typename T, std::size_t N>
+    using heap_vector = vector<T, N, heap_storage<T, N>>;
+
+    template<typename T, std::size_t N>
+    using pool_vector = vector<T, N, pool_storage<T, N>>;
+
+    template<typename T, std::size_t N>
+    using huge_page_vector = vector<T, N, huge_page_storage<T, N>>;
+}
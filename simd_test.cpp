@@ -1,7 +1,26 @@
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <cfenv>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <span>
 #include <stdfloat>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "simd.hpp"
@@ -129,6 +148,32 @@ void print_supported_intructions()
     std::cout << std::endl;
 }
 
+// aligned heap that counts its blocks, to see every block find its way back
+struct counting_heap {
+    static inline std::atomic<long> outstanding = 0;
+
+    template<std::size_t Bytes>
+    static void* allocate() { ++outstanding; return simd::aligned_heap::allocate<Bytes>(); }
+
+    template<std::size_t Bytes>
+    static void deallocate(void* p) { --outstanding; simd::aligned_heap::deallocate<Bytes>(p); }
+};
+
+template<typename T, std::size_t N>
+using counting_vector = simd::vector<T, N, simd::buffer_storage<T, N, simd::cached_allocator<counting_heap, 4>>>;
+
+// a namespace scope pooled vector is destroyed after the main thread's pool, its block must bypass the dead pool and
+// reach the source. The check is constructed first, so it runs last and fails the exit status if a block went missing
+struct counting_heap_check {
+    ~counting_heap_check() {
+        if (counting_heap::outstanding != 0) {
+            std::fprintf(stderr, "%ld pooled blocks were not returned\n", counting_heap::outstanding.load());
+            std::_Exit(1);
+        }
+    }
+} const pool_exit_check;
+counting_vector<std::float32_t, 100> const static_pooled_vector{};
+
 //-----------------------------------------------------------------------------
 //  std::float32_t
 //-----------------------------------------------------------------------------
@@ -237,6 +282,1399 @@ TEST(float32_t, div)
     }
 }
 
+TEST(float32_t, compound_assign)
+{
+    const std::size_t N = 20;
+
+    simd::vector<std::float32_t, N> simd_int_array = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20};
+    simd::vector<std::float32_t, N> result = simd_int_array;
+    std::float32_t expected;
+
+    result += simd_int_array;
+    result *= 3.0f;
+    result -= 1.0f;
+    result /= simd_int_array;
+    for (int i = 0; i < N; ++i) {
+        expected = ((simd_int_array[i] + simd_int_array[i]) * 3.0f - 1.0f) / simd_int_array[i];
+        EXPECT_EQ(expected, result[i]) << "Vector result differ at index " << i;
+    }
+
+    result -= result;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(0.0f, result[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, loop_tuning)
+{
+    using vreg = simd::native_register<std::float32_t>;
+    simd::loop_tuning const& tuning = simd::tuned_loop<std::float32_t, vreg>();
+    EXPECT_TRUE(tuning.unroll == 1 || tuning.unroll == 2 || tuning.unroll == 4 || tuning.unroll == 8);
+    EXPECT_LE(tuning.prefetch, 1024u);
+
+    // measured once, every later call sees the same result
+    simd::loop_tuning const& again = simd::tuned_loop<std::float32_t, vreg>();
+    EXPECT_EQ(&tuning, &again);
+}
+
+TEST(float32_t, small_vectors)
+{
+    simd::vector<std::float32_t, 3> a = {1, 2, 3};
+    simd::vector<std::float32_t, 3> b = {4, 5, 6};
+    simd::vector<std::float32_t, 3> result = (a * b + 1.0f) / a;
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ((a[i] * b[i] + 1.0f) / a[i], result[i]) << "Vector result differ at index " << i;
+    }
+
+    simd::vector<std::float32_t, 4> q = {1, 2, 3, 4};
+    simd::vector<std::float32_t, 4> r = q * q - q;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(q[i] * q[i] - q[i], r[i]) << "Vector result differ at index " << i;
+    }
+
+    simd::vector<std::float64_t, 3> d = {1, 2, 3};
+    simd::vector<std::float64_t, 3> e = d / d + d;
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(d[i] / d[i] + d[i], e[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, register_round_trip)
+{
+    using vec4 = simd::vector<std::float32_t, 4>;
+    using vreg = vec4::vreg;
+
+    vec4 const a = {1, 2, 3, 4};
+    vreg const x = a.to_register();
+    vec4 const result = vec4::from_register(simd::add<std::float32_t, vreg>(simd::mul<std::float32_t, vreg>(x, x), x));
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(a[i] * a[i] + a[i], result[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, complex_interleaved)
+{
+    const std::size_t N = 13;
+
+    simd::complex_vector<std::float32_t, N> a;
+    simd::complex_vector<std::float32_t, N> b;
+    for (int i = 0; i < N; ++i) {
+        a[i] = {static_cast<std::float32_t>(i + 1), static_cast<std::float32_t>(2 - i)};
+        b[i] = {static_cast<std::float32_t>(3 - i), static_cast<std::float32_t>(i % 4)};
+    }
+
+    simd::complex_vector<std::float32_t, N> const product = a * b;
+    simd::complex_vector<std::float32_t, N> const scaled = a * std::complex<std::float32_t>(2, -1);
+    simd::complex_vector<std::float32_t, N> const sum = a + b - a;
+    simd::complex_vector<std::float32_t, N> const conjugate = simd::conj(a);
+    simd::vector<std::float32_t, N> const magnitude = simd::norm(a);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(a[i] * b[i], product[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(a[i] * std::complex<std::float32_t>(2, -1), scaled[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(b[i], sum[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(std::conj(a[i]), conjugate[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(std::norm(a[i]), magnitude[i]) << "Vector result differ at index " << i;
+    }
+
+    // small integer parts, so the sums are exact whatever the order
+    std::complex<std::float32_t> expected_dot = 0;
+    std::complex<std::float32_t> expected_vdot = 0;
+    for (int i = 0; i < N; ++i) {
+        expected_dot += a[i] * b[i];
+        expected_vdot += std::conj(a[i]) * b[i];
+    }
+    EXPECT_EQ(expected_dot, simd::dot(a, b));
+    EXPECT_EQ(expected_vdot, simd::vdot(a, b));
+
+    simd::complex_vector<std::float32_t, 2> const c = {{ {1, 2}, {3, 4} }};
+    EXPECT_EQ(std::complex<std::float32_t>(3, 4), c[1]);
+}
+
+TEST(float32_t, complex_tail_rounding)
+{
+    const std::size_t N = 9;
+
+    // the register pass takes the first product and the scalar tail the last, the zeros in between add exactly.
+    // This product rounds differently with and without fused multiply-add in both parts
+    std::complex<std::float32_t> const x(0x1.7df43p-2f, 0x1.221d3p-1f);
+    std::complex<std::float32_t> const y(0x1.56a81cp-1f, -0x1.663da8p-3f);
+    simd::complex_vector<std::float32_t, N> a;
+    simd::complex_vector<std::float32_t, N> b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = (i == 0 || i == N - 1) ? x : std::complex<std::float32_t>(0, 0);
+        b[i] = y;
+    }
+
+    std::complex<std::float32_t> const product = (a * b)[0];
+    EXPECT_EQ(product * 2.0f, simd::dot(a, b));
+}
+
+TEST(float32_t, soa)
+{
+    struct particle {
+        std::float32_t x;
+        std::float32_t vx;
+        std::int32_t id;
+    };
+    const std::size_t N = 1000;
+
+    std::vector<particle> particles(N);
+    for (int i = 0; i < N; ++i) {
+        particles[i] = {static_cast<std::float32_t>(i), static_cast<std::float32_t>(i % 7), i * 3};
+    }
+
+    using particles_soa = simd::soa<N, std::float32_t, std::float32_t, std::int32_t>;
+    particles_soa s = particles_soa::from_aos(particles.data(), &particle::x, &particle::vx, &particle::id);
+
+    // field-wise expressions run on whole columns
+    s.column<0>() += s.column<1>() * 0.5f;
+    simd::get<2>(s) += 1;
+
+    auto [x, vx, id] = s[10];
+    EXPECT_EQ(10.0f + 1.5f, x);
+    EXPECT_EQ(3.0f, vx);
+    EXPECT_EQ(31, id);
+    s[10] = std::tuple{-1.0f, -2.0f, -3};
+    EXPECT_EQ(-3, s.column<2>()[10]);
+
+    s.store_aos(particles.data(), &particle::x, &particle::vx, &particle::id);
+    for (int i = 0; i < N; ++i) {
+        if (i == 10) {
+            continue;
+        }
+        EXPECT_EQ(static_cast<std::float32_t>(i) + static_cast<std::float32_t>(i % 7) * 0.5f, particles[i].x) << "Vector result differ at index " << i;
+        EXPECT_EQ(i * 3 + 1, particles[i].id) << "Vector result differ at index " << i;
+    }
+    EXPECT_EQ(-2.0f, particles[10].vx);
+}
+
+TEST(float32_t, geometry_soa)
+{
+    const std::size_t N = 37;
+
+    using vec3s = simd::soa<N, std::float32_t, std::float32_t, std::float32_t>;
+    vec3s a;
+    vec3s b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = std::tuple{static_cast<std::float32_t>(i) + 1.0f, 2.0f - static_cast<std::float32_t>(i % 5), 0.5f};
+        b[i] = std::tuple{-1.0f, static_cast<std::float32_t>(i % 3), static_cast<std::float32_t>(i) * 0.25f};
+    }
+
+    simd::heap_vector<std::float32_t, N> const d = simd::dot(a, b);
+    simd::heap_vector<std::float32_t, N> const len = simd::length(a);
+    vec3s const c = simd::cross(a, b);
+    vec3s const u = simd::normalize(a);
+    for (int i = 0; i < N; ++i) {
+        auto const [ax, ay, az] = a[i];
+        auto const [bx, by, bz] = b[i];
+        std::float32_t const l = std::sqrt(ax * ax + ay * ay + az * az);
+        EXPECT_FLOAT_EQ(ax * bx + ay * by + az * bz, d[i]) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(l, len[i]) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(ay * bz - az * by, std::get<0>(c[i])) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(az * bx - ax * bz, std::get<1>(c[i])) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(ax * by - ay * bx, std::get<2>(c[i])) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(ay / l, std::get<1>(u[i])) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, geometry_aos)
+{
+    const std::size_t N = 37;
+
+    std::vector<std::array<std::float32_t, 3>> a(N);
+    std::vector<std::array<std::float32_t, 3>> b(N);
+    std::vector<std::array<std::float32_t, 4>> q(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        std::float32_t const f = static_cast<std::float32_t>(i);
+        a[i] = {f + 1.0f, 2.0f - f, f * 0.5f};
+        b[i] = {3.0f, f * f, -f};
+        q[i] = {f, 1.0f, -2.0f * f, f - 3.0f};
+    }
+
+    std::vector<std::float32_t> d(N);
+    std::vector<std::float32_t> len(N);
+    std::vector<std::array<std::float32_t, 3>> c(N);
+    std::vector<std::array<std::float32_t, 4>> u(N);
+    simd::dot(a.data(), b.data(), d.data(), N);
+    simd::length(q.data(), len.data(), N);
+    simd::cross(a.data(), b.data(), c.data(), N);
+    simd::normalize(q.data(), u.data(), N);
+    for (int i = 0; i < N; ++i) {
+        std::float32_t const l = std::sqrt(q[i][0] * q[i][0] + q[i][1] * q[i][1] + q[i][2] * q[i][2] + q[i][3] * q[i][3]);
+        EXPECT_FLOAT_EQ(a[i][0] * b[i][0] + a[i][1] * b[i][1] + a[i][2] * b[i][2], d[i]) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(l, len[i]) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(a[i][1] * b[i][2] - a[i][2] * b[i][1], c[i][0]) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(a[i][2] * b[i][0] - a[i][0] * b[i][2], c[i][1]) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(a[i][0] * b[i][1] - a[i][1] * b[i][0], c[i][2]) << "Vector result differ at index " << i;
+        for (std::size_t k = 0; k < 4; ++k) {
+            EXPECT_FLOAT_EQ(q[i][k] / l, u[i][k]) << "Vector result differ at index " << i;
+        }
+    }
+
+    // in place, a becomes the unit vectors
+    simd::normalize(a.data(), a.data(), N);
+    EXPECT_FLOAT_EQ(1.0f, std::sqrt(a[N - 1][0] * a[N - 1][0] + a[N - 1][1] * a[N - 1][1] + a[N - 1][2] * a[N - 1][2]));
+}
+
+TEST(float32_t, mat4)
+{
+    simd::mat4 a;
+    simd::mat4 b;
+    for (std::size_t r = 0; r < 4; ++r) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            a(r, c) = static_cast<std::float32_t>((r * 7 + c * 3) % 5) - 2.0f + (r == c ? 6.0f : 0.0f);
+            b(r, c) = static_cast<std::float32_t>(r) * 0.5f - static_cast<std::float32_t>(c);
+        }
+    }
+
+    simd::mat4 const ab = a * b;
+    simd::mat4 const at = simd::transpose(a);
+    simd::mat4 const identity = a * simd::inverse(a);
+    std::array<std::float32_t, 4> const v = {1.0f, -2.0f, 0.5f, 3.0f};
+    std::array<std::float32_t, 4> const av = a * v;
+    for (std::size_t r = 0; r < 4; ++r) {
+        std::float32_t expected_v = 0.0f;
+        for (std::size_t c = 0; c < 4; ++c) {
+            std::float32_t expected = 0.0f;
+            for (std::size_t k = 0; k < 4; ++k) {
+                expected += a(r, k) * b(k, c);
+            }
+            expected_v += a(r, c) * v[c];
+            EXPECT_FLOAT_EQ(expected, ab(r, c)) << "Vector result differ at index " << r * 4 + c;
+            EXPECT_EQ(a(c, r), at(r, c)) << "Vector result differ at index " << r * 4 + c;
+            EXPECT_NEAR(r == c ? 1.0f : 0.0f, identity(r, c), 1e-5f) << "Vector result differ at index " << r * 4 + c;
+        }
+        EXPECT_FLOAT_EQ(expected_v, av[r]) << "Vector result differ at index " << r;
+    }
+
+    std::array<simd::mat4, 3> chain = {a, b, at};
+    simd::multiply(a, chain.data(), chain.data(), chain.size());
+    EXPECT_FLOAT_EQ(ab(1, 2), chain[1](1, 2));
+}
+
+TEST(float32_t, transform_points)
+{
+    const std::size_t N = 37;
+
+    simd::mat4 m = simd::mat4::identity();
+    for (std::size_t r = 0; r < 3; ++r) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            m(r, c) = static_cast<std::float32_t>((r * 5 + c * 3) % 7) * 0.5f - 1.0f;
+        }
+    }
+
+    using points = simd::soa<N, std::float32_t, std::float32_t, std::float32_t>;
+    points p;
+    for (std::size_t i = 0; i < N; ++i) {
+        p[i] = std::tuple{static_cast<std::float32_t>(i), 1.0f - static_cast<std::float32_t>(i % 4), static_cast<std::float32_t>(i) * 0.125f};
+    }
+
+    points const t = simd::transform_points(m, p);
+    points const ta = simd::transform_points_affine(m, p);
+    for (int i = 0; i < N; ++i) {
+        auto const [x, y, z] = p[i];
+        auto const [tx, ty, tz] = t[i];
+        auto const [ax, ay, az] = ta[i];
+        std::array<std::float32_t, 3> const result = {tx, ty, tz};
+        std::array<std::float32_t, 3> const affine = {ax, ay, az};
+        for (std::size_t r = 0; r < 3; ++r) {
+            EXPECT_FLOAT_EQ(m(r, 0) * x + m(r, 1) * y + m(r, 2) * z + m(r, 3), result[r]) << "Vector result differ at index " << i;
+            EXPECT_EQ(result[r], affine[r]) << "Vector result differ at index " << i;
+        }
+    }
+
+    // a bottom row other than (0, 0, 0, 1) projects, the affine form ignores it
+    m(3, 0) = 0.125f;
+    m(3, 2) = 0.25f;
+    m(3, 3) = 2.0f;
+    points const projected = simd::transform_points(m, p);
+    points const ignored = simd::transform_points_affine(m, p);
+    for (int i = 0; i < N; ++i) {
+        auto const [x, y, z] = p[i];
+        auto const [tx, ty, tz] = projected[i];
+        auto const [ax, ay, az] = ignored[i];
+        std::array<std::float32_t, 3> const result = {tx, ty, tz};
+        std::array<std::float32_t, 3> const affine = {ax, ay, az};
+        std::float32_t const w = m(3, 0) * x + m(3, 1) * y + m(3, 2) * z + m(3, 3);
+        for (std::size_t r = 0; r < 3; ++r) {
+            std::float32_t const v = m(r, 0) * x + m(r, 1) * y + m(r, 2) * z + m(r, 3);
+            EXPECT_FLOAT_EQ(v / w, result[r]) << "Vector result differ at index " << i;
+            EXPECT_FLOAT_EQ(v, affine[r]) << "Vector result differ at index " << i;
+        }
+    }
+}
+
+TEST(float32_t, transpose)
+{
+    const std::size_t R = 75;
+    const std::size_t C = 37;
+
+    std::vector<std::float32_t> a(R * C);
+    for (std::size_t i = 0; i < R * C; ++i) {
+        a[i] = static_cast<std::float32_t>(i);
+    }
+    std::vector<std::float32_t> t(R * C);
+    simd::transpose(a.data(), t.data(), R, C);
+    for (int r = 0; r < R; ++r) {
+        for (int c = 0; c < C; ++c) {
+            EXPECT_EQ(a[r * C + c], t[c * R + r]) << "Vector result differ at index " << r * C + c;
+        }
+    }
+
+    simd::vector<std::float32_t, 6 * 10> v;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        v[i] = static_cast<std::float32_t>(i);
+    }
+    simd::vector<std::float32_t, 6 * 10> const vt = simd::transpose<6, 10>(v);
+    for (int r = 0; r < 6; ++r) {
+        for (int c = 0; c < 10; ++c) {
+            EXPECT_EQ(v[r * 10 + c], vt[c * 6 + r]) << "Vector result differ at index " << r * 10 + c;
+        }
+    }
+}
+
+TEST(float64_t, transpose)
+{
+    const std::size_t R = 37;
+    const std::size_t C = 21;
+
+    std::vector<std::float64_t> a(R * C);
+    for (std::size_t i = 0; i < R * C; ++i) {
+        a[i] = static_cast<std::float64_t>(i) * 0.5;
+    }
+    std::vector<std::float64_t> t(R * C);
+    simd::transpose(a.data(), t.data(), R, C);
+    for (int r = 0; r < R; ++r) {
+        for (int c = 0; c < C; ++c) {
+            EXPECT_EQ(a[r * C + c], t[c * R + r]) << "Vector result differ at index " << r * C + c;
+        }
+    }
+
+    // 64bit integer lanes go through the double kernels
+    std::array<__m128i, 2> const q = simd::transpose<std::int64_t, __m128i>(std::array<__m128i, 2>{_mm_set_epi64x(1, 0), _mm_set_epi64x(3, 2)});
+    std::array<std::int64_t, 4> qt;
+    simd::store<__m128i>(&qt[0], q[0]);
+    simd::store<__m128i>(&qt[2], q[1]);
+    EXPECT_EQ((std::array<std::int64_t, 4>{0, 2, 1, 3}), qt);
+}
+
+TEST(int32_t, transpose)
+{
+    const std::size_t R = 75;
+    const std::size_t C = 37;
+
+    std::vector<std::int32_t> a(R * C);
+    for (std::size_t i = 0; i < R * C; ++i) {
+        a[i] = static_cast<std::int32_t>(i) - 1000;
+    }
+    std::vector<std::int32_t> t(R * C);
+    simd::transpose(a.data(), t.data(), R, C);
+    for (int r = 0; r < R; ++r) {
+        for (int c = 0; c < C; ++c) {
+            EXPECT_EQ(a[r * C + c], t[c * R + r]) << "Vector result differ at index " << r * C + c;
+        }
+    }
+
+    // the integer register kernel on its own
+    std::array<__m128i, 4> rows;
+    for (int r = 0; r < 4; ++r) {
+        rows[r] = _mm_setr_epi32(r * 4, r * 4 + 1, r * 4 + 2, r * 4 + 3);
+    }
+    std::array<__m128i, 4> const cols = simd::transpose<std::int32_t, __m128i>(rows);
+    for (int r = 0; r < 4; ++r) {
+        std::array<std::int32_t, 4> lanes;
+        simd::store<__m128i>(lanes.data(), cols[r]);
+        for (int c = 0; c < 4; ++c) {
+            EXPECT_EQ(c * 4 + r, lanes[c]) << "Vector result differ at index " << r * 4 + c;
+        }
+    }
+}
+
+TEST(int16_t, transpose)
+{
+    const std::size_t R = 37;
+    const std::size_t C = 75;
+
+    std::vector<std::int16_t> a(R * C);
+    for (std::size_t i = 0; i < R * C; ++i) {
+        a[i] = static_cast<std::int16_t>(i);
+    }
+    std::vector<std::int16_t> t(R * C);
+    simd::transpose(a.data(), t.data(), R, C);
+    for (int r = 0; r < R; ++r) {
+        for (int c = 0; c < C; ++c) {
+            EXPECT_EQ(a[r * C + c], t[c * R + r]) << "Vector result differ at index " << r * C + c;
+        }
+    }
+}
+
+TEST(uint8_t, transpose)
+{
+    const std::size_t R = 70;
+    const std::size_t C = 37;
+
+    std::vector<std::uint8_t> a(R * C);
+    for (std::size_t i = 0; i < R * C; ++i) {
+        a[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    std::vector<std::uint8_t> t(R * C);
+    simd::transpose(a.data(), t.data(), R, C);
+    for (int r = 0; r < R; ++r) {
+        for (int c = 0; c < C; ++c) {
+            EXPECT_EQ(a[r * C + c], t[c * R + r]) << "Vector result differ at index " << r * C + c;
+        }
+    }
+}
+
+TEST(q15, arithmetic)
+{
+    const std::size_t N = 37;
+
+    simd::vector<simd::q15, N> a;
+    simd::vector<simd::q15, N> b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = simd::q15::from_raw(static_cast<std::int16_t>(i * 1777 - 32768));
+        b[i] = simd::q15::from_raw(static_cast<std::int16_t>(32767 - i * 2311));
+    }
+    a[0] = simd::q15::min();
+    b[0] = simd::q15::min();
+    b[1] = simd::q15::max();
+
+    simd::vector<simd::q15, N> const sum = a + b;
+    simd::vector<simd::q15, N> const diff = a - b;
+    simd::vector<simd::q15, N> const prod = a * b;
+    simd::vector<simd::q15, N> const scaled = a * simd::q15(0.5f);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ((a[i] + b[i]).raw, sum[i].raw) << "Vector result differ at index " << i;
+        EXPECT_EQ((a[i] - b[i]).raw, diff[i].raw) << "Vector result differ at index " << i;
+        EXPECT_EQ((a[i] * b[i]).raw, prod[i].raw) << "Vector result differ at index " << i;
+        EXPECT_EQ((a[i] * simd::q15(0.5f)).raw, scaled[i].raw) << "Vector result differ at index " << i;
+    }
+    EXPECT_EQ(simd::q15::max(), prod[0]);
+    EXPECT_EQ(simd::q15::min(), diff[0] - simd::q15::max() - simd::q15::max());
+    EXPECT_EQ(simd::q15(0.25f), simd::q15(0.5f) * simd::q15(0.5f));
+    EXPECT_EQ(simd::q15::max(), simd::q15(1.5f));
+
+    simd::vector<float, N> f;
+    for (std::size_t i = 0; i < N; ++i) {
+        f[i] = static_cast<float>(i) * 0.06f - 1.1f + 1.0f / 65536.0f;
+    }
+    simd::vector<simd::q15, N> const q = simd::to_fixed<simd::q15>(f);
+    simd::vector<float, N> const back = simd::to_float(q);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(simd::q15(f[i]).raw, q[i].raw) << "Vector result differ at index " << i;
+        EXPECT_EQ(static_cast<float>(q[i]), back[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(q31, arithmetic)
+{
+    const std::size_t N = 37;
+
+    simd::vector<simd::q31, N> a;
+    simd::vector<simd::q31, N> b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = simd::q31::from_raw(static_cast<std::int32_t>(static_cast<std::int64_t>(i) * 116537831 - 2147483648LL));
+        b[i] = simd::q31::from_raw(static_cast<std::int32_t>(2147483647LL - static_cast<std::int64_t>(i) * 97312017));
+    }
+    a[0] = simd::q31::min();
+    b[0] = simd::q31::min();
+    b[1] = simd::q31::max();
+
+    simd::vector<simd::q31, N> const sum = a + b;
+    simd::vector<simd::q31, N> const diff = a - b;
+    simd::vector<simd::q31, N> const prod = a * b;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ((a[i] + b[i]).raw, sum[i].raw) << "Vector result differ at index " << i;
+        EXPECT_EQ((a[i] - b[i]).raw, diff[i].raw) << "Vector result differ at index " << i;
+        EXPECT_EQ((a[i] * b[i]).raw, prod[i].raw) << "Vector result differ at index " << i;
+    }
+    EXPECT_EQ(simd::q31::max(), prod[0]);
+    EXPECT_EQ(simd::q31(-0.25f), simd::q31(0.5f) * simd::q31(-0.5f));
+
+    simd::vector<float, N> f;
+    for (std::size_t i = 0; i < N; ++i) {
+        f[i] = static_cast<float>(i) * 0.06f - 1.1f;
+    }
+    simd::vector<simd::q31, N> const q = simd::to_fixed<simd::q31>(f);
+    simd::vector<float, N> const back = simd::to_float(q);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(simd::q31(f[i]).raw, q[i].raw) << "Vector result differ at index " << i;
+        EXPECT_EQ(static_cast<float>(q[i]), back[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(uint32_t, random_engines)
+{
+    // Random123 known answer for philox4x32-10 with key 0 and counter 0
+    simd::philox4x32 philox(0);
+    std::array<std::uint32_t, 4> kat;
+    philox.fill(kat.data(), kat.size());
+    EXPECT_EQ(0x6627E8D5u, kat[0]);
+    EXPECT_EQ(0xE169C58Du, kat[1]);
+    EXPECT_EQ(0xBC57AC4Cu, kat[2]);
+    EXPECT_EQ(0x9B00DBD8u, kat[3]);
+
+    // lane 0 of xoshiro256++ against the reference, seeded by splitmix64
+    std::array<std::uint64_t, 4> s;
+    std::uint64_t seed = 42;
+    for (auto& w : s) {
+        seed += 0x9E3779B97F4A7C15ull;
+        std::uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        w = z ^ (z >> 31);
+    }
+    auto const rotl = [](std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); };
+    simd::xoshiro256pp xoshiro(42);
+    std::vector<std::uint32_t> words(16 * 5);
+    xoshiro.fill(words.data(), words.size());
+    for (std::size_t step = 0; step < 5; ++step) {
+        std::uint64_t const expected = rotl(s[0] + s[3], 23) + s[0];
+        std::uint64_t const t = s[1] << 17;
+        s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3]; s[2] ^= t; s[3] = rotl(s[3], 45);
+        EXPECT_EQ(expected, words[step * 16] | (std::uint64_t(words[step * 16 + 1]) << 32)) << "Vector result differ at index " << step;
+    }
+
+    // the same words however a fill is split, and philox can seek to any word
+    const std::size_t N = 137;
+    std::vector<std::uint32_t> whole(N), parts(N), x1(N), x2(N);
+    simd::philox4x32 p1(7, 3), p2(7, 3);
+    p1.fill(whole.data(), N);
+    p2.fill(parts.data(), 5);
+    p2.fill(parts.data() + 5, 40);
+    p2.fill(parts.data() + 45, N - 45);
+    simd::xoshiro256pp q1(7), q2(7);
+    q1.fill(x1.data(), N);
+    q2.fill(x2.data(), 3);
+    q2.fill(x2.data() + 3, 70);
+    q2.fill(x2.data() + 73, N - 73);
+    simd::philox4x32 p3(7, 3);
+    p3.seek(61);
+    std::uint32_t at61;
+    p3.fill(&at61, 1);
+    EXPECT_EQ(whole[61], at61);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(whole[i], parts[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(x1[i], x2[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, random_distributions)
+{
+    const std::size_t N = 20001;
+
+    simd::xoshiro256pp engine(1234);
+    std::vector<std::float32_t> u(N), z(N);
+    std::vector<std::int32_t> k(N);
+    std::vector<std::uint8_t> b(N);
+    simd::fill_uniform(engine, u.data(), N, -2.0f, 3.0f);
+    simd::fill_uniform(engine, k.data(), N, -5, 5);
+    simd::fill_uniform(engine, b.data(), N);
+    simd::fill_normal(engine, z.data(), N, 1.0f, 2.0f);
+
+    double u_sum = 0, k_sum = 0, z_sum = 0, z_sq = 0;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_TRUE(u[i] >= -2.0f && u[i] < 3.0f) << "Vector result differ at index " << i;
+        EXPECT_TRUE(k[i] >= -5 && k[i] <= 5) << "Vector result differ at index " << i;
+        u_sum += u[i];
+        k_sum += k[i];
+        z_sum += z[i];
+        z_sq += (z[i] - 1.0) * (z[i] - 1.0);
+    }
+    EXPECT_NEAR(0.5, u_sum / N, 0.05);
+    EXPECT_NEAR(0.0, k_sum / N, 0.1);
+    EXPECT_NEAR(1.0, z_sum / N, 0.05);
+    EXPECT_NEAR(4.0, z_sq / N, 0.15);
+    EXPECT_EQ(255, *std::max_element(b.begin(), b.end()));
+
+    simd::vector<double, 37> d;
+    simd::philox4x32 counter(99);
+    simd::fill_normal(counter, d);
+    simd::fill_uniform(counter, std::span(u.data(), 37), 10.0f, 11.0f);
+    for (int i = 0; i < 37; ++i) {
+        EXPECT_TRUE(std::isfinite(d[i]) && std::abs(d[i]) < 10.0) << "Vector result differ at index " << i;
+        EXPECT_TRUE(u[i] >= 10.0f && u[i] < 11.0f) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, random_normal_pairing)
+{
+    const std::size_t N = 1000;
+
+    // the same pairing of words as the registers, computed with the scalar library functions
+    simd::xoshiro256pp words_engine(77);
+    std::vector<std::uint32_t> w(1008);
+    words_engine.fill(w.data(), w.size());
+    std::vector<std::float32_t> reference(N);
+    for (std::size_t i = 0; i < N; i += 16) {
+        for (std::size_t k = 0; k < 8 && i + k < N; ++k) {
+            std::float32_t const r = std::sqrt(-2.0f * std::log(1.0f - simd::unit_float(w[i + k])));
+            std::float32_t const theta = 2.0f * std::numbers::pi_v<std::float32_t> * simd::unit_float(w[i + k + 8]);
+            reference[i + k] = r * std::cos(theta);
+            if (i + k + 8 < N) {
+                reference[i + k + 8] = r * std::sin(theta);
+            }
+        }
+    }
+
+    simd::xoshiro256pp engine(77);
+    std::vector<std::float32_t> whole(N);
+    simd::fill_normal(engine, whole.data(), N);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_NEAR(reference[i], whole[i], 1e-4f * (1.0f + std::abs(reference[i]))) << "Vector result differ at index " << i;
+    }
+
+    // parts that are whole groups of 16, the last one cut short, give the same values as one fill
+    simd::xoshiro256pp split(77);
+    std::vector<std::float32_t> parts(N);
+    simd::fill_normal(split, parts.data(), 48);
+    simd::fill_normal(split, parts.data() + 48, 592);
+    simd::fill_normal(split, parts.data() + 640, N - 640);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(whole[i], parts[i]) << "Vector result differ at index " << i;
+    }
+
+    // and the engine ends up at the same word, the last group is used up either way
+    std::uint32_t next_whole, next_parts;
+    engine.fill(&next_whole, 1);
+    split.fill(&next_parts, 1);
+    EXPECT_EQ(next_whole, next_parts);
+}
+
+TEST(uint8_t, crc)
+{
+    // the standard check values of "123456789"
+    std::string const check = "123456789";
+    std::span<std::uint8_t const> const bytes(reinterpret_cast<std::uint8_t const*>(check.data()), check.size());
+    EXPECT_EQ(0xE3069283u, simd::crc32c(bytes));
+    EXPECT_EQ(0xCBF43926u, simd::crc32(bytes));
+
+    auto const reference = [](std::uint8_t const* p, std::size_t n, std::uint32_t poly) {
+        std::uint32_t c = ~0u;
+        for (std::size_t i = 0; i < n; ++i) {
+            c ^= p[i];
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (c >> 1) ^ poly : c >> 1;
+            }
+        }
+        return ~c;
+    };
+
+    // lengths either side of the fold and three stream block sizes, from unaligned starts
+    std::mt19937 gen(7);
+    std::vector<std::uint8_t> data(30000);
+    for (auto& b : data) {
+        b = static_cast<std::uint8_t>(gen());
+    }
+    for (std::size_t n : {0, 1, 7, 8, 15, 16, 63, 64, 65, 80, 767, 768, 769, 1000, 12287, 12288, 12289, 29000}) {
+        std::uint8_t const* const p = data.data() + (n % 5);
+        EXPECT_EQ(reference(p, n, 0x82F63B78u), simd::crc32c(p, n)) << "Vector result differ at index " << n;
+        EXPECT_EQ(reference(p, n, 0xEDB88320u), simd::crc32(p, n)) << "Vector result differ at index " << n;
+    }
+
+    // continuing from a previous result is the same as one pass
+    EXPECT_EQ(simd::crc32c(data.data(), 20000), simd::crc32c(data.data() + 13000, 7000, simd::crc32c(data.data(), 13000)));
+    EXPECT_EQ(simd::crc32(data.data(), 20000), simd::crc32(data.data() + 13000, 7000, simd::crc32(data.data(), 13000)));
+
+    simd::vector<std::uint8_t, 1000> v;
+    std::copy_n(data.begin(), 1000, &v[0]);
+    EXPECT_EQ(reference(data.data(), 1000, 0x82F63B78u), simd::crc32c(v));
+    EXPECT_EQ(reference(data.data(), 1000, 0xEDB88320u), simd::crc32(v));
+}
+
+TEST(uint8_t, hash64)
+{
+    // pinned values, which the scalar and register paths must both give
+    std::vector<std::uint8_t> data(5000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint8_t>((i * 31) + 7);
+    }
+    std::array<std::pair<std::size_t, std::uint64_t>, 11> const expected = {{
+        {0, 0xC869F388EA1641A2ull},
+        {3, 0x5BE3D011306DE8F1ull},
+        {7, 0xC87AAAF39106BD73ull},
+        {16, 0x74D0678507E672DAull},
+        {100, 0x8219CE3AB2EEE50Bull},
+        {128, 0x12E0FCBEBC2D70C2ull},
+        {129, 0x674A47A1976332F1ull},
+        {1000, 0x02652A818A0AF2E9ull},
+        {1024, 0xC67048AD40303190ull},
+        {1025, 0x1526E3C188397CDEull},
+        {5000, 0x0C479C67AC41BB7Dull},
+    }};
+    for (auto const& [n, h] : expected) {
+        EXPECT_EQ(h, simd::hash64(std::span<std::uint8_t const>(data.data(), n))) << "Vector result differ at index " << n;
+    }
+    EXPECT_EQ(0xED51A987A7E492C1ull, simd::hash64(data.data(), 1000, 12345));
+
+    // flipping any one input bit changes about half of the output bits
+    std::size_t flipped = 0;
+    std::size_t const n = 300;
+    std::uint64_t const base = simd::hash64(data.data(), n);
+    for (std::size_t bit = 0; bit < n * 8; ++bit) {
+        data[bit / 8] ^= std::uint8_t(1u << (bit % 8));
+        std::uint64_t const h = simd::hash64(data.data(), n);
+        data[bit / 8] ^= std::uint8_t(1u << (bit % 8));
+        EXPECT_NE(base, h) << "Vector result differ at index " << bit;
+        flipped += std::popcount(base ^ h);
+    }
+    double const mean = double(flipped) / double(n * 8);
+    EXPECT_GT(mean, 30.0);
+    EXPECT_LT(mean, 34.0);
+
+    simd::vector<std::uint8_t, 200> v;
+    std::copy_n(data.begin(), 200, &v[0]);
+    EXPECT_EQ(simd::hash64(data.data(), 200), simd::hash64(v));
+    EXPECT_NE(simd::hash64(v), simd::hash64(v, 1));
+}
+
+TEST(uint8_t, hex)
+{
+    simd::vector<std::uint8_t, 37> v;
+    for (std::size_t i = 0; i < 37; ++i) {
+        v[i] = static_cast<std::uint8_t>((i * 37) + 11);
+    }
+    auto const text = simd::hex_encode(v);
+    for (std::size_t i = 0; i < 37; ++i) {
+        EXPECT_EQ(simd::hex_digits[0][v[i] >> 4], text[i * 2]) << "Vector result differ at index " << i;
+        EXPECT_EQ(simd::hex_digits[0][v[i] & 0x0F], text[(i * 2) + 1]) << "Vector result differ at index " << i;
+    }
+
+    // either case decodes, odd lengths and other characters do not
+    std::vector<std::uint8_t> upper(74);
+    EXPECT_EQ(74u, simd::hex_encode(std::span<std::uint8_t const>(&v[0], 37), upper, true));
+    simd::vector<std::uint8_t, 37> back;
+    EXPECT_TRUE(simd::hex_decode(text, back));
+    EXPECT_EQ(37u, simd::hex_decode(upper, std::span<std::uint8_t>(&back[0], 37)));
+    for (std::size_t i = 0; i < 37; ++i) {
+        EXPECT_EQ(v[i], back[i]) << "Vector result differ at index " << i;
+    }
+    std::array<std::uint8_t, 40> out;
+    EXPECT_EQ(simd::decode_error, simd::hex_decode(std::string_view("abc"), out));
+    for (std::size_t i : {0, 31, 60, 73}) {
+        for (char c : {'g', 'G', '/', ':', '@', '`', ' '}) {
+            std::vector<std::uint8_t> bad = upper;
+            bad[i] = static_cast<std::uint8_t>(c);
+            EXPECT_EQ(simd::decode_error, simd::hex_decode(bad, out)) << "Vector result differ at index " << i;
+        }
+    }
+}
+
+TEST(uint8_t, base64)
+{
+    // RFC 4648 test vectors
+    std::array<std::pair<std::string_view, std::string_view>, 7> const rfc = {{
+        {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"}, {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+    }};
+    for (auto const& [plain, encoded] : rfc) {
+        std::array<std::uint8_t, 8> out;
+        std::size_t const n = simd::base64_encode(std::span(reinterpret_cast<std::uint8_t const*>(plain.data()), plain.size()), out);
+        EXPECT_EQ(encoded, std::string_view(reinterpret_cast<char const*>(out.data()), n));
+        EXPECT_EQ(plain.size(), simd::base64_decode(encoded, out));
+        EXPECT_EQ(plain, std::string_view(reinterpret_cast<char const*>(out.data()), plain.size()));
+    }
+
+    // round trips of every length through the register loops and the tail
+    std::mt19937 gen(5);
+    for (std::size_t n = 0; n < 200; ++n) {
+        std::vector<std::uint8_t> data(n);
+        for (auto& b : data) {
+            b = static_cast<std::uint8_t>(gen());
+        }
+        std::vector<std::uint8_t> text(simd::base64_encoded_size(n));
+        EXPECT_EQ(text.size(), simd::base64_encode(data, text));
+        std::vector<std::uint8_t> back(simd::base64_decoded_size(text.size()));
+        EXPECT_EQ(n, simd::base64_decode(text, back)) << "Vector result differ at index " << n;
+        EXPECT_TRUE(std::equal(data.begin(), data.end(), back.begin())) << "Vector result differ at index " << n;
+
+        // any character outside the alphabet, and '=' before the end, is rejected
+        if (n > 0) {
+            std::vector<std::uint8_t> bad = text;
+            bad[gen() % (text.size() - 2)] = static_cast<std::uint8_t>("=-_ \n*\x80"[gen() % 7]);
+            EXPECT_EQ(simd::decode_error, simd::base64_decode(bad, back)) << "Vector result differ at index " << n;
+        }
+    }
+    std::array<std::uint8_t, 8> out;
+    for (std::string_view bad : {"Zg=", "Z===", "Zg=a", "=Zg=", "Zm9vYg=a"}) {
+        EXPECT_EQ(simd::decode_error, simd::base64_decode(bad, out)) << bad;
+    }
+
+    simd::vector<std::uint8_t, 37> v;
+    for (std::size_t i = 0; i < 37; ++i) {
+        v[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    auto const text = simd::base64_encode(v);
+    simd::vector<std::uint8_t, simd::base64_decoded_size(text.size())> back;
+    EXPECT_EQ(37u, simd::base64_decode(text, back));
+    for (std::size_t i = 0; i < 37; ++i) {
+        EXPECT_EQ(v[i], back[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(uint8_t, utf8_validate)
+{
+    EXPECT_TRUE(simd::utf8_validate(std::string_view("")));
+    EXPECT_TRUE(simd::utf8_validate(std::string_view("plain ascii that is longer than one register of bytes")));
+    EXPECT_TRUE(simd::utf8_validate(std::string_view("\xC2\x80 \xDF\xBF \xE0\xA0\x80 \xED\x9F\xBF \xEE\x80\x80 \xF0\x90\x80\x80 \xF4\x8F\xBF\xBF")));
+
+    // overlong forms, surrogates, past U+10FFFF, stray and missing continuations
+    for (std::string_view bad : {"\xC0\x80", "\xC1\xBF", "\xE0\x9F\xBF", "\xF0\x8F\xBF\xBF", "\xED\xA0\x80", "\xED\xBF\xBF",
+                                 "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", "\x80", "\xC2", "\xE2\x82", "\xF0\x9F\x98",
+                                 "\xC2\x41", "\xE2\x28\xA1", "\xC2\x80\x80"}) {
+        EXPECT_FALSE(simd::utf8_validate(bad)) << "Vector result differ at index " << bad.size();
+
+        // the same sequence at every offset across a register boundary, and with ascii after it
+        for (std::size_t at = 0; at < 40; ++at) {
+            std::string s(at, 'a');
+            s += bad;
+            EXPECT_FALSE(simd::utf8_validate(s)) << "Vector result differ at index " << at;
+            s += std::string(40, 'b');
+            EXPECT_FALSE(simd::utf8_validate(s)) << "Vector result differ at index " << at;
+        }
+    }
+    for (std::size_t at = 0; at < 40; ++at) {
+        std::string s(at, 'a');
+        s += "\xF0\x9F\x98\x80";
+        EXPECT_TRUE(simd::utf8_validate(s)) << "Vector result differ at index " << at;
+    }
+
+    // random text against the scalar check
+    std::mt19937 gen(9);
+    for (std::size_t t = 0; t < 2000; ++t) {
+        std::vector<std::uint8_t> text;
+        while (text.size() < 70) {
+            std::uint8_t const lead = static_cast<std::uint8_t>(gen());
+            text.push_back(lead);
+            for (std::size_t k = 0; k < std::size_t(std::countl_one(lead)) && k < 3; ++k) {
+                text.push_back(static_cast<std::uint8_t>(0x80 | (gen() & 0x3F)));
+            }
+        }
+        EXPECT_EQ(simd::utf8_validate_scalar(text.data(), text.size()), simd::utf8_validate(text)) << "Vector result differ at index " << t;
+    }
+
+    simd::vector<std::uint8_t, 37> v;
+    std::fill_n(&v[0], 37, std::uint8_t('x'));
+    EXPECT_TRUE(simd::utf8_validate(v));
+    v[36] = 0xC3;
+    EXPECT_FALSE(simd::utf8_validate(v));
+}
+
+TEST(float32_t, sparse_vector)
+{
+    simd::vector<std::float32_t, 37> a{};
+    for (std::size_t i = 0; i < 37; i += 3) {
+        a[i] = static_cast<std::float32_t>(i) - 10.0f;
+    }
+    auto const s = simd::sparse_vector<std::float32_t>::from_dense(a);
+    EXPECT_EQ(37, s.dimension());
+    EXPECT_EQ(13, s.nonzeros());
+
+    simd::vector<std::float32_t, 37> b{};
+    s.to_dense(b);
+    for (std::size_t i = 0; i < 37; ++i) {
+        EXPECT_EQ(a[i], b[i]) << "Vector result differ at index " << i;
+    }
+
+    // 100K dimensions at about 3% density, integer values so every order of summation is exact
+    std::mt19937 gen(50);
+    std::size_t const n = 100'003;
+    std::vector<std::float32_t> dense(n), x(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        dense[i] = gen() % 32 == 0 ? static_cast<std::float32_t>(int(gen() % 9) - 4) : 0.0f;
+        x[i] = static_cast<std::float32_t>(int(gen() % 7) - 3);
+    }
+    auto const sx = simd::sparse_vector<std::float32_t>::from_dense(dense.data(), n);
+    EXPECT_EQ(static_cast<std::size_t>(std::count_if(dense.begin(), dense.end(), [](std::float32_t v) { return v != 0.0f; })), sx.nonzeros());
+    EXPECT_TRUE(std::is_sorted(sx.indices().begin(), sx.indices().end()));
+
+    std::vector<std::float32_t> round(n, 1.0f);
+    sx.to_dense(round.data());
+    EXPECT_TRUE(round == dense);
+
+    std::float32_t expect = 0.0f;
+    for (std::size_t i = 0; i < n; ++i) {
+        expect += dense[i] * x[i];
+    }
+    EXPECT_EQ(expect, simd::dot(sx, std::span<std::float32_t const>(x)));
+
+    std::vector<std::float32_t> y = x;
+    simd::axpy(2.0f, sx, std::span<std::float32_t>(y));
+    for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(x[i] + 2.0f * dense[i], y[i]) << "Vector result differ at index " << i;
+    }
+
+    // repeated indices, including a whole register of the same one
+    std::vector<std::uint32_t> idx;
+    std::vector<std::float32_t> val;
+    for (std::size_t k = 0; k < 1000; ++k) {
+        idx.push_back(gen() % 37);
+        val.push_back(static_cast<std::float32_t>(int(gen() % 9) - 4));
+    }
+    idx.insert(idx.end(), 16, 5u);
+    val.insert(val.end(), 16, 1.0f);
+    simd::vector<std::float32_t, 37> sum{};
+    simd::scatter_add(std::span<std::uint32_t const>(idx), std::span<std::float32_t const>(val), sum);
+    std::array<std::float32_t, 37> expect_sum{};
+    for (std::size_t k = 0; k < idx.size(); ++k) {
+        expect_sum[idx[k]] += val[k];
+    }
+    for (std::size_t i = 0; i < 37; ++i) {
+        EXPECT_EQ(expect_sum[i], sum[i]) << "Vector result differ at index " << i;
+    }
+
+    EXPECT_THROW(simd::sparse_vector<std::float32_t>(10, {3, 2}, {1.0f, 1.0f}), std::invalid_argument);
+    EXPECT_THROW(simd::sparse_vector<std::float32_t>(10, {3, 10}, {1.0f, 1.0f}), std::invalid_argument);
+
+    // the gathers sign extend 32bit indices, so dimensions stop at 2^31
+    std::size_t const limit = std::size_t(1) << 31;
+    simd::sparse_vector<std::float32_t> const widest(limit, {0, static_cast<std::uint32_t>(limit - 1)}, {1.0f, 2.0f});
+    EXPECT_EQ(limit, widest.dimension());
+    EXPECT_THROW(simd::sparse_vector<std::float32_t>(limit + 1), std::invalid_argument);
+    EXPECT_THROW(simd::sparse_vector<std::float32_t>(std::size_t(1) << 32), std::invalid_argument);
+}
+
+TEST(float64_t, sparse_vector)
+{
+    std::mt19937 gen(51);
+    std::size_t const n = 10'007;
+    std::vector<std::float64_t> dense(n), x(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        dense[i] = gen() % 20 == 0 ? static_cast<std::float64_t>(int(gen() % 9) - 4) : 0.0;
+        x[i] = static_cast<std::float64_t>(int(gen() % 7) - 3);
+    }
+    auto const sx = simd::sparse_vector<std::float64_t>::from_dense(dense.data(), n);
+    std::vector<std::float64_t> round(n, 1.0);
+    sx.to_dense(round.data());
+    EXPECT_TRUE(round == dense);
+
+    std::float64_t expect = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        expect += dense[i] * x[i];
+    }
+    EXPECT_EQ(expect, simd::dot(sx, x.data()));
+
+    std::vector<std::float64_t> y = x;
+    simd::axpy(-0.5, sx, y.data());
+    for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(x[i] - 0.5 * dense[i], y[i]) << "Vector result differ at index " << i;
+    }
+
+    std::vector<std::uint32_t> idx;
+    std::vector<std::float64_t> val;
+    for (std::size_t k = 0; k < 1000; ++k) {
+        idx.push_back(gen() % 37);
+        val.push_back(static_cast<std::float64_t>(int(gen() % 9) - 4));
+    }
+    simd::vector<std::float64_t, 37> sum{};
+    simd::scatter_add(std::span<std::uint32_t const>(idx), std::span<std::float64_t const>(val), sum);
+    std::array<std::float64_t, 37> expect_sum{};
+    for (std::size_t k = 0; k < idx.size(); ++k) {
+        expect_sum[idx[k]] += val[k];
+    }
+    for (std::size_t i = 0; i < 37; ++i) {
+        EXPECT_EQ(expect_sum[i], sum[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, heap_storage)
+{
+    const std::size_t N = 20;
+
+    simd::heap_vector<std::float32_t, N> a = {{1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20}};
+    simd::heap_vector<std::float32_t, N> b = a;
+    EXPECT_NE(&a[0], &b[0]);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(&a[0]) % 64);
+
+    // the temporary from a * b is reused for the additions, its buffer ends up in result
+    simd::heap_vector<std::float32_t, N> result = a * b + a + 1.0f;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(a[i] * b[i] + a[i] + 1.0f, result[i]) << "Vector result differ at index " << i;
+    }
+
+    std::float32_t const* const buffer = &b[0];
+    simd::heap_vector<std::float32_t, N> moved = std::move(b);
+    EXPECT_EQ(buffer, &moved[0]);
+    b = a;
+    EXPECT_EQ(a[N - 1], b[N - 1]);
+}
+
+TEST(float32_t, pool_storage)
+{
+    const std::size_t N = 100;
+
+    std::float32_t const* buffer;
+    {
+        simd::pool_vector<std::float32_t, N> a;
+        buffer = &a[0];
+    }
+
+    // the block released above is handed out again
+    simd::pool_vector<std::float32_t, N> a;
+    EXPECT_EQ(buffer, &a[0]);
+    std::iota(a.begin(), a.end(), 1.0f);
+
+    simd::pool_vector<std::float32_t, N> result = (a + a) * 2.0f - a;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ((a[i] + a[i]) * 2.0f - a[i], result[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, storage_after_pool)
+{
+    const std::size_t N = 100;
+
+    // the thread_local vector is constructed empty before the thread's pool exists, so the pool is destroyed first
+    // and the block is freed afterwards
+    long const before = counting_heap::outstanding;
+    std::jthread([] {
+        thread_local std::optional<counting_vector<std::float32_t, N>> late;
+        late.emplace();
+        std::iota(late->begin(), late->end(), 1.0f);
+    }).join();
+    EXPECT_EQ(before, counting_heap::outstanding.load());
+}
+
+TEST(float32_t, huge_page_storage)
+{
+    const std::size_t N = 1000;
+
+    simd::huge_page_vector<std::float32_t, N> a;
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(&a[0]) % (2 * 1024 * 1024));
+    std::iota(a.begin(), a.end(), 1.0f);
+
+    simd::huge_page_vector<std::float32_t, N> result = a * a;
+    result += a;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(a[i] * a[i] + a[i], result[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, storage_reuse)
+{
+    const std::size_t N = 1000;
+
+    // once an expression has run, its temporaries come back out of the free list instead of the heap or mmap
+    simd::heap_vector<std::float32_t, N> a;
+    simd::huge_page_vector<std::float32_t, N> h;
+    std::iota(a.begin(), a.end(), 1.0f);
+    std::iota(h.begin(), h.end(), 1.0f);
+
+    std::float32_t const* heap_buffer;
+    std::float32_t const* huge_buffer;
+    {
+        simd::heap_vector<std::float32_t, N> r = a * a;
+        simd::huge_page_vector<std::float32_t, N> s = h * h;
+        heap_buffer = &r[0];
+        huge_buffer = &s[0];
+    }
+    for (int k = 0; k < 3; ++k) {
+        simd::heap_vector<std::float32_t, N> r = a * a + a;
+        simd::huge_page_vector<std::float32_t, N> s = h * h + h;
+        EXPECT_EQ(heap_buffer, &r[0]);
+        EXPECT_EQ(huge_buffer, &s[0]);
+        for (int i = 0; i < N; ++i) {
+            EXPECT_EQ(a[i] * a[i] + a[i], r[i]) << "Vector result differ at index " << i;
+            EXPECT_EQ(h[i] * h[i] + h[i], s[i]) << "Vector result differ at index " << i;
+        }
+    }
+}
+
+TEST(float32_t, constant_evaluation)
+{
+    const std::size_t N = 20;
+
+    constexpr simd::vector<std::float32_t, N> simd_int_array = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20};
+    constexpr simd::vector<std::float32_t, N> result1 = (simd_int_array * simd_int_array + 1.0f) / 2.0f - simd_int_array;
+    static_assert(result1[19] == (20.0f * 20.0f + 1.0f) / 2.0f - 20.0f);
+
+    // the same expression evaluated at runtime goes through the simd loops
+    simd::vector<std::float32_t, N> runtime_array = simd_int_array;
+    simd::vector<std::float32_t, N> result2 = (runtime_array * runtime_array + 1.0f) / 2.0f - runtime_array;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(result1[i], result2[i]) << "Vector result1 and result2 differ at index " << i;
+    }
+
+    constexpr simd::vector<std::float32_t, N> table = [] {
+        simd::vector<std::float32_t, N> t{};
+        for (std::size_t i = 0; i < N; ++i) {
+            t += 1.0f;
+            t *= 2.0f;
+        }
+        return t;
+    }();
+    static_assert(table[0] == 2097150.0f);
+}
+
+TEST(float32_t, pipeline)
+{
+    const std::size_t N = 10003;
+
+    simd::heap_vector<std::float32_t, N> in;
+    simd::heap_vector<std::float32_t, N> out;
+    for (int i = 0; i < N; ++i) {
+        in[i] = static_cast<std::float32_t>(i % 300) - 100.0f;
+    }
+
+    simd::pipeline const p{simd::scale<std::float32_t>{0.5f}, simd::offset<std::float32_t>{1.0f}, simd::clamp<std::float32_t>{0.0f, 100.0f}};
+    p.transform(in, out);
+
+    double expected_sum = 0.0;
+    std::float32_t expected_max = 0.0f;
+    for (int i = 0; i < N; ++i) {
+        std::float32_t const expected = std::min(std::max(in[i] * 0.5f + 1.0f, 0.0f), 100.0f);
+        EXPECT_EQ(expected, out[i]) << "Vector result differ at index " << i;
+        expected_sum += expected;
+        expected_max = std::max(expected_max, expected);
+    }
+
+    // the values are small integers and halves, so every partial sum is exact
+    EXPECT_EQ(expected_sum, p.reduce(in, simd::plus<std::float32_t>{}));
+    EXPECT_EQ(expected_max, p.reduce(in, simd::maximum<std::float32_t>{}));
+    EXPECT_EQ(-100.0f, simd::pipeline{}.reduce(in, simd::minimum<std::float32_t>{}));
+}
+
+TEST(float32_t, polyval)
+{
+    const std::size_t N = 37;
+
+    simd::vector<std::float32_t, N> x;
+    for (std::size_t i = 0; i < N; ++i) {
+        x[i] = static_cast<std::float32_t>(i) / N;
+    }
+
+    // 0.5 x^5 + 0.25 x^4 + 2 x^3 + x^2 + 3 x + 1, compile time and runtime coefficients
+    simd::vector<std::float32_t, N> const horner = simd::polyval<0.5, 0.25, 2.0, 1.0, 3.0, 1.0>(x);
+    simd::vector<std::float32_t, N> const estrin = simd::polyval(std::array{0.5f, 0.25f, 2.0f, 1.0f, 3.0f, 1.0f}, x, simd::poly_form::estrin);
+    simd::vector<std::float32_t, N> const rational = simd::ratval<simd::poly<1.0f, 2.0f>, simd::poly<1.0f, 0.0f, 4.0f>>(x);
+    for (int i = 0; i < N; ++i) {
+        std::float32_t const v = x[i];
+        std::float32_t const expected = ((((0.5f * v + 0.25f) * v + 2.0f) * v + 1.0f) * v + 3.0f) * v + 1.0f;
+        EXPECT_FLOAT_EQ(expected, horner[i]) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ(expected, estrin[i]) << "Vector result differ at index " << i;
+        EXPECT_FLOAT_EQ((v + 2.0f) / (v * v + 4.0f), rational[i]) << "Vector result differ at index " << i;
+    }
+
+    // in place over an array, with a single coefficient the polynomial is a constant
+    std::vector<std::float64_t> values(N, 2.0);
+    simd::polyval<1, -1>(values.data(), values.data(), N);
+    EXPECT_EQ(1.0, values[N - 1]);
+    simd::polyval<7>(values.data(), values.data(), N);
+    EXPECT_EQ(7.0, values[0]);
+}
+
+TEST(float32_t, ratval_partial_register)
+{
+    const std::size_t N = 37;
+
+    simd::vector<std::float32_t, N> x;
+    for (std::size_t i = 0; i < N; ++i) {
+        x[i] = static_cast<std::float32_t>(i + 2);
+    }
+
+    // 1 / (x - 1) divides by zero at 1, the lanes beyond the end of x must not evaluate it there
+    std::feclearexcept(FE_ALL_EXCEPT);
+    simd::vector<std::float32_t, N> const horner = simd::ratval<simd::poly<1.0f>, simd::poly<1.0f, -1.0f>>(x);
+    simd::vector<std::float32_t, N> const estrin = simd::ratval<simd::poly<1.0f>, simd::poly<1.0f, -1.0f>>(x, simd::poly_form::estrin);
+    EXPECT_FALSE(std::fetestexcept(FE_DIVBYZERO | FE_INVALID));
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(1.0f / (x[i] - 1.0f), horner[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(1.0f / (x[i] - 1.0f), estrin[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, fir)
+{
+    const std::size_t N = 100;
+    const std::size_t K = 16;
+
+    simd::vector<std::float32_t, N> signal;
+    std::array<std::float32_t, K> taps;
+    for (std::size_t i = 0; i < N; ++i) {
+        signal[i] = static_cast<std::float32_t>((i * 37) % 23) - 11.0f;
+    }
+    for (std::size_t k = 0; k < K; ++k) {
+        taps[k] = 1.0f / static_cast<std::float32_t>(k + 2);
+    }
+
+    simd::vector<std::float32_t, N + K - 1> const full = simd::convolve(signal, taps);
+    for (int i = 0; i < N + K - 1; ++i) {
+        std::float32_t expected = 0.0f;
+        for (int k = 0; k < K; ++k) {
+            if (i - k >= 0 && i - k < N) {
+                expected += taps[k] * signal[i - k];
+            }
+        }
+        EXPECT_NEAR(expected, full[i], 1e-4f) << "Vector result differ at index " << i;
+    }
+
+    // blocks shorter and longer than the history give the first N outputs of the full convolution
+    simd::fir<std::float32_t, K> filter(taps);
+    std::array<std::float32_t, N> streamed;
+    filter.process(&signal[0], &streamed[0], 5);
+    filter.process(&signal[5], &streamed[5], 20);
+    filter.process(&signal[25], &streamed[25], N - 25);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_FLOAT_EQ(full[i], streamed[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(float32_t, gemv)
+{
+    const std::size_t R = 75;
+    const std::size_t C = 37;
+
+    // the same matrix row major and column major
+    std::vector<std::float32_t> a(R * C);
+    std::vector<std::float32_t> at(R * C);
+    std::vector<std::float32_t> x(C);
+    std::vector<std::float32_t> xt(R);
+    for (std::size_t r = 0; r < R; ++r) {
+        for (std::size_t c = 0; c < C; ++c) {
+            a[r * C + c] = static_cast<std::float32_t>((r * 31 + c * 17) % 13) - 6.0f;
+            at[c * R + r] = a[r * C + c];
+        }
+        xt[r] = static_cast<std::float32_t>(r % 5) - 2.0f;
+    }
+    for (std::size_t c = 0; c < C; ++c) {
+        x[c] = static_cast<std::float32_t>(c % 7) * 0.5f;
+    }
+
+    std::vector<std::float32_t> y1(R), y2(R), y3(R), y4(R), t1(C), t2(C);
+    simd::gemv(a.data(), x.data(), y1.data(), R, C);
+    simd::gemv(at.data(), x.data(), y2.data(), R, C, simd::matrix_layout::column_major);
+    simd::gemv(a.data(), x.data(), y3.data(), R, C, simd::matrix_layout::row_major, 3);
+    simd::gemv(a.data(), x.data(), y4.data(), R, C, simd::matrix_layout::row_major, 0); // as hardware_concurrency may report
+    simd::gemv_transposed(a.data(), xt.data(), t1.data(), R, C);
+    simd::gemv_transposed(at.data(), xt.data(), t2.data(), R, C, simd::matrix_layout::column_major, 4);
+    for (int r = 0; r < R; ++r) {
+        std::float32_t expected = 0.0f;
+        for (int c = 0; c < C; ++c) {
+            expected += a[r * C + c] * x[c];
+        }
+        EXPECT_EQ(expected, y1[r]) << "Vector result differ at index " << r;
+        EXPECT_EQ(expected, y2[r]) << "Vector result differ at index " << r;
+        EXPECT_EQ(expected, y3[r]) << "Vector result differ at index " << r;
+        EXPECT_EQ(expected, y4[r]) << "Vector result differ at index " << r;
+    }
+    for (int c = 0; c < C; ++c) {
+        std::float32_t expected = 0.0f;
+        for (int r = 0; r < R; ++r) {
+            expected += a[r * C + c] * xt[r];
+        }
+        EXPECT_EQ(expected, t1[c]) << "Vector result differ at index " << c;
+        EXPECT_EQ(expected, t2[c]) << "Vector result differ at index " << c;
+    }
+
+    simd::vector<std::float32_t, 6> m = {1, 2, 3, 4, 5, 6};
+    simd::vector<std::float32_t, 3> v = {1, 0, -1};
+    simd::vector<std::float32_t, 2> const mv = simd::gemv<2, 3>(m, v);
+    EXPECT_EQ(-2.0f, mv[0]);
+    EXPECT_EQ(-2.0f, mv[1]);
+}
+
+TEST(float32_t, sort)
+{
+    const std::size_t N = 1000;
+
+    simd::vector<std::float32_t, N> simd_array;
+    std::mt19937 gen(N);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_array[i] = dist(gen);
+    }
+
+    std::array<std::float32_t, N> expected;
+    std::copy(simd_array.begin(), simd_array.end(), expected.begin());
+    std::sort(expected.begin(), expected.end());
+
+    simd::sort(simd_array);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(expected[i], simd_array[i]) << "Vector expected and simd_array differ at index " << i;
+    }
+}
+
+TEST(float32_t, argsort)
+{
+    const std::size_t N = 20;
+
+    simd::vector<std::float32_t, N> simd_array = {3,-1,4,-1,5,-9,2,6,5,3,5,-8,9,7,9,3,-2,3,8,-4};
+
+    std::array<std::size_t, N> expected;
+    std::iota(expected.begin(), expected.end(), std::size_t(0));
+    std::stable_sort(expected.begin(), expected.end(), [&](std::size_t a, std::size_t b) { return simd_array[a] < simd_array[b]; });
+
+    simd::vector<std::size_t, N> result = simd::argsort(simd_array);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(expected[i], result[i]) << "Vector expected and result differ at index " << i;
+    }
+}
+
+TEST(float32_t, sort_heap_vector)
+{
+    const std::size_t N = std::size_t(1) << 21;
+
+    simd::heap_vector<std::float32_t, N> simd_array;
+    std::mt19937 gen(N);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_array[i] = dist(gen);
+    }
+
+    std::vector<std::float32_t> expected(simd_array.begin(), simd_array.end());
+    std::sort(expected.begin(), expected.end());
+
+    simd::sort(simd_array);
+    for (std::size_t i = 0; i < N; ++i) {
+        ASSERT_EQ(expected[i], simd_array[i]) << "Vector expected and simd_array differ at index " << i;
+    }
+}
+
+TEST(float32_t, sort_nan)
+{
+    const std::size_t N = 37;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    simd::vector<std::float32_t, N> simd_array;
+    std::mt19937 gen(N);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_array[i] = (i % 5 == 2) ? nan : dist(gen);
+    }
+
+    std::vector<std::float32_t> expected;
+    std::copy_if(simd_array.begin(), simd_array.end(), std::back_inserter(expected), [](float x) { return !std::isnan(x); });
+    std::sort(expected.begin(), expected.end());
+
+    simd::sort(simd_array);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i], simd_array[i]) << "Vector expected and simd_array differ at index " << i;
+    }
+    for (std::size_t i = expected.size(); i < N; ++i) {
+        EXPECT_TRUE(std::isnan(simd_array[i])) << "Vector result is not NaN at index " << i;
+    }
+}
+
+TEST(float32_t, argsort_nan)
+{
+    const std::size_t N = 20;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    simd::heap_vector<std::float32_t, N> simd_array = {{3,-1,nan,-1,5,-9,2,6,-nan,3,5,-8,9,7,9,3,-2,nan,8,-4}};
+
+    std::array<std::size_t, N> expected;
+    std::iota(expected.begin(), expected.end(), std::size_t(0));
+    std::stable_sort(expected.begin(), expected.end(), [&](std::size_t a, std::size_t b) {
+        return simd_array[a] < simd_array[b] || (!std::isnan(simd_array[a]) && std::isnan(simd_array[b]));
+    });
+
+    // the indices come back in the storage policy of the keys
+    simd::heap_vector<std::size_t, N> result = simd::argsort(simd_array);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(expected[i], result[i]) << "Vector expected and result differ at index " << i;
+    }
+}
+
 //-----------------------------------------------------------------------------
 //  float64_t
 //-----------------------------------------------------------------------------
@@ -267,6 +1705,38 @@ TEST(float64_t, add)
     }
 }
 
+TEST(float64_t, complex_split)
+{
+    const std::size_t N = 11;
+
+    simd::complex_vector<std::float64_t, N> interleaved_a;
+    simd::complex_vector<std::float64_t, N> interleaved_b;
+    for (int i = 0; i < N; ++i) {
+        interleaved_a[i] = {static_cast<std::float64_t>(i - 5), static_cast<std::float64_t>(i * 2)};
+        interleaved_b[i] = {static_cast<std::float64_t>(1 + i), static_cast<std::float64_t>(3 - i)};
+    }
+
+    auto const a = simd::split(interleaved_a);
+    auto const b = simd::split(interleaved_b);
+    auto const product = a * b;
+    auto const conjugate = simd::conj(a);
+    simd::vector<std::float64_t, N> const magnitude = simd::norm(a);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(interleaved_a[i] * interleaved_b[i], product[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(std::conj(interleaved_a[i]), conjugate[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(std::norm(interleaved_a[i]), magnitude[i]) << "Vector result differ at index " << i;
+    }
+
+    EXPECT_EQ(simd::dot(interleaved_a, interleaved_b), simd::dot(a, b));
+    EXPECT_EQ(simd::vdot(interleaved_a, interleaved_b), simd::vdot(a, b));
+
+    simd::complex_vector<std::float64_t, N> const back = simd::interleave(product);
+    simd::complex_vector<std::float64_t, N> const expected = interleaved_a * interleaved_b;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(expected[i], back[i]) << "Vector result differ at index " << i;
+    }
+}
+
 TEST(float64_t, sub)
 {
     const std::size_t N = 20;
@@ -345,6 +1815,79 @@ TEST(float64_t, div)
     }
 }
 
+TEST(float64_t, sort)
+{
+    const std::size_t N = 1000;
+
+    simd::vector<std::float64_t, N> simd_array;
+    std::mt19937 gen(N);
+    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_array[i] = dist(gen);
+    }
+
+    std::array<std::float64_t, N> expected;
+    std::copy(simd_array.begin(), simd_array.end(), expected.begin());
+    std::sort(expected.begin(), expected.end());
+
+    simd::sort(simd_array);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(expected[i], simd_array[i]) << "Vector expected and simd_array differ at index " << i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//  float16_t
+//-----------------------------------------------------------------------------
+TEST(float16_t, arithmetic)
+{
+    const std::size_t N = 37;
+
+    simd::vector<std::float16_t, N> a;
+    simd::vector<std::float16_t, N> b;
+    for (int i = 0; i < N; ++i) {
+        a[i] = static_cast<std::float16_t>(i * 0.25f - 3.0f);
+        b[i] = static_cast<std::float16_t>(i % 5 + 1);
+    }
+
+    simd::vector<std::float16_t, N> const sum = a + b;
+    simd::vector<std::float16_t, N> const product = a * b;
+    simd::vector<std::float16_t, N> const quotient = a / b;
+    simd::vector<std::float16_t, N> const scaled = a * static_cast<std::float16_t>(0.1f);
+    for (int i = 0; i < N; ++i) {
+        // fp16 arithmetic is float arithmetic rounded once to fp16, whichever path computes it
+        EXPECT_EQ(static_cast<std::float16_t>(static_cast<float>(a[i]) + static_cast<float>(b[i])), sum[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(static_cast<std::float16_t>(static_cast<float>(a[i]) * static_cast<float>(b[i])), product[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(static_cast<std::float16_t>(static_cast<float>(a[i]) / static_cast<float>(b[i])), quotient[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(static_cast<std::float16_t>(static_cast<float>(a[i]) * static_cast<float>(static_cast<std::float16_t>(0.1f))), scaled[i]) << "Vector result differ at index " << i;
+    }
+}
+
+#ifdef __AVX2__
+TEST(bfloat16_t, conversion)
+{
+    // 1.0, -2.5, a value halfway between two bf16 (rounds to even), one just above halfway, inf, NaN, max, 0
+    alignas(32) std::uint32_t const floats[8] = {0x3F800000, 0xC0200000, 0x3F808000, 0x3F818001, 0x7F800000, 0x7FC00001, 0x7F7FFFFF, 0x00000000};
+    alignas(16) std::uint16_t bf16[8];
+
+    _mm_storeu_si128((__m128i*)bf16, simd::simd_cvtps_bf16(_mm256_load_ps((float const*)floats)));
+    EXPECT_EQ(0x3F80, bf16[0]);
+    EXPECT_EQ(0xC020, bf16[1]);
+    EXPECT_EQ(0x3F80, bf16[2]);
+    EXPECT_EQ(0x3F82, bf16[3]);
+    EXPECT_EQ(0x7F80, bf16[4]);
+    EXPECT_EQ(0x7FC0, bf16[5] & 0x7FC0);
+    EXPECT_EQ(0x7F80, bf16[6]);
+    EXPECT_EQ(0x0000, bf16[7]);
+
+    alignas(32) std::uint32_t widened[8];
+    _mm256_store_ps((float*)widened, simd::simd_cvtbf16_ps(_mm_load_si128((__m128i const*)bf16)));
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(std::uint32_t(bf16[i]) << 16, widened[i]) << "Vector result differ at index " << i;
+    }
+}
+#endif // __AVX2__
+
 //-----------------------------------------------------------------------------
 //  int8_t
 //-----------------------------------------------------------------------------
@@ -563,6 +2106,58 @@ TEST(uint8_t, div)
     }
 }
 
+TEST(uint8_t, find)
+{
+    const std::size_t N = 100;
+
+    simd::vector<std::uint8_t, N> simd_int_array;
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_int_array[i] = static_cast<std::uint8_t>('a' + (i % 26));
+    }
+    simd_int_array[70] = ':';
+    simd_int_array[97] = ':';
+
+    EXPECT_EQ(70, simd::find(simd_int_array, ':'));
+    EXPECT_EQ(N, simd::find(simd_int_array, '/'));
+    EXPECT_EQ(2, simd::count(simd_int_array, ':'));
+    EXPECT_EQ(4, simd::count(simd_int_array, 'a'));
+    EXPECT_TRUE(simd::contains(simd_int_array, 'z'));
+    EXPECT_FALSE(simd::contains(simd_int_array, '\n'));
+
+    // the match in the scalar tail
+    simd_int_array[70] = 'a';
+    EXPECT_EQ(97, simd::find(simd_int_array, ':'));
+}
+
+TEST(uint8_t, histogram)
+{
+    const std::size_t N = 1000;
+
+    simd::vector<std::uint8_t, N> simd_int_array;
+    std::mt19937 gen(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_int_array[i] = static_cast<std::uint8_t>(gen() % 8 ? 7 : gen());
+    }
+
+    std::array<std::uint32_t, 256> expected{};
+    for (std::size_t i = 0; i < N; ++i) {
+        expected[simd_int_array[i]]++;
+    }
+
+    // bucketed compare
+    simd::vector<std::uint32_t, 4> result1 = simd::bincount<4>(simd_int_array);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(expected[i], result1[i]) << "Vector expected and result1 differ at index " << i;
+    }
+
+    // sub-histograms, accumulating into existing counts
+    simd::vector<std::uint32_t, 256> result2 = simd::bincount<256>(simd_int_array);
+    simd::histogram(simd_int_array, result2);
+    for (int i = 0; i < 256; ++i) {
+        EXPECT_EQ(expected[i] * 2, result2[i]) << "Vector expected and result2 differ at index " << i;
+    }
+}
+
 //-----------------------------------------------------------------------------
 //  int16_t
 //-----------------------------------------------------------------------------
@@ -672,6 +2267,207 @@ TEST(int16_t, div)
     }
 }
 
+TEST(int16_t, mapped_array)
+{
+    const std::size_t Chunk = 64;
+    const std::size_t N = (Chunk * 5) + 7;
+    std::string const in_path = testing::TempDir() + "simd_mapped_in.bin";
+    std::string const out_path = testing::TempDir() + "simd_mapped_out.bin";
+
+    {
+        auto in = simd::mapped_array<std::int16_t, Chunk>::create(in_path, N);
+        std::iota(in.begin(), in.end(), std::int16_t(-100));
+    }
+
+    {
+        simd::mapped_array<std::int16_t, Chunk> const in(in_path);
+        auto out = simd::mapped_array<std::int16_t, Chunk>::create(out_path, in.size());
+        ASSERT_EQ(N, in.size());
+        ASSERT_EQ(5u, in.chunks());
+
+        for (std::size_t k = 0; k < in.chunks(); ++k) {
+            out.chunk(k) = in.chunk(k) * std::int16_t(3) + in.chunk(k);
+        }
+        for (std::size_t i = in.chunks() * Chunk; i < N; ++i) {
+            out[i] = in[i] * 3 + in[i];
+        }
+        EXPECT_EQ(std::size_t(100), simd::find(in.chunk(1), std::int16_t(0)) + Chunk);
+    }
+
+    simd::mapped_array<std::int16_t, Chunk> const out(out_path);
+    ASSERT_EQ(N, out.size());
+    ASSERT_EQ(7u, out.tail().size());
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ((i - 100) * 4, out[i]) << "Vector result differ at index " << i;
+    }
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+}
+
+TEST(uint16_t, histogram)
+{
+    const std::size_t N = 1000;
+
+    simd::vector<std::uint16_t, N> simd_int_array;
+    std::mt19937 gen(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_int_array[i] = static_cast<std::uint16_t>(gen() % 8 ? 7 : gen());
+    }
+
+    std::vector<std::uint32_t> expected(65536);
+    for (std::size_t i = 0; i < N; ++i) {
+        expected[simd_int_array[i]]++;
+    }
+
+    simd::vector<std::uint32_t, 1000> result1 = simd::bincount<1000>(simd_int_array);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(expected[i], result1[i]) << "Vector expected and result1 differ at index " << i;
+    }
+
+    // too big for sub-histograms
+    std::unique_ptr<simd::vector<std::uint32_t, 65536>> result2 = std::make_unique<simd::vector<std::uint32_t, 65536>>();
+    simd::histogram(simd_int_array, *result2);
+    for (int i = 0; i < 65536; ++i) {
+        EXPECT_EQ(expected[i], (*result2)[i]) << "Vector expected and result2 differ at index " << i;
+    }
+
+    // the counts of a heap vector come back on the heap
+    simd::heap_vector<std::uint16_t, N> heap_array;
+    std::copy(simd_int_array.begin(), simd_int_array.end(), heap_array.begin());
+    simd::heap_vector<std::uint32_t, 65536> result3 = simd::bincount<65536>(heap_array);
+    for (int i = 0; i < 65536; ++i) {
+        EXPECT_EQ(expected[i], result3[i]) << "Vector expected and result3 differ at index " << i;
+    }
+}
+
+TEST(int16_t, fir)
+{
+    const std::size_t N = 70;
+
+    // Q15 taps, the last one unpaired
+    std::array<std::int16_t, 7> const taps = {16384, -8192, 4096, 32767, -32768, 1000, -3};
+    simd::vector<std::int16_t, N> signal;
+    for (std::size_t i = 0; i < N; ++i) {
+        signal[i] = static_cast<std::int16_t>((i * 7919) % 65536 - 32768);
+    }
+
+    simd::fir<std::int16_t, 7> filter(taps);
+    simd::vector<std::int16_t, 30> const first = filter.process(simd::vector<std::int16_t, 30>{});
+    EXPECT_EQ(0, first[29]);
+    filter.reset();
+
+    std::array<std::int16_t, N> out;
+    filter.process(&signal[0], &out[0], 3);
+    filter.process(&signal[3], &out[3], N - 3);
+    for (int i = 0; i < N; ++i) {
+        std::int32_t acc = 0;
+        for (int k = 0; k < 7; ++k) {
+            acc += i - k >= 0 ? taps[k] * signal[i - k] : 0;
+        }
+        std::int16_t const expected = static_cast<std::int16_t>(std::clamp((acc + (1 << 14)) >> 15, -32768, 32767));
+        EXPECT_EQ(expected, out[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(int16_t, fir_headroom)
+{
+    const std::size_t N = 40;
+
+    // 64bit reference, rounded and saturated like the filter
+    auto const reference = [](auto const& taps, auto const& signal, int i) {
+        std::int64_t acc = 0;
+        for (int k = 0; k < static_cast<int>(taps.size()); ++k) {
+            acc += i - k >= 0 ? std::int64_t(taps[k]) * signal[i - k] : 0;
+        }
+        return static_cast<std::int16_t>(std::clamp<std::int64_t>((acc + (1 << 14)) >> 15, -32768, 32767));
+    };
+
+    simd::vector<std::int16_t, N> signal;
+    for (std::size_t i = 0; i < N; ++i) {
+        signal[i] = static_cast<std::int16_t>(i % 3 == 0 ? -32768 : ((i * 7919) % 65536 - 32768));
+    }
+
+    // a gain below 2.0 stays in the 32bit madd sums
+    std::array<std::int16_t, 5> const low = {8192, -4096, 2048, 1024, -512};
+    auto const filtered = simd::convolve(signal, low);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(reference(low, signal, i), filtered[i]) << "Vector result differ at index " << i;
+    }
+
+    // four full scale taps sum to 2^32 and more, past the int32 range
+    std::array<std::int16_t, 4> const high = {-32768, -32768, -32768, -32768};
+    simd::vector<std::int16_t, N> constant;
+    std::fill(constant.begin(), constant.end(), std::int16_t(-32768));
+    auto const saturated = simd::convolve(constant, high);
+    auto const mixed = simd::convolve(signal, high);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(reference(high, constant, i), saturated[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(reference(high, signal, i), mixed[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(int16_t, compound_assign)
+{
+    const std::size_t N = 40;
+
+    simd::vector<std::int16_t, N> simd_int_array;
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_int_array[i] = static_cast<std::int16_t>(i + 1);
+    }
+    simd::vector<std::int16_t, N> result = simd_int_array;
+    std::int16_t expected;
+
+    result *= simd_int_array;
+    result += 7;
+    result -= simd_int_array;
+    result /= 2;
+    for (int i = 0; i < N; ++i) {
+        expected = (simd_int_array[i] * simd_int_array[i] + 7 - simd_int_array[i]) / 2;
+        EXPECT_EQ(expected, result[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(int16_t, mixed_types)
+{
+    const std::size_t N = 37;
+
+    simd::vector<std::int16_t, N> raw;
+    simd::vector<std::float32_t, N> gain;
+    simd::vector<std::int8_t, N> small;
+    for (std::size_t i = 0; i < N; ++i) {
+        raw[i] = static_cast<std::int16_t>(i * 997 - 18000);
+        gain[i] = 0.25f + static_cast<std::float32_t>(i) / 8;
+        small[i] = static_cast<std::int8_t>(i * 7 - 128);
+    }
+
+    simd::vector<std::float32_t, N> scaled = raw * gain;
+    simd::vector<std::float32_t, N> halved = raw * 0.5f;
+    simd::vector<std::float64_t, N> inverse = 1.0 / raw;
+    simd::vector<std::int16_t, N> sum = small + raw;
+    simd::vector<std::int16_t, N> kept = raw + 10;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(static_cast<std::float32_t>(raw[i]) * gain[i], scaled[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(static_cast<std::float32_t>(raw[i]) * 0.5f, halved[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(1.0 / raw[i], inverse[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(static_cast<std::int16_t>(small[i] + raw[i]), sum[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(static_cast<std::int16_t>(raw[i] + 10), kept[i]) << "Vector result differ at index " << i;
+    }
+
+    simd::vector<std::uint32_t, N> counts;
+    simd::vector<std::float64_t, N> weights;
+    for (std::size_t i = 0; i < N; ++i) {
+        counts[i] = 4000000000u - static_cast<std::uint32_t>(i * 123457);
+        weights[i] = static_cast<std::float64_t>(i) - 0.5;
+    }
+    simd::vector<std::float32_t, N> fcounts = counts - gain;
+    simd::vector<std::float64_t, N> weighted = weights;
+    weighted *= counts;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(static_cast<std::float32_t>(counts[i]) - gain[i], fcounts[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(weights[i] * counts[i], weighted[i]) << "Vector result differ at index " << i;
+    }
+}
+
 //-----------------------------------------------------------------------------
 //  uint16_t
 //-----------------------------------------------------------------------------
@@ -781,6 +2577,247 @@ TEST(uint16_t, div)
     }
 }
 
+//-----------------------------------------------------------------------------
+//  int32_t
+//-----------------------------------------------------------------------------
+
+TEST(int32_t, small_vectors)
+{
+    simd::vector<std::int32_t, 8> a = {1, 2, 3, 4, 5, 6, 7, 8};
+    simd::vector<std::int32_t, 8> b = a * a - a;
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(a[i] * a[i] - a[i], b[i]) << "Vector result differ at index " << i;
+    }
+
+    simd::vector<std::int32_t, 5> c = {-1, 2, -3, 4, -5};
+    c = c + c;
+    c += 1;
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(((i % 2 ? 1 : -1) * (i + 1)) * 2 + 1, c[i]) << "Vector result differ at index " << i;
+    }
+#ifdef __AVX2__
+    // five lanes of a masked 256bit register, narrower builds use a whole 128bit register and a scalar lane
+    using vreg = simd::vector<std::int32_t, 5>::vreg;
+    simd::vector<std::int32_t, 5> const d = simd::vector<std::int32_t, 5>::from_register(simd::set<std::int32_t, vreg>(9));
+    EXPECT_EQ(9, d[4]);
+#endif // __AVX2__
+
+    // no register division for int32, these take the scalar path
+    simd::vector<std::int32_t, 8> const e = b / a;
+    simd::vector<std::int32_t, 5> const f = c / 3;
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(b[i] / a[i], e[i]) << "Vector result differ at index " << i;
+    }
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(c[i] / 3, f[i]) << "Vector result differ at index " << i;
+    }
+}
+
+TEST(int32_t, sort)
+{
+    const std::size_t N = 1000;
+
+    simd::vector<std::int32_t, N> simd_array;
+    std::mt19937 gen(N);
+    std::uniform_int_distribution<std::int32_t> dist(-100000, 100000);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_array[i] = dist(gen);
+    }
+
+    std::array<std::int32_t, N> expected;
+    std::copy(simd_array.begin(), simd_array.end(), expected.begin());
+    std::sort(expected.begin(), expected.end());
+
+    simd::sort(simd_array);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(expected[i], simd_array[i]) << "Vector expected and simd_array differ at index " << i;
+    }
+}
+
+TEST(int32_t, argsort)
+{
+    const std::size_t N = 100;
+
+    simd::vector<std::int32_t, N> simd_array;
+    std::mt19937 gen(N);
+    std::uniform_int_distribution<std::int32_t> dist(-10, 10);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_array[i] = dist(gen);
+    }
+
+    std::array<std::size_t, N> expected;
+    std::iota(expected.begin(), expected.end(), std::size_t(0));
+    std::stable_sort(expected.begin(), expected.end(), [&](std::size_t a, std::size_t b) { return simd_array[a] < simd_array[b]; });
+
+    simd::vector<std::size_t, N> result = simd::argsort(simd_array);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(expected[i], result[i]) << "Vector expected and result differ at index " << i;
+    }
+}
+
+TEST(int32_t, find_if)
+{
+    const std::size_t N = 50;
+
+    simd::vector<std::int32_t, N> simd_int_array;
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_int_array[i] = static_cast<std::int32_t>(i) - 25;
+    }
+
+    EXPECT_EQ(0, simd::find_if(simd_int_array, simd::less<std::int32_t>{-20}));
+    EXPECT_EQ(46, simd::find_if(simd_int_array, simd::greater<std::int32_t>{20}));
+    EXPECT_EQ(N, simd::find_if(simd_int_array, simd::greater<std::int32_t>{100}));
+    EXPECT_EQ(1, simd::find_if(simd_int_array, simd::not_equal_to<std::int32_t>{-25}));
+    EXPECT_EQ(29, simd::count_if(simd_int_array, simd::greater<std::int32_t>{-5}));
+    EXPECT_EQ(25, simd::count_if(simd_int_array, simd::less<std::int32_t>{0}));
+}
+
+TEST(int32_t, mismatch)
+{
+    const std::size_t N = 50;
+
+    simd::vector<std::int32_t, N> a;
+    simd::vector<std::int32_t, N> b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = b[i] = static_cast<std::int32_t>(i * 3);
+    }
+
+    EXPECT_EQ(N, simd::mismatch(a, b));
+
+    b[48] = -1;
+    EXPECT_EQ(48, simd::mismatch(a, b));
+
+    b[9] = -1;
+    EXPECT_EQ(9, simd::mismatch(a, b));
+}
+
+TEST(int32_t, mixed_div)
+{
+    const std::size_t N = 16;
+
+    // int32 has no register division, the mixed operators fall back to the scalar loop like vector's own
+    simd::vector<std::int32_t, N> a;
+    simd::vector<std::int16_t, N> b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = static_cast<std::int32_t>(i * 100003) - 700000;
+        b[i] = static_cast<std::int16_t>(i * 37 - 300);
+    }
+
+    simd::vector<std::int32_t, N> quotient = a / b;
+    simd::vector<std::int32_t, N> inplace = a;
+    inplace /= b;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(a[i] / b[i], quotient[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(a[i] / b[i], inplace[i]) << "Vector result differ at index " << i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//  int64_t
+//-----------------------------------------------------------------------------
+
+TEST(int64_t, sort)
+{
+    const std::size_t N = 1000;
+
+    simd::vector<std::int64_t, N> simd_array;
+    std::mt19937_64 gen(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        simd_array[i] = static_cast<std::int64_t>(gen());
+    }
+
+    std::array<std::int64_t, N> expected;
+    std::copy(simd_array.begin(), simd_array.end(), expected.begin());
+    std::sort(expected.begin(), expected.end());
+
+    simd::sort(simd_array);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(expected[i], simd_array[i]) << "Vector expected and simd_array differ at index " << i;
+    }
+}
+
+TEST(int64_t, small_vectors)
+{
+    // division, and multiplication without AVX512DQ, have no register form for 64bit lanes and stay scalar
+    simd::vector<std::int64_t, 4> a = {-7, 100, 3000000000, -9};
+    simd::vector<std::int64_t, 4> const b = {2, -3, 7, 4};
+    simd::vector<std::int64_t, 4> const c = a / b;
+    simd::vector<std::int64_t, 3> const d = simd::vector<std::int64_t, 3>{10, -20, 30} / 4;
+    simd::vector<std::int64_t, 4> const e = a * b;
+    a /= b;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(c[i], a[i]) << "Vector result differ at index " << i;
+    }
+    std::array<std::int64_t, 4> const quotient = {-3, -33, 428571428, -2};
+    std::array<std::int64_t, 4> const product = {-14, -300, 21000000000, -36};
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(quotient[i], c[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(product[i], e[i]) << "Vector result differ at index " << i;
+    }
+    EXPECT_EQ(2, d[0]);
+    EXPECT_EQ(-5, d[1]);
+    EXPECT_EQ(7, d[2]);
+}
+
+TEST(int64_t, mixed_mul)
+{
+    const std::size_t N = 19;
+
+    // int64 multiplication needs AVX512DQ and VL, elsewhere the mixed operators take the scalar loop
+    simd::vector<std::int64_t, N> a;
+    simd::vector<std::int32_t, N> b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = static_cast<std::int64_t>(i * 1000000007) - 9000000000;
+        b[i] = static_cast<std::int32_t>(i * 37) - 300;
+    }
+
+    simd::vector<std::int64_t, N> product = a * b;
+    simd::vector<std::int64_t, N> inplace = a;
+    inplace *= b;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(a[i] * b[i], product[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(a[i] * b[i], inplace[i]) << "Vector result differ at index " << i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//  uint64_t
+//-----------------------------------------------------------------------------
+
+TEST(uint64_t, small_vectors)
+{
+    simd::vector<std::uint64_t, 4> const a = {7, 100, 3000000000, 1ull << 40};
+    simd::vector<std::uint64_t, 4> const b = {2, 3, 7, 1ull << 30};
+    simd::vector<std::uint64_t, 4> const c = a * b;
+    simd::vector<std::uint64_t, 4> const d = a / b;
+    simd::vector<std::uint64_t, 2> e = {9, 12};
+    e *= 5;
+    e /= simd::vector<std::uint64_t, 2>{3, 4};
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(a[i] * b[i], c[i]) << "Vector result differ at index " << i;
+        EXPECT_EQ(a[i] / b[i], d[i]) << "Vector result differ at index " << i;
+    }
+    EXPECT_EQ(15u, e[0]);
+    EXPECT_EQ(15u, e[1]);
+}
+
+TEST(uint64_t, mixed_mul)
+{
+    const std::size_t N = 19;
+
+    simd::vector<std::uint64_t, N> a;
+    simd::vector<std::uint32_t, N> b;
+    for (std::size_t i = 0; i < N; ++i) {
+        a[i] = (std::uint64_t(1) << 40) + i * 1000000007;
+        b[i] = 4000000000u - static_cast<std::uint32_t>(i * 123457);
+    }
+
+    simd::vector<std::uint64_t, N> product = a * b;
+    for (int i = 0; i < N; ++i) {
+        EXPECT_EQ(a[i] * b[i], product[i]) << "Vector result differ at index " << i;
+    }
+}
+
 int main(int argc, char* argv[])
 {
     print_supported_intructions();
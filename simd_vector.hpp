@@ -2,71 +2,155 @@
  *  SIMD (single instruction multiple data) header library
  *
  *  Staticically allocated array type that supports vectorised operations using intrinsics.
+ *
+ *  The operators are constexpr: during constant evaluation they skip the simd loops and the scalar tail loop
+ *  computes every element, so tables built from vector arithmetic can be baked in at compile time.
  */
 #pragma once
 
 #include <array>
 #include <cstddef>
 #include <concepts>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 #include <immintrin.h>
 
 #include "simd_intrinsics_wrappers.hpp"
+#include "simd_loop.hpp"
 
 namespace simd {
+#ifdef __AVX2__
+    constexpr std::size_t native_register_bytes = 32;
+#else
+    constexpr std::size_t native_register_bytes = 16;
+#endif // __AVX2__
+
+    template<typename T, std::size_t Bytes>
+    using register_of_width = std::conditional_t<Bytes == 16,
+                              std::conditional_t<std::is_integral_v<T> || is_fixed_v<T>, __m128i, std::conditional_t<sizeof(T) == 4, __m128, __m128d>>,
+                              std::conditional_t<std::is_integral_v<T> || is_fixed_v<T>, __m256i, std::conditional_t<sizeof(T) == 4, __m256, __m256d>>>;
+
+    template<typename T>
+    using native_register = register_of_width<T, native_register_bytes>;
+
+    // 16bit floats use fp16 registers with AVX512FP16, otherwise they are computed in float registers of 8 lanes
+#ifdef __AVX512FP16__
+    template<typename T, std::size_t N>
+    using half_register_for = std::conditional_t<is_float16_v<T>, std::conditional_t<(N * sizeof(T)) <= 16, __m128h, __m256h>,
+                              std::conditional_t<native_register_bytes == 32, __m256, __m128>>;
+#else
+    template<typename T, std::size_t N>
+    using half_register_for = std::conditional_t<native_register_bytes == 32, __m256, __m128>;
+#endif // __AVX512FP16__
+
+    // vectors that fit 128bit use it rather than leaving half of a 256bit register empty
+    template<typename T, std::size_t N>
+    using register_for = std::conditional_t<is_half_v<T>, half_register_for<T, N>,
+                         register_of_width<T, (N * sizeof(T)) <= 16 ? 16 : native_register_bytes>>;
+
+    // the storage policy Cont holding N elements of U instead, so a result of another element type lives where its
+    // operand does. Inline arrays rebind to an inline array, simd_storage.hpp adds its buffers
+    template<typename Cont, typename U, std::size_t N>
+    struct rebind_storage { using type = U[N ? N : 1]; };
+
+    template<typename Cont, typename U, std::size_t N>
+    using rebind_storage_t = typename rebind_storage<Cont, U, N>::type;
+
     template <typename T, std::size_t N, typename Cont = T[N ? N : 1]>
-    requires ( std::is_arithmetic<T>::value == true )
+    requires ( std::is_arithmetic<T>::value == true || is_half_v<T> || is_fixed_v<T> )
     class vector {
     public:
         alignas(64) Cont data;
 
-    #ifdef __AVX2__
-        using vreg = std::conditional_t<std::is_integral_v<T>, __m256i,
-                     std::conditional_t<std::is_same_v<T, std::float32_t>, __m256, __m256d>>;
-    #else
-        using vreg = std::conditional_t<std::is_integral_v<T>, __m128i,
-                     std::conditional_t<std::is_same_v<T, std::float32_t>, __m128, __m128d>>;
-    #endif // __AVX2__
+        using value_type = T;
+        using vreg = register_for<T, N>;
+
+        // 16bit floats in float registers are widened on load and rounded back on store
+        static constexpr bool widened = is_half_v<T> && (std::is_same_v<vreg, __m256> || std::is_same_v<vreg, __m128>);
+
+        // small vectors fit a single (possibly masked) register, without masked moves they need a whole register
+        static constexpr bool vectorised = widened ? (has_widen<T> && (sizeof(vreg) / sizeof(float)) <= N)
+                                                   : ((sizeof(vreg) / sizeof(T)) <= N || has_partial<T, vreg>);
+
+        // integer multiplication and division have no register form for some element types
+        static constexpr bool vectorised_mul = vectorised && has_vector_mul<T>;
+        static constexpr bool vectorised_div = vectorised && has_vector_div<T>;
+
+        // moving hands over the buffer rather than copying the elements, only then do the rvalue operators reuse a
+        // dying operand as the result - for an inline array that would add a copy to the return slot
+        static constexpr bool moves_storage = !std::is_array_v<Cont>;
 
         using iterator = T*;
         using const_iterator = T const*;
 
-        inline iterator begin() noexcept { return data; }
-        inline const_iterator cbegin() const noexcept { return data; }
-        inline iterator end() noexcept { return data + N; }
-        inline const_iterator cend() const noexcept { data + N; }
+        static constexpr std::size_t size() noexcept { return N; }
+
+        constexpr iterator begin() noexcept { return data; }
+        constexpr const_iterator cbegin() const noexcept { return data; }
+        constexpr iterator end() noexcept { return data + N; }
+        constexpr const_iterator cend() const noexcept { return data + N; }
+
+        // the whole vector in one register, so a chain of wrapper calls on small vectors stays out of memory
+        vreg to_register() const requires (!widened && (sizeof(vreg) / sizeof(T)) == N)
+        {
+            return load<vreg>(&data[0]);
+        }
+
+        vreg to_register() const requires (!widened && (sizeof(vreg) / sizeof(T)) > N && has_partial<T, vreg>)
+        {
+            return load_partial<T, vreg>(&data[0], N);
+        }
 
-        T& operator[](std::size_t index) {
+        static vector from_register(vreg const a) requires (!widened && (sizeof(vreg) / sizeof(T)) == N)
+        {
+            vector result;
+            store<vreg>(&result.data[0], a);
+            return result;
+        }
+
+        static vector from_register(vreg const a) requires (!widened && (sizeof(vreg) / sizeof(T)) > N && has_partial<T, vreg>)
+        {
+            vector result;
+            store_partial<T, vreg>(&result.data[0], a, N);
+            return result;
+        }
+
+        constexpr T& operator[](std::size_t index) {
             return data[index];
         }
 
-        const T& operator[](std::size_t index) const {
+        constexpr const T& operator[](std::size_t index) const {
             return data[index];
         }
 
-        vector<T, N> operator+(vector const& other)
+        constexpr vector operator+(vector const& other) const&
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
             {
                 result[i] = data[i] + other.data[i];
             }
-
             return result;
         }
 
-        vector<T, N> operator+(T const& s)
+        constexpr vector operator+(T const& s) const&
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop_scalar<vreg>(i, s, data, result.data, [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, data, result.data, [](vreg a, vreg b){ return add<T, vreg>(b, a); });
+                }
             }
 
             for (; i < N; i++)
@@ -76,13 +160,15 @@ namespace simd {
             return result;
         }
 
-        friend vector<T, N> operator+(T const& s, vector const& other)
+        friend constexpr vector operator+(T const& s, vector const& other)
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop_scalar<vreg>(i, s, other.data, result.data, [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, other.data, result.data, [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
@@ -92,13 +178,101 @@ namespace simd {
             return result;
         }
 
-        vector<T, N> operator-(vector const& other)
+        constexpr vector& operator+=(vector const& other)
         {
-            vector<T, N> result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, data, [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                data[i] += other.data[i];
+            }
+            return *this;
+        }
+
+        constexpr vector& operator+=(T const& s)
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, data, data, [](vreg a, vreg b){ return add<T, vreg>(b, a); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                data[i] += s;
+            }
+            return *this;
+        }
+
+        constexpr vector operator+(vector const& other) && requires moves_storage
+        {
+            *this += other;
+            return std::move(*this);
+        }
+
+        constexpr vector operator+(vector&& other) && requires moves_storage
+        {
+            *this += other;
+            return std::move(*this);
+        }
+
+        constexpr vector operator+(T const& s) && requires moves_storage
+        {
+            *this += s;
+            return std::move(*this);
+        }
+
+        friend constexpr vector operator+(vector const& other, vector&& dying) requires moves_storage
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop<vreg>(i, other.data, dying.data, dying.data, [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                dying[i] = other.data[i] + dying.data[i];
+            }
+            return std::move(dying);
+        }
+
+        friend constexpr vector operator+(T const& s, vector&& dying) requires moves_storage
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, dying.data, dying.data, [](vreg a, vreg b){ return add<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                dying[i] = s + dying.data[i];
+            }
+            return std::move(dying);
+        }
+
+        constexpr vector operator-(vector const& other) const&
+        {
+            vector result;
+            std::size_t i = 0;
+
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
@@ -108,13 +282,15 @@ namespace simd {
             return result;
         }
 
-        vector<T, N> operator-(T const& s)
+        constexpr vector operator-(T const& s) const&
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop_scalar<vreg>(i, s, data, result.data, [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, data, result.data, [](vreg a, vreg b){ return sub<T, vreg>(b, a); });
+                }
             }
 
             for (; i < N; i++)
@@ -124,13 +300,15 @@ namespace simd {
             return result;
         }
 
-        friend vector<T, N> operator-(T const& s, vector const& other)
+        friend constexpr vector operator-(T const& s, vector const& other)
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop_scalar<vreg>(i, s, other.data, result.data, [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, other.data, result.data, [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
@@ -140,13 +318,101 @@ namespace simd {
             return result;
         }
 
-        vector<T, N> operator*(vector const& other)
+        constexpr vector& operator-=(vector const& other)
         {
-            vector<T, N> result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return mul<T, vreg>(a, b); });
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, data, [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                data[i] -= other.data[i];
+            }
+            return *this;
+        }
+
+        constexpr vector& operator-=(T const& s)
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, data, data, [](vreg a, vreg b){ return sub<T, vreg>(b, a); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                data[i] -= s;
+            }
+            return *this;
+        }
+
+        constexpr vector operator-(vector const& other) && requires moves_storage
+        {
+            *this -= other;
+            return std::move(*this);
+        }
+
+        constexpr vector operator-(vector&& other) && requires moves_storage
+        {
+            *this -= other;
+            return std::move(*this);
+        }
+
+        constexpr vector operator-(T const& s) && requires moves_storage
+        {
+            *this -= s;
+            return std::move(*this);
+        }
+
+        friend constexpr vector operator-(vector const& other, vector&& dying) requires moves_storage
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop<vreg>(i, other.data, dying.data, dying.data, [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                dying[i] = other.data[i] - dying.data[i];
+            }
+            return std::move(dying);
+        }
+
+        friend constexpr vector operator-(T const& s, vector&& dying) requires moves_storage
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, dying.data, dying.data, [](vreg a, vreg b){ return sub<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                dying[i] = s - dying.data[i];
+            }
+            return std::move(dying);
+        }
+
+        constexpr vector operator*(vector const& other) const&
+        {
+            vector result;
+            std::size_t i = 0;
+
+            if constexpr (vectorised_mul) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return mul<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
@@ -156,13 +422,15 @@ namespace simd {
             return result;
         }
 
-        vector<T, N> operator*(T const& s)
+        constexpr vector operator*(T const& s) const&
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop_scalar<vreg>(i, s, data, result.data, [](vreg a, vreg b){ return mul<T, vreg>(a, b); });
+            if constexpr (vectorised_mul) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, data, result.data, [](vreg a, vreg b){ return mul<T, vreg>(b, a); });
+                }
             }
 
             for (; i < N; i++)
@@ -172,13 +440,15 @@ namespace simd {
             return result;
         }
 
-        friend vector<T, N> operator*(T const& s, vector const& other)
+        friend constexpr vector operator*(T const& s, vector const& other)
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop_scalar<vreg>(i, s, other.data, result.data, [](vreg a, vreg b){ return mul<T, vreg>(a, b); });
+            if constexpr (vectorised_mul) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, other.data, result.data, [](vreg a, vreg b){ return mul<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
@@ -188,13 +458,101 @@ namespace simd {
             return result;
         }
 
-        vector<T, N> operator/(vector const& other)
+        constexpr vector& operator*=(vector const& other)
         {
-            vector<T, N> result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return div<T, vreg>(a, b); });
+            if constexpr (vectorised_mul) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, data, [](vreg a, vreg b){ return mul<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                data[i] *= other.data[i];
+            }
+            return *this;
+        }
+
+        constexpr vector& operator*=(T const& s)
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised_mul) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, data, data, [](vreg a, vreg b){ return mul<T, vreg>(b, a); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                data[i] *= s;
+            }
+            return *this;
+        }
+
+        constexpr vector operator*(vector const& other) && requires moves_storage
+        {
+            *this *= other;
+            return std::move(*this);
+        }
+
+        constexpr vector operator*(vector&& other) && requires moves_storage
+        {
+            *this *= other;
+            return std::move(*this);
+        }
+
+        constexpr vector operator*(T const& s) && requires moves_storage
+        {
+            *this *= s;
+            return std::move(*this);
+        }
+
+        friend constexpr vector operator*(vector const& other, vector&& dying) requires moves_storage
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised_mul) {
+                if !consteval {
+                    simd_loop<vreg>(i, other.data, dying.data, dying.data, [](vreg a, vreg b){ return mul<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                dying[i] = other.data[i] * dying.data[i];
+            }
+            return std::move(dying);
+        }
+
+        friend constexpr vector operator*(T const& s, vector&& dying) requires moves_storage
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised_mul) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, dying.data, dying.data, [](vreg a, vreg b){ return mul<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                dying[i] = s * dying.data[i];
+            }
+            return std::move(dying);
+        }
+
+        constexpr vector operator/(vector const& other) const&
+        {
+            vector result;
+            std::size_t i = 0;
+
+            if constexpr (vectorised_div) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return div<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
@@ -204,13 +562,15 @@ namespace simd {
             return result;
         }
 
-        vector<T, N> operator/(T const& s)
+        constexpr vector operator/(T const& s) const&
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop_scalar<vreg>(i, s, data, result.data, [](vreg a, vreg b){ return div<T, vreg>(a, b); });
+            if constexpr (vectorised_div) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, data, result.data, [](vreg a, vreg b){ return div<T, vreg>(b, a); });
+                }
             }
 
             for (; i < N; i++)
@@ -220,13 +580,15 @@ namespace simd {
             return result;
         }
 
-        friend vector<T, N> operator/(T const& s, vector const& other)
+        friend constexpr vector operator/(T const& s, vector const& other)
         {
-            vector<T, N> result;
+            vector result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop_scalar<vreg>(i, s, other.data, result.data, [](vreg a, vreg b){ return div<T, vreg>(a, b); });
+            if constexpr (vectorised_div) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, other.data, result.data, [](vreg a, vreg b){ return div<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
@@ -236,13 +598,101 @@ namespace simd {
             return result;
         }
 
-        vector<T, N> operator==(vector const& other)
+        constexpr vector& operator/=(vector const& other)
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised_div) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, data, [](vreg a, vreg b){ return div<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                data[i] /= other.data[i];
+            }
+            return *this;
+        }
+
+        constexpr vector& operator/=(T const& s)
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised_div) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, data, data, [](vreg a, vreg b){ return div<T, vreg>(b, a); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                data[i] /= s;
+            }
+            return *this;
+        }
+
+        constexpr vector operator/(vector const& other) && requires moves_storage
+        {
+            *this /= other;
+            return std::move(*this);
+        }
+
+        constexpr vector operator/(vector&& other) && requires moves_storage
+        {
+            *this /= other;
+            return std::move(*this);
+        }
+
+        constexpr vector operator/(T const& s) && requires moves_storage
+        {
+            *this /= s;
+            return std::move(*this);
+        }
+
+        friend constexpr vector operator/(vector const& other, vector&& dying) requires moves_storage
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised_div) {
+                if !consteval {
+                    simd_loop<vreg>(i, other.data, dying.data, dying.data, [](vreg a, vreg b){ return div<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                dying[i] = other.data[i] / dying.data[i];
+            }
+            return std::move(dying);
+        }
+
+        friend constexpr vector operator/(T const& s, vector&& dying) requires moves_storage
+        {
+            std::size_t i = 0;
+
+            if constexpr (vectorised_div) {
+                if !consteval {
+                    simd_loop_scalar<vreg>(i, s, dying.data, dying.data, [](vreg a, vreg b){ return div<T, vreg>(a, b); });
+                }
+            }
+
+            for (; i < N; i++)
+            {
+                dying[i] = s / dying.data[i];
+            }
+            return std::move(dying);
+        }
+
+        constexpr vector<T, N> operator==(vector const& other)
         {
             vector<T, N> result;
             std::size_t i = 0;
 
-            if constexpr ( (sizeof(vreg) / sizeof(T)) < N ) {
-                simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return cmpeq<T, vreg>(a, b); });
+            if constexpr (vectorised) {
+                if !consteval {
+                    simd_loop<vreg>(i, data, other.data, result.data, [](vreg a, vreg b){ return cmpeq<T, vreg>(a, b); });
+                }
             }
 
             for (; i < N; i++)
@@ -256,35 +706,236 @@ namespace simd {
         template<typename V>
         static void simd_loop(std::size_t &i, T const a[N], T const b[N], T c[N], auto lamba_op)
         {
-            const std::size_t VN = sizeof(V)/sizeof(T);
-            if constexpr (N >= VN) {
-                V va1, va2;
-                V vb1, vb2;
-                for (; i < N - (VN * 4); i += (VN * 4)) {
-                    va1 = load<V>(&a[i]);
-                    va2 = load<V>(&a[i+VN]);
-                    vb1 = load<V>(&b[i]);
-                    vb2 = load<V>(&b[i+VN]);
-                    store<V>(&c[i], lamba_op(va1, vb1));
-                    store<V>(&c[i+VN], lamba_op(va2, vb2));
-                }
-            }
+            policy_loop<T, V>(i, N, a, b, c, lamba_op);
         }
 
         template<typename V>
         static void simd_loop_scalar(std::size_t &i, T const a, T const b[N], T c[N], auto lamba_op)
         {
-            const std::size_t VN = sizeof(V)/sizeof(T);
-            if constexpr (N >= VN) {
-                V va = set<T, V>(a);
-                V vb1, vb2;
-                for (; i < N - (VN * 2); i += (VN * 2)) {
-                    vb1 = load<V>(&b[i]);
-                    vb2 = load<V>(&b[i+VN]);
-                    store<V>(&c[i], lamba_op(va, vb1));
-                    store<V>(&c[i+VN], lamba_op(va, vb2));
-                }
-            }
+            policy_loop_scalar<T, V>(i, N, a, b, c, lamba_op);
         }
     };
+
+//-----------------------------------------------------------------------------
+//  mixed element types
+//-----------------------------------------------------------------------------
+    template<typename V>
+    struct is_vector : std::false_type {};
+
+    template<typename T, std::size_t N, typename Cont>
+    struct is_vector<vector<T, N, Cont>> : std::true_type {};
+
+    template<typename V>
+    constexpr bool is_vector_v = is_vector<std::remove_cvref_t<V>>::value;
+
+    // the usual arithmetic conversions without the promotion of small integers to int: floating point wins over
+    // integers, the wider type wins, and of two integers of the same width the unsigned one
+    template<typename A, typename B>
+    using promoted_t = std::conditional_t<std::is_floating_point_v<A> || std::is_floating_point_v<B>, std::common_type_t<A, B>,
+                       std::conditional_t<(sizeof(A) != sizeof(B)), std::conditional_t<(sizeof(A) > sizeof(B)), A, B>,
+                       std::conditional_t<std::is_unsigned_v<A>, A, B>>>;
+
+    template<typename A, typename B>
+    concept mixable = !std::is_same_v<A, B> && std::is_arithmetic_v<A> && std::is_arithmetic_v<B>
+                      && !std::is_same_v<A, bool> && !std::is_same_v<B, bool>;
+
+    // a floating point scalar promotes an integer vector, any other scalar converts to the element type as before,
+    // so integer literals keep int8 and int16 vectors at their width and double literals keep float vectors float
+    template<typename V, typename S>
+    concept promotes_scalar = is_vector_v<V> && std::is_floating_point_v<S>
+                              && std::is_integral_v<typename std::remove_cvref_t<V>::value_type>;
+
+    template<typename V, typename S>
+    using promoted_vector_t = vector<promoted_t<typename std::remove_cvref_t<V>::value_type, S>, std::remove_cvref_t<V>::size()>;
+
+    // c = op(a, b) in the promoted type T, converting each register of a and b while it is loaded. Vectorised is
+    // has_vector_mul/has_vector_div for the operators that lack a register form for some T, as in vector itself
+    template<typename T, std::size_t N, bool Vectorised = true, typename A, typename B>
+    constexpr void mixed_loop(A const* a, B const* b, T* c, auto register_op, auto op)
+    {
+        std::size_t i = 0;
+
+        if constexpr (Vectorised && has_convert<A, T> && has_convert<B, T>) {
+            if !consteval {
+                converting_loop<T, native_register<T>>(i, N, a, b, c, register_op);
+            }
+        }
+
+        for (; i < N; i++)
+        {
+            c[i] = op(static_cast<T>(a[i]), static_cast<T>(b[i]));
+        }
+    }
+
+    // c = op(s, b), s is already of the promoted type
+    template<typename T, std::size_t N, bool Vectorised = true, typename B>
+    constexpr void mixed_loop_scalar(T const s, B const* b, T* c, auto register_op, auto op)
+    {
+        std::size_t i = 0;
+
+        if constexpr (Vectorised && has_convert<B, T>) {
+            if !consteval {
+                converting_loop_scalar<T, native_register<T>>(i, N, set<T, native_register<T>>(s), b, c, register_op);
+            }
+        }
+
+        for (; i < N; i++)
+        {
+            c[i] = op(s, static_cast<T>(b[i]));
+        }
+    }
+
+    template<typename A, typename B, std::size_t N, typename ContA, typename ContB>
+    requires (mixable<A, B>)
+    constexpr vector<promoted_t<A, B>, N> operator+(vector<A, N, ContA> const& a, vector<B, N, ContB> const& b)
+    {
+        using T = promoted_t<A, B>;
+        vector<T, N> result;
+        mixed_loop<T, N>(&a[0], &b[0], &result[0], [](auto x, auto y){ return add<T, decltype(x)>(x, y); }, [](T x, T y){ return x + y; });
+        return result;
+    }
+
+    template<typename A, typename B, std::size_t N, typename ContA, typename ContB>
+    requires (mixable<A, B>)
+    constexpr vector<promoted_t<A, B>, N> operator-(vector<A, N, ContA> const& a, vector<B, N, ContB> const& b)
+    {
+        using T = promoted_t<A, B>;
+        vector<T, N> result;
+        mixed_loop<T, N>(&a[0], &b[0], &result[0], [](auto x, auto y){ return sub<T, decltype(x)>(x, y); }, [](T x, T y){ return x - y; });
+        return result;
+    }
+
+    template<typename A, typename B, std::size_t N, typename ContA, typename ContB>
+    requires (mixable<A, B>)
+    constexpr vector<promoted_t<A, B>, N> operator*(vector<A, N, ContA> const& a, vector<B, N, ContB> const& b)
+    {
+        using T = promoted_t<A, B>;
+        vector<T, N> result;
+        mixed_loop<T, N, has_vector_mul<T>>(&a[0], &b[0], &result[0], [](auto x, auto y){ return mul<T, decltype(x)>(x, y); }, [](T x, T y){ return x * y; });
+        return result;
+    }
+
+    template<typename A, typename B, std::size_t N, typename ContA, typename ContB>
+    requires (mixable<A, B>)
+    constexpr vector<promoted_t<A, B>, N> operator/(vector<A, N, ContA> const& a, vector<B, N, ContB> const& b)
+    {
+        using T = promoted_t<A, B>;
+        vector<T, N> result;
+        mixed_loop<T, N, has_vector_div<T>>(&a[0], &b[0], &result[0], [](auto x, auto y){ return div<T, decltype(x)>(x, y); }, [](T x, T y){ return x / y; });
+        return result;
+    }
+
+    // the wider operand on the left is updated in place
+    template<typename A, typename B, std::size_t N, typename ContA, typename ContB>
+    requires (mixable<A, B> && std::is_same_v<promoted_t<A, B>, A>)
+    constexpr vector<A, N, ContA>& operator+=(vector<A, N, ContA>& a, vector<B, N, ContB> const& b)
+    {
+        mixed_loop<A, N>(&a[0], &b[0], &a[0], [](auto x, auto y){ return add<A, decltype(x)>(x, y); }, [](A x, A y){ return x + y; });
+        return a;
+    }
+
+    template<typename A, typename B, std::size_t N, typename ContA, typename ContB>
+    requires (mixable<A, B> && std::is_same_v<promoted_t<A, B>, A>)
+    constexpr vector<A, N, ContA>& operator-=(vector<A, N, ContA>& a, vector<B, N, ContB> const& b)
+    {
+        mixed_loop<A, N>(&a[0], &b[0], &a[0], [](auto x, auto y){ return sub<A, decltype(x)>(x, y); }, [](A x, A y){ return x - y; });
+        return a;
+    }
+
+    template<typename A, typename B, std::size_t N, typename ContA, typename ContB>
+    requires (mixable<A, B> && std::is_same_v<promoted_t<A, B>, A>)
+    constexpr vector<A, N, ContA>& operator*=(vector<A, N, ContA>& a, vector<B, N, ContB> const& b)
+    {
+        mixed_loop<A, N, has_vector_mul<A>>(&a[0], &b[0], &a[0], [](auto x, auto y){ return mul<A, decltype(x)>(x, y); }, [](A x, A y){ return x * y; });
+        return a;
+    }
+
+    template<typename A, typename B, std::size_t N, typename ContA, typename ContB>
+    requires (mixable<A, B> && std::is_same_v<promoted_t<A, B>, A>)
+    constexpr vector<A, N, ContA>& operator/=(vector<A, N, ContA>& a, vector<B, N, ContB> const& b)
+    {
+        mixed_loop<A, N, has_vector_div<A>>(&a[0], &b[0], &a[0], [](auto x, auto y){ return div<A, decltype(x)>(x, y); }, [](A x, A y){ return x / y; });
+        return a;
+    }
+
+    // the vector is taken by forwarding reference so these beat the element type scalar members for rvalues too
+    template<typename V, typename S>
+    requires (promotes_scalar<V, S>)
+    constexpr promoted_vector_t<V, S> operator+(V&& a, S const s)
+    {
+        using T = typename promoted_vector_t<V, S>::value_type;
+        promoted_vector_t<V, S> result;
+        mixed_loop_scalar<T, promoted_vector_t<V, S>::size()>(T(s), &a[0], &result[0], [](auto x, auto y){ return add<T, decltype(x)>(y, x); }, [](T x, T y){ return y + x; });
+        return result;
+    }
+
+    template<typename V, typename S>
+    requires (promotes_scalar<V, S>)
+    constexpr promoted_vector_t<V, S> operator+(S const s, V&& a)
+    {
+        using T = typename promoted_vector_t<V, S>::value_type;
+        promoted_vector_t<V, S> result;
+        mixed_loop_scalar<T, promoted_vector_t<V, S>::size()>(T(s), &a[0], &result[0], [](auto x, auto y){ return add<T, decltype(x)>(x, y); }, [](T x, T y){ return x + y; });
+        return result;
+    }
+
+    template<typename V, typename S>
+    requires (promotes_scalar<V, S>)
+    constexpr promoted_vector_t<V, S> operator-(V&& a, S const s)
+    {
+        using T = typename promoted_vector_t<V, S>::value_type;
+        promoted_vector_t<V, S> result;
+        mixed_loop_scalar<T, promoted_vector_t<V, S>::size()>(T(s), &a[0], &result[0], [](auto x, auto y){ return sub<T, decltype(x)>(y, x); }, [](T x, T y){ return y - x; });
+        return result;
+    }
+
+    template<typename V, typename S>
+    requires (promotes_scalar<V, S>)
+    constexpr promoted_vector_t<V, S> operator-(S const s, V&& a)
+    {
+        using T = typename promoted_vector_t<V, S>::value_type;
+        promoted_vector_t<V, S> result;
+        mixed_loop_scalar<T, promoted_vector_t<V, S>::size()>(T(s), &a[0], &result[0], [](auto x, auto y){ return sub<T, decltype(x)>(x, y); }, [](T x, T y){ return x - y; });
+        return result;
+    }
+
+    template<typename V, typename S>
+    requires (promotes_scalar<V, S>)
+    constexpr promoted_vector_t<V, S> operator*(V&& a, S const s)
+    {
+        using T = typename promoted_vector_t<V, S>::value_type;
+        promoted_vector_t<V, S> result;
+        mixed_loop_scalar<T, promoted_vector_t<V, S>::size(), has_vector_mul<T>>(T(s), &a[0], &result[0], [](auto x, auto y){ return mul<T, decltype(x)>(y, x); }, [](T x, T y){ return y * x; });
+        return result;
+    }
+
+    template<typename V, typename S>
+    requires (promotes_scalar<V, S>)
+    constexpr promoted_vector_t<V, S> operator*(S const s, V&& a)
+    {
+        using T = typename promoted_vector_t<V, S>::value_type;
+        promoted_vector_t<V, S> result;
+        mixed_loop_scalar<T, promoted_vector_t<V, S>::size(), has_vector_mul<T>>(T(s), &a[0], &result[0], [](auto x, auto y){ return mul<T, decltype(x)>(x, y); }, [](T x, T y){ return x * y; });
+        return result;
+    }
+
+    template<typename V, typename S>
+    requires (promotes_scalar<V, S>)
+    constexpr promoted_vector_t<V, S> operator/(V&& a, S const s)
+    {
+        using T = typename promoted_vector_t<V, S>::value_type;
+        promoted_vector_t<V, S> result;
+        mixed_loop_scalar<T, promoted_vector_t<V, S>::size(), has_vector_div<T>>(T(s), &a[0], &result[0], [](auto x, auto y){ return div<T, decltype(x)>(y, x); }, [](T x, T y){ return y / x; });
+        return result;
+    }
+
+    template<typename V, typename S>
+    requires (promotes_scalar<V, S>)
+    constexpr promoted_vector_t<V, S> operator/(S const s, V&& a)
+    {
+        using T = typename promoted_vector_t<V, S>::value_type;
+        promoted_vector_t<V, S> result;
+        mixed_loop_scalar<T, promoted_vector_t<V, S>::size(), has_vector_div<T>>(T(s), &a[0], &result[0], [](auto x, auto y){ return div<T, decltype(x)>(x, y); }, [](T x, T y){ return x / y; });
+        return result;
+    }
 }